@@ -31,7 +31,7 @@
 #	include <sys/time.h>
 #endif
 
-#ifdef __linux__
+#if defined(__linux__) || defined(__APPLE__)
 #	include <sys/time.h>
 #endif
 
@@ -58,6 +58,32 @@ DWORD GetTicks(void)
 #endif
 }
 
+//********************************************************************************
+ULONGLONG GetMicroTicks(void)
+//High resolution counterpart of GetTicks(), for timing short operations.
+//Only differences between two values are meaningful.
+//
+//Returns:
+//Microseconds elapsed since an arbitrary starting point.
+{
+#ifdef WIN32
+	static LARGE_INTEGER freq = {0};
+	if (!freq.QuadPart && !QueryPerformanceFrequency(&freq))
+		return (ULONGLONG)GetTickCount() * 1000;
+	LARGE_INTEGER count;
+	QueryPerformanceCounter(&count);
+	return (ULONGLONG)(count.QuadPart / freq.QuadPart) * 1000000 +
+			(ULONGLONG)(count.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart;
+#elif defined(__sgi) || defined(__APPLE__) || defined(__linux__)
+	struct timeval tv;
+	gettimeofday (&tv, NULL);
+	return (ULONGLONG)tv.tv_sec * 1000000 + tv.tv_usec;
+#else
+#	error System tick count code not provided.
+	return 0;
+#endif
+}
+
 // $Log: SysTimer.cpp,v $
 // Revision 1.3  2003/06/15 04:19:15  mrimer
 // Added linux compatibility (comitted on behalf of trick).
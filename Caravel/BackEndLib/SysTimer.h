@@ -25,7 +25,10 @@
 #ifndef SYSTIMER_H
 #define SYSTIMER_H
 
+#include "Types.h"
+
 DWORD GetTicks(void);
+ULONGLONG GetMicroTicks(void);
 
 #endif //...#infdef SYSTIMER_H
 
@@ -50,18 +50,9 @@ bool CBloodEffect::Draw(SDL_Surface* pDestSurface)
 	if (!MoveParticles())
 		return false;
 
-   if (!pDestSurface)
-      pDestSurface = GetDestSurface();
-
-   for (int nIndex=wParticleCount; nIndex--; )
-		//If particle is still active, plot to display.
-		if (parrParticles[nIndex].bActive)
-			if (parrParticles[nIndex].type)
-				g_pTheBM->BlitTileImagePart(TI_BLOOD_2, ROUND(parrParticles[nIndex].x),
-						ROUND(parrParticles[nIndex].y), 4, 4, pDestSurface);
-			else
-				g_pTheBM->BlitTileImagePart(TI_BLOOD_1, ROUND(parrParticles[nIndex].x),
-						ROUND(parrParticles[nIndex].y), 3, 3, pDestSurface);
+	static const PARTICLESPRITE sprites[2] = {
+		{TI_BLOOD_1, 3, 3}, {TI_BLOOD_2, 4, 4}};
+	DrawParticles(sprites, pDestSurface);
 
 	return true;
 }
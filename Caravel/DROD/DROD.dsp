@@ -163,6 +163,14 @@ SOURCE=.\CreditsScreen.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\DemoRender.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\DemoRender.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\DemoScreen.cpp
 # End Source File
 # Begin Source File
@@ -411,6 +419,14 @@ SOURCE=.\ParticleExplosionEffect.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\ParticleSystem.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\ParticleSystem.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\PendingPlotEffect.cpp
 # End Source File
 # Begin Source File
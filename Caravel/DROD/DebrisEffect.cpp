@@ -50,18 +50,9 @@ bool CDebrisEffect::Draw(SDL_Surface* pDestSurface)
 	if (!MoveParticles())
 		return false;
 
-   if (!pDestSurface)
-	   pDestSurface = GetDestSurface();
-
-   for (int nIndex=wParticleCount; nIndex--; )
-		//If particle is still active, plot to display.
-		if (parrParticles[nIndex].bActive)
-			if (parrParticles[nIndex].type)
-				g_pTheBM->BlitTileImagePart(TI_DEBRIS_2, ROUND(parrParticles[nIndex].x),
-						ROUND(parrParticles[nIndex].y), 4, 5, pDestSurface);
-			else
-				g_pTheBM->BlitTileImagePart(TI_DEBRIS_1, ROUND(parrParticles[nIndex].x),
-						ROUND(parrParticles[nIndex].y), 7, 8, pDestSurface);
+	static const PARTICLESPRITE sprites[2] = {
+		{TI_DEBRIS_1, 7, 8}, {TI_DEBRIS_2, 4, 5}};
+	DrawParticles(sprites, pDestSurface);
 
 	return true;
 }
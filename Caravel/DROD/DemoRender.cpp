@@ -0,0 +1,364 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is Deadly Rooms of Death.
+ *
+ * The Initial Developer of the Original Code is
+ * Caravel Software.
+ * Portions created by the Initial Developer are Copyright (C) 2005
+ * Caravel Software. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+//DemoRender.cpp
+//Implementation of headless demo rendering.
+
+#include "DemoRender.h"
+#include "DemoScreen.h"
+#include "DrodScreenManager.h"
+#include "RoomWidget.h"
+#include "../DRODLib/CurrentGame.h"
+#include <FrontEndLib/FontManager.h>
+#include <BackEndLib/Assert.h>
+#include <BackEndLib/SysTimer.h>
+
+#include <zlib.h>
+#include <stdio.h>
+#include <vector>
+using std::vector;
+
+//*****************************************************************************
+static CDemoScreen * StartDemo(
+//Loads a demo into the demo screen for playback.
+//
+//Params:
+	const DWORD dwDemoID)	//(in)	Demo to play.
+//
+//Returns:
+//The demo screen, or NULL if the demo couldn't be loaded.
+{
+	ASSERT(g_pTheSM->IsHeadless());
+
+	CDemoScreen *pDemoScreen = DYN_CAST(CDemoScreen*, CScreen*,
+			g_pTheSM->GetScreen(SCR_Demo));
+	if (!pDemoScreen || !pDemoScreen->LoadDemoGame(dwDemoID) ||
+			!pDemoScreen->BeginPlayback())
+	{
+		fprintf(stderr, "Couldn't load demo %lu.\n", (unsigned long)dwDemoID);
+		return NULL;
+	}
+	return pDemoScreen;
+}
+
+//*****************************************************************************
+static void ReadFramePixels(
+//Copies an area of a surface into packed RGB bytes, shrinking or enlarging it.
+//When shrinking, each output pixel is the average of the pixels it covers.
+//
+//Params:
+	SDL_Surface *pSurface,		//(in)	24-bit surface to read.
+	const SDL_Rect &rect,		//(in)	Area to read.
+	const UINT wDestW, const UINT wDestH,	//(in)	Size of output.
+	vector<Uint8> &RGB)			//(out)	wDestW * wDestH * 3 bytes.
+{
+	ASSERT(pSurface->format->BytesPerPixel == 3);
+	const SDL_PixelFormat *pFormat = pSurface->format;
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+	const UINT wR = pFormat->Rshift / 8, wG = pFormat->Gshift / 8,
+			wB = pFormat->Bshift / 8;
+#else
+	const UINT wR = 2 - pFormat->Rshift / 8, wG = 2 - pFormat->Gshift / 8,
+			wB = 2 - pFormat->Bshift / 8;
+#endif
+
+	RGB.resize(wDestW * wDestH * 3);
+	if (SDL_MUSTLOCK(pSurface)) SDL_LockSurface(pSurface);
+	const Uint8 *pSrc = (const Uint8 *)pSurface->pixels + rect.y * pSurface->pitch +
+			rect.x * 3;
+	Uint8 *pDest = &RGB[0];
+	for (UINT wY = 0; wY < wDestH; ++wY)
+	{
+		const UINT wY1 = wY * rect.h / wDestH;
+		UINT wY2 = (wY + 1) * rect.h / wDestH;
+		if (wY2 <= wY1) wY2 = wY1 + 1;
+		for (UINT wX = 0; wX < wDestW; ++wX)
+		{
+			const UINT wX1 = wX * rect.w / wDestW;
+			UINT wX2 = (wX + 1) * rect.w / wDestW;
+			if (wX2 <= wX1) wX2 = wX1 + 1;
+
+			DWORD dwR = 0, dwG = 0, dwB = 0;
+			for (UINT wSrcY = wY1; wSrcY < wY2; ++wSrcY)
+			{
+				const Uint8 *pPixel = pSrc + wSrcY * pSurface->pitch + wX1 * 3;
+				for (UINT wSrcX = wX1; wSrcX < wX2; ++wSrcX, pPixel += 3)
+				{
+					dwR += pPixel[wR];
+					dwG += pPixel[wG];
+					dwB += pPixel[wB];
+				}
+			}
+			const DWORD dwArea = (wX2 - wX1) * (wY2 - wY1);
+			*pDest++ = (Uint8)(dwR / dwArea);
+			*pDest++ = (Uint8)(dwG / dwArea);
+			*pDest++ = (Uint8)(dwB / dwArea);
+		}
+	}
+	if (SDL_MUSTLOCK(pSurface)) SDL_UnlockSurface(pSurface);
+}
+
+//*****************************************************************************
+static void WritePNGChunk(
+//Writes one chunk of a PNG file.
+//
+//Params:
+	FILE *pFile,				//(in)	File to write to.
+	const char *pszType,		//(in)	Four-letter chunk type.
+	const Uint8 *pData, const DWORD dwSize)	//(in)	Chunk contents.
+{
+	Uint8 header[8] = {(Uint8)(dwSize >> 24), (Uint8)(dwSize >> 16),
+			(Uint8)(dwSize >> 8), (Uint8)dwSize};
+	memcpy(header + 4, pszType, 4);
+	uLong crc = crc32(0L, Z_NULL, 0);
+	crc = crc32(crc, header + 4, 4);
+	if (dwSize) crc = crc32(crc, pData, dwSize);
+	const Uint8 footer[4] = {(Uint8)(crc >> 24), (Uint8)(crc >> 16),
+			(Uint8)(crc >> 8), (Uint8)crc};
+
+	fwrite(header, 8, 1, pFile);
+	if (dwSize) fwrite(pData, dwSize, 1, pFile);
+	fwrite(footer, 4, 1, pFile);
+}
+
+//*****************************************************************************
+static bool WritePNG(
+//Writes packed RGB bytes to a PNG file.
+//
+//Params:
+	const char *pszFilepath,	//(in)	File to create.
+	const vector<Uint8> &RGB,	//(in)	Image, wWidth * wHeight * 3 bytes.
+	const UINT wWidth, const UINT wHeight)	//(in)	Image size.
+//
+//Returns:
+//True if the file was written, false otherwise.
+{
+	//Each row is stored with a leading filter type byte (0 = none).
+	const UINT wRowSize = wWidth * 3;
+	vector<Uint8> raw((wRowSize + 1) * wHeight);
+	for (UINT wY = 0; wY < wHeight; ++wY)
+	{
+		raw[wY * (wRowSize + 1)] = 0;
+		memcpy(&raw[wY * (wRowSize + 1) + 1], &RGB[wY * wRowSize], wRowSize);
+	}
+	uLongf dwPackedSize = raw.size() + raw.size() / 100 + 64;
+	vector<Uint8> packed(dwPackedSize);
+	if (compress2(&packed[0], &dwPackedSize, &raw[0], raw.size(), Z_BEST_SPEED) != Z_OK)
+		return false;
+
+	FILE *pFile = fopen(pszFilepath, "wb");
+	if (!pFile) return false;
+
+	static const Uint8 signature[8] = {137, 'P', 'N', 'G', '\r', '\n', 26, '\n'};
+	const Uint8 ihdr[13] = {
+		(Uint8)(wWidth >> 24), (Uint8)(wWidth >> 16), (Uint8)(wWidth >> 8), (Uint8)wWidth,
+		(Uint8)(wHeight >> 24), (Uint8)(wHeight >> 16), (Uint8)(wHeight >> 8), (Uint8)wHeight,
+		8, 2, 0, 0, 0};	//8 bits per channel, RGB, no interlacing
+	fwrite(signature, 8, 1, pFile);
+	WritePNGChunk(pFile, "IHDR", ihdr, sizeof(ihdr));
+	WritePNGChunk(pFile, "IDAT", &packed[0], dwPackedSize);
+	WritePNGChunk(pFile, "IEND", NULL, 0);
+	const bool bOk = !ferror(pFile);
+	fclose(pFile);
+	return bOk;
+}
+
+//*****************************************************************************
+int ExportDemoFrames(
+//Plays a demo on a simulated clock and writes out every frame that would have
+//been shown, effects and animations included.  Frames are rendered as fast as
+//possible, not in real time.
+//
+//Params:
+	const DWORD dwDemoID,			//(in)	Demo to play.
+	const FRAMEEXPORTOPTIONS &Options)	//(in)	What to write and where.
+//
+//Returns:
+//0 if successful, 1 if the demo couldn't be played or output couldn't be written.
+{
+	ASSERT(Options.pszOutput);
+	ASSERT(Options.wFPS > 0 && Options.wScalePercent > 0);
+
+	//Effects and animations read this instead of the real clock while exporting.
+	Uint32 dwClock = SDL_GetTicks();
+	SetAnimationClock(&dwClock);
+
+	CDemoScreen *pDemoScreen = StartDemo(dwDemoID);
+	if (!pDemoScreen)
+	{
+		SetAnimationClock(NULL);
+		return 1;
+	}
+	pDemoScreen->SetReplayOptions(false);
+
+	//Turns are counted through the whole demo chain, since the game's own turn
+	//count starts over in each room of a multi-room demo.  This is the next
+	//turn to be played.
+	UINT wTurn = pDemoScreen->GetDemo()->wBeginTurnNo;
+
+	//Skip ahead to the first turn without drawing frames.
+	bool bPlaying = true;
+	while (bPlaying && wTurn < Options.wFirstTurn)
+		if ((bPlaying = pDemoScreen->PlayNextCommand()))
+			++wTurn;
+
+	SDL_Surface *pSurface = pDemoScreen->GetDestSurface();
+	SDL_Rect rect = {0, 0, pSurface->w, pSurface->h};
+	if (Options.bRoomOnly)
+		pDemoScreen->GetRoomWidget()->GetRect(rect);
+	const UINT wDestW = rect.w * Options.wScalePercent / 100 ?
+			rect.w * Options.wScalePercent / 100 : 1;
+	const UINT wDestH = rect.h * Options.wScalePercent / 100 ?
+			rect.h * Options.wScalePercent / 100 : 1;
+
+	FILE *pRawFile = NULL;
+	if (Options.bRaw && !(pRawFile = fopen(Options.pszOutput, "wb")))
+	{
+		fprintf(stderr, "Couldn't create %s.\n", Options.pszOutput);
+		SetAnimationClock(NULL);
+		return 1;
+	}
+
+	const Uint32 dwFrameTime = 1000 / Options.wFPS;
+	Uint32 dwNextCommandTime = dwClock + pDemoScreen->GetCommandDelay();
+	vector<Uint8> RGB;
+	char szFilepath[1024];
+	DWORD dwFrameNo = 0L, dwFramesWritten = 0L;
+	bool bOk = true;
+	const ULONGLONG qwStart = GetMicroTicks();
+	while (bPlaying && bOk)
+	{
+		//Play each command once its recorded delay has passed.  The frames
+		//after the last turn run until the next command would have played.
+		while (dwClock >= dwNextCommandTime)
+		{
+			if (wTurn > Options.wLastTurn || !pDemoScreen->PlayNextCommand())
+			{
+				bPlaying = false;
+				break;
+			}
+			++wTurn;
+			dwNextCommandTime = dwClock + pDemoScreen->GetCommandDelay();
+		}
+		if (!bPlaying) break;
+
+		pDemoScreen->AnimateFrame();
+		if (dwFrameNo++ % (Options.wFrameSkip + 1) == 0)
+		{
+			ReadFramePixels(pSurface, rect, wDestW, wDestH, RGB);
+			if (pRawFile)
+				bOk = fwrite(&RGB[0], RGB.size(), 1, pRawFile) == 1;
+			else
+			{
+				sprintf(szFilepath, "%.1000s/frame%05lu.png", Options.pszOutput,
+						(unsigned long)dwFramesWritten);
+				bOk = WritePNG(szFilepath, RGB, wDestW, wDestH);
+			}
+			if (bOk) ++dwFramesWritten;
+			else fprintf(stderr, "Couldn't write frame %lu.\n",
+					(unsigned long)dwFramesWritten);
+		}
+		dwClock += dwFrameTime;
+	}
+	const ULONGLONG qwElapsed = GetMicroTicks() - qwStart;
+
+	if (pRawFile) fclose(pRawFile);
+	SetAnimationClock(NULL);
+
+	printf("Demo %lu: wrote %lu frames (%ux%u%s) in %.2f s (%.1f frames/sec)\n",
+			(unsigned long)dwDemoID, (unsigned long)dwFramesWritten, wDestW, wDestH,
+			Options.bRaw ? " rgb24" : "", qwElapsed / 1000000.0,
+			qwElapsed ? dwFramesWritten * 1000000.0 / qwElapsed : 0.0);
+	return bOk ? 0 : 1;
+}
+
+//*****************************************************************************
+static void PrintPhaseTime(
+//Prints one line of benchmark results.
+//
+//Params:
+	const char *pszPhase,		//(in)	Name of phase.
+	const ULONGLONG qwMicroSecs,	//(in)	Total time spent in it.
+	const DWORD dwCount)			//(in)	Number of times it ran.
+{
+	printf("  %-12s %10.1f ms %10.1f us each\n", pszPhase, qwMicroSecs / 1000.0,
+			dwCount ? (double)qwMicroSecs / dwCount : 0.0);
+}
+
+//*****************************************************************************
+int RunRenderBenchmark(
+//Plays a demo as fast as possible and reports the frame rate and where the
+//rendering time went.  After each turn the screen's animated widgets are
+//painted the given number of times, standing in for the frames shown
+//between turns during normal playback.
+//
+//Params:
+	const DWORD dwDemoID,			//(in)	Demo to play.
+	const UINT wFramesPerTurn)		//(in)	Frames to animate after each turn.
+//
+//Returns:
+//0 if successful, 1 if the demo couldn't be played.
+{
+	CDemoScreen *pDemoScreen = StartDemo(dwDemoID);
+	if (!pDemoScreen) return 1;
+
+	ROOMPAINTTIMES paintTimes;
+	ULONGLONG qwTextTime = 0, qwTurnTime = 0;
+	DWORD dwTurns = 0L, dwFrames = 0L;
+	CRoomWidget *pRoomWidget = pDemoScreen->GetRoomWidget();
+	pRoomWidget->SetPaintTimes(&paintTimes);
+	g_pTheFM->SetRenderTime(&qwTextTime);
+
+	const ULONGLONG qwStart = GetMicroTicks();
+	while (true)
+	{
+		//Game logic for the turn, along with the repaints it causes.
+		const ULONGLONG qwTurnStart = GetMicroTicks();
+		if (!pDemoScreen->PlayNextCommand()) break;
+		qwTurnTime += GetMicroTicks() - qwTurnStart;
+		++dwTurns;
+
+		for (UINT wFrame = 0; wFrame < wFramesPerTurn; ++wFrame)
+		{
+			pDemoScreen->AnimateFrame();
+			++dwFrames;
+		}
+	}
+	const ULONGLONG qwElapsed = GetMicroTicks() - qwStart;
+
+	pRoomWidget->SetPaintTimes(NULL);
+	g_pTheFM->SetRenderTime(NULL);
+
+	printf("Demo %lu: %lu turns, %lu frames, %lu room paints in %.2f s (%.1f frames/sec)\n",
+			(unsigned long)dwDemoID, (unsigned long)dwTurns, (unsigned long)dwFrames,
+			(unsigned long)paintTimes.dwPaints, qwElapsed / 1000000.0,
+			qwElapsed ? dwFrames * 1000000.0 / qwElapsed : 0.0);
+	PrintPhaseTime("tile repaint", paintTimes.qwTiles, paintTimes.dwPaints);
+	PrintPhaseTime("monsters", paintTimes.qwMonsters, paintTimes.dwPaints);
+	PrintPhaseTime("effects", paintTimes.qwEffects, paintTimes.dwPaints);
+	PrintPhaseTime("room widgets", paintTimes.qwChildren, paintTimes.dwPaints);
+	PrintPhaseTime("text", qwTextTime, dwFrames);
+	PrintPhaseTime("turns", qwTurnTime, dwTurns);
+	return 0;
+}
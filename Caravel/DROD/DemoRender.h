@@ -0,0 +1,58 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is Deadly Rooms of Death.
+ *
+ * The Initial Developer of the Original Code is
+ * Caravel Software.
+ * Portions created by the Initial Developer are Copyright (C) 2005
+ * Caravel Software. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+//DemoRender.h
+//Declarations for rendering demos without a display.
+//
+//These run a demo through CDemoScreen while the screen manager is headless,
+//so that nothing waits on the clock or the user.  Results go to stdout, or
+//to image files when exporting frames.
+
+#ifndef DEMORENDER_H
+#define DEMORENDER_H
+
+#include <BackEndLib/Types.h>
+
+//How ExportDemoFrames() writes its output.
+struct FRAMEEXPORTOPTIONS
+{
+	FRAMEEXPORTOPTIONS()
+		: pszOutput(NULL), bRaw(false), wFPS(30), wFrameSkip(0), wScalePercent(100)
+		, bRoomOnly(false), wFirstTurn(0), wLastTurn((UINT)-1)
+	{ }
+
+	const char *pszOutput;	//Directory for PNG files, or file for raw output.
+	bool	bRaw;				//Write one stream of 24-bit RGB frames instead of PNGs.
+	UINT	wFPS;				//Frames per second of demo time.
+	UINT	wFrameSkip;			//Frames to skip after each one written.
+	UINT	wScalePercent;		//Output size, relative to the rendered frame.
+	bool	bRoomOnly;			//Crop frames to the room widget.
+	UINT	wFirstTurn, wLastTurn;	//Turns to export, inclusive.  Counted through
+									//every room of a multi-room demo.
+};
+
+int		ExportDemoFrames(const DWORD dwDemoID, const FRAMEEXPORTOPTIONS &Options);
+int		RunRenderBenchmark(const DWORD dwDemoID, const UINT wFramesPerTurn);
+
+#endif //...#ifndef DEMORENDER_H
@@ -75,6 +75,51 @@ bool CDemoScreen::LoadDemoGame(
 	return true;
 }
 
+//*****************************************************************************
+bool CDemoScreen::BeginPlayback()
+//Prepares a loaded demo to be played with PlayNextCommand(), without
+//activating the screen, and paints the first frame.
+//
+//Returns:
+//True if successful, false if not.
+{
+	if (!SetForActivate()) return false;
+	Paint();
+	return true;
+}
+
+//*****************************************************************************
+bool CDemoScreen::PlayNextCommand()
+//Processes the demo's next command, loading the next demo in a multi-room
+//demo as needed.
+//
+//Returns:
+//True if a command was processed, false if the demo has ended.
+{
+	if (!this->pCurrentCommand)  //End of demo.
+		return false;
+	ProcessCommand(this->pCurrentCommand->bytCommand);
+
+	//Check for last turn in demo.
+	if (CGameScreen::pCurrentGame->wTurnNo - 1 == this->pDemo->wEndTurnNo)
+	{
+		this->pCurrentCommand = NULL;
+	}
+	else	//Get next turn.
+	{
+		this->pCurrentCommand = CGameScreen::pCurrentGame->Commands.GetNext();			
+		if (!this->pCurrentCommand && this->pDemo->dwNextDemoID) //Multi-room demo.
+		{
+			//Load next demo and get first command.
+			if (!LoadDemoGame(this->pDemo->dwNextDemoID)) //Load failed.
+				return false;
+			this->pCurrentCommand = CGameScreen::pCurrentGame->Commands.GetFirst();
+		}
+	}
+
+	return true;
+}
+
 //
 //CDemoScreen protected methods.
 //
@@ -186,40 +231,26 @@ void CDemoScreen::OnBetweenEvents()
 	Uint32 dwNow = SDL_GetTicks();
 	if (dwNow >= this->dwNextCommandTime)
 	{
-		if (!this->pCurrentCommand)  //End of demo.
+		if (!PlayNextCommand())
 		{
 			Deactivate();
 			return;
 		}
-		ProcessCommand(this->pCurrentCommand->bytCommand);
-		
-		//Check for last turn in demo.
-		if (CGameScreen::pCurrentGame->wTurnNo - 1 == this->pDemo->wEndTurnNo)
-		{
-			this->pCurrentCommand = NULL;
-		}
-		else	//Get next turn.
-		{
-			this->pCurrentCommand = CGameScreen::pCurrentGame->Commands.GetNext();			
-			if (!this->pCurrentCommand && this->pDemo->dwNextDemoID) //Multi-room demo.
-			{
-				//Load next demo and get first command.
-				if (!LoadDemoGame(this->pDemo->dwNextDemoID)) //Load failed.
-				{
-					Deactivate();
-					return;
-				}
-				this->pCurrentCommand = CGameScreen::pCurrentGame->Commands.GetFirst();
-			}
-		}
 
-		this->dwNextCommandTime = dwNow + ((this->pCurrentCommand == NULL) ?
-				LAST_COMMAND_DELAY :
-      static_cast<DWORD>(this->pCurrentCommand->byt10msElapsedSinceLast * 10 *
-            (this->bCanChangeSpeed ? this->fScrollRateMultiplier : 1.0f)));
+		this->dwNextCommandTime = dwNow + GetCommandDelay();
 	}
 }
 
+//*****************************************************************************
+DWORD CDemoScreen::GetCommandDelay() const
+//Returns: msecs to wait before playing the next command, as it was recorded.
+{
+	if (this->pCurrentCommand == NULL)
+		return LAST_COMMAND_DELAY;
+	return static_cast<DWORD>(this->pCurrentCommand->byt10msElapsedSinceLast * 10 *
+			(this->bCanChangeSpeed ? this->fScrollRateMultiplier : 1.0f));
+}
+
 void  CDemoScreen::SetReplayOptions(bool bChangeSpeed)
 {
    this->bCanChangeSpeed = bChangeSpeed;
@@ -37,6 +37,15 @@ public:
 	bool		LoadDemoGame(const DWORD dwDemoID);
    void     SetReplayOptions(bool bChangeSpeed);
 
+	//Playback driven by the caller instead of the event loop, i.e. when the
+	//screen manager is headless.
+	void		AnimateFrame() {AnimateWidgets();}
+	bool		BeginPlayback();
+	DWORD		GetCommandDelay() const;
+	const CDbDemo *	GetDemo() const {return this->pDemo;}
+	CRoomWidget *	GetRoomWidget() const {return this->pRoomWidget;}
+	bool		PlayNextCommand();
+
 protected:
 	friend class CDrodScreenManager;
 
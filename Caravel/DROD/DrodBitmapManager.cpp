@@ -30,6 +30,7 @@
 #include "TileImageConstants.h"
 #include "../Texts/MIDs.h"
 #include <BackEndLib/Assert.h>
+#include <BackEndLib/Files.h>
 
 //Holds the only instance of CDrodBitmapManager for the app.
 CDrodBitmapManager *g_pTheDBM = NULL;
@@ -54,10 +55,6 @@ CDrodBitmapManager::CDrodBitmapManager()
 	CDrodBitmapManager::CY_ROOM = CBitmapManager::CY_TILE * CDrodBitmapManager::DISPLAY_ROWS;
 
 	this->wTileCount = TI_COUNT;
-	this->TileImageTypes = new TILEIMAGETYPE[TI_COUNT];
-
-	for (UINT wI = TI_COUNT; wI--; )
-		this->TileImageTypes[wI] = TIT_Unspecified;
 }
 
 //**********************************************************************************
@@ -67,13 +64,19 @@ UINT CDrodBitmapManager::Init(void)
 //Returns:
 //MID_Success of a message ID describing failure.
 {
-	//Create the tiles surface.  It will be large enough to hold TI_COUNT tiles.
-	this->pTileImagesSurface = SDL_CreateRGBSurface(SDL_SWSURFACE, 
-			CX_TILE * TI_COUNT, CY_TILE, 24, 0, 0, 0, 0);
-	if (!this->pTileImagesSurface) return MID_OutOfMemory;
+	//Create a tiles surface for use until a style is loaded.  It will be large
+	//enough to hold TI_COUNT tiles.  Each style gets its own.
+	if (!AddTileSet(0)) return MID_OutOfMemory;
 
 	this->TransparentColor = GetSurfaceColor(this->pTileImagesSurface, 192, 192, 192);
 
+	//Optional cap on memory for resident style tile sets and their decoded
+	//source bitmaps.
+	CFiles Files;
+	string strCapKB;
+	if (Files.GetGameProfileString("Graphics", "TileSetMemoryKB", strCapKB))
+		SetTileSetMemoryCap(atol(strCapKB.c_str()) * 1024);
+
 	//Success.
 	return MID_Success;
 }
@@ -81,7 +84,8 @@ UINT CDrodBitmapManager::Init(void)
 //**********************************************************************************
 bool CDrodBitmapManager::LoadTileImagesForStyle(
 //Loads tile images corresponding to a style.  Tile images will become available in
-//future calls to GetTileImage().
+//future calls to GetTileImage().  Styles loaded before are kept resident, within
+//the tile set memory cap, and switching back to one of them is immediate.
 //
 //Params:
 	const UINT wStyleNo)	//(in)	Style to load.
@@ -91,19 +95,46 @@ bool CDrodBitmapManager::LoadTileImagesForStyle(
 {	
 	ASSERT(wStyleNo > 0 && wStyleNo < 99);
 
+	if (SelectTileSet(wStyleNo)) return true;
+	if (!AddTileSet(wStyleNo)) return false;
+
 	//Load tiles specific to style.
 	WSTRING wstrFilename;
-	AsciiToUnicode("Style", wstrFilename);
-	WCHAR szNum[3];
-	wstrFilename += _itoW(wStyleNo, szNum, 10);
-	WSTRING wstr;
-	AsciiToUnicode("Tiles", wstr);
-	wstrFilename += wstr;
-	if (!LoadTileImages(wstrFilename.c_str(), false)) return false;
+	GetStyleTilesName(wStyleNo, wstrFilename);
+	if (!LoadTileImages(wstrFilename.c_str(), false))
+	{
+		DiscardTileSet();
+		return false;
+	}
 
 	//Load general tiles that apply to every style.
+	WSTRING wstr;
 	AsciiToUnicode("GeneralTiles", wstr);
-	return LoadTileImages(wstr.c_str(), true);
+	if (!LoadTileImages(wstr.c_str(), true))
+	{
+		DiscardTileSet();
+		return false;
+	}
+	return true;
+}
+
+//**********************************************************************************
+void CDrodBitmapManager::PrefetchTileImagesForStyle(
+//Starts decoding the tile images of a style in the background, so that a later
+//LoadTileImagesForStyle() call for it doesn't wait on the disk.
+//
+//Params:
+	const UINT wStyleNo)	//(in)	Style likely to be loaded soon.
+{
+	ASSERT(wStyleNo > 0 && wStyleNo < 99);
+
+	WSTRING wstrFilename;
+	GetStyleTilesName(wStyleNo, wstrFilename);
+	PrefetchBitmap(wstrFilename.c_str(), true);
+
+	WSTRING wstr;
+	AsciiToUnicode("GeneralTiles", wstr);
+	PrefetchBitmap(wstr.c_str(), true);
 }
 
 //**********************************************************************************
@@ -121,6 +152,20 @@ bool CDrodBitmapManager::LoadTileImages(
 //Returns:
 //True if successful, false if not.
 {
+	//Get the source bitmap containing tile images, along with the mapping index
+	//from its tile image map file.  Each indice specifies which TI_* constant
+	//corresponds to the tile image within the source bitmap.  Both stay
+	//decoded while they fit under the memory cap, so loading this bitmap
+	//again soon won't touch the disk.
+	const DECODEDBITMAP *pDecoded = GetDecodedBitmap(wszName, true);
+	if (!pDecoded) return false;
+	SDL_Surface *pSrcSurface = pDecoded->pSurface;
+	const vector<UINT> &MappingIndex = pDecoded->MappingIndex;
+	ASSERT(pSrcSurface->w % CX_TILE == 0);
+	ASSERT(pSrcSurface->h % CY_TILE == 0);
+	const UINT wCols = (pSrcSurface->w / CX_TILE);
+	const UINT wRows = (pSrcSurface->h / CY_TILE);
+
 	//Lock now to speed up lock/unlock pairs in called routines.
 	LockTileImagesSurface();
 
@@ -129,69 +174,59 @@ bool CDrodBitmapManager::LoadTileImages(
 	if (bReplaceAntiAliasColors)
 		GetAntiAliasReplacementColors(Replace75, Replace50);
 
-	//Load the source bitmap containing tile images.
-	UINT wCols, wRows;
-	SDL_Surface *pSrcSurface = LoadBitmapSurface(wszName);
-	if (!pSrcSurface) return false;
-	ASSERT(pSrcSurface->w % CX_TILE == 0);
-	ASSERT(pSrcSurface->h % CY_TILE == 0);
-	wCols = (pSrcSurface->w / CX_TILE);
-	wRows = (pSrcSurface->h / CY_TILE);
-	
-	//Get mapping index from the tile image map file.  Each indice specifies
-	//which TI_* constant corresponds to the tile image within the source bitmap.
-	list<UINT> MappingIndex;
+	//Copy source tile images into the manager's tile image surface.  Their
+	//position is determined from the mapping index, which lists the tile
+	//images by column and row.
 	SDL_Rect src = {0, 0, CX_TILE, CY_TILE};
 	SDL_Rect dest = {0, 0, CX_TILE, CY_TILE};
-	if (GetMappingIndexFromTileImageMap(wszName, MappingIndex))
+	UINT wTileImageNo;
+	const UINT wIndexCount = MappingIndex.size() < wCols * wRows ?
+			MappingIndex.size() : wCols * wRows;
+	for (UINT wIndexI = 0; wIndexI < wIndexCount; ++wIndexI)
 	{
-		list<UINT>::const_iterator iIndex = MappingIndex.begin();
-
-		//Copy source tile images into the manager's tile image surface.  Their
-		//position is determined from the mapping index.
-		UINT wTileImageNo;
-		for (UINT wY = 0; wY < wRows; ++wY)
-		{
-			for (UINT wX = 0; wX < wCols; ++wX)
-			{
-				wTileImageNo = *iIndex;
-				if (wTileImageNo != (UINT)(TI_UNSPECIFIED))
-				{
-					//Blit tile image to manger's tile image surface.
-					ASSERT(wTileImageNo <= TI_COUNT);
-					dest.x = wTileImageNo * CX_TILE;
-					SDL_BlitSurface(pSrcSurface, &src, this->pTileImagesSurface, &dest);
-
-					//Set type of tile image.
-					if (DoesTileImageContainTransparentPixels(wTileImageNo))
-						this->TileImageTypes[wTileImageNo] = TIT_Transparent;
-					else
-						this->TileImageTypes[wTileImageNo] = TIT_Opaque;
-
-					//Replace anti-aliasing colors for transparent tile images.
-					if (bReplaceAntiAliasColors &&
-							TileImageTypes[wTileImageNo] == TIT_Transparent)
-						ReplaceAntiAliasingColors(wTileImageNo, Replace75, Replace50);
-				}
-				++iIndex;
-				if (iIndex == MappingIndex.end()) break;
-
-				src.x += CX_TILE;
-			}
-			if (iIndex == MappingIndex.end()) break;
-
-			src.x = 0;
-			src.y += CY_TILE;
-		}		
+		wTileImageNo = MappingIndex[wIndexI];
+		if (wTileImageNo == (UINT)(TI_UNSPECIFIED)) continue;
+
+		//Blit tile image to manger's tile image surface.
+		ASSERT(wTileImageNo <= TI_COUNT);
+		src.x = (wIndexI % wCols) * CX_TILE;
+		src.y = (wIndexI / wCols) * CY_TILE;
+		dest.x = wTileImageNo * CX_TILE;
+		SDL_BlitSurface(pSrcSurface, &src, this->pTileImagesSurface, &dest);
+
+		//Set type of tile image.
+		if (DoesTileImageContainTransparentPixels(wTileImageNo))
+			this->TileImageTypes[wTileImageNo] = TIT_Transparent;
+		else
+			this->TileImageTypes[wTileImageNo] = TIT_Opaque;
+
+		//Replace anti-aliasing colors for transparent tile images.
+		if (bReplaceAntiAliasColors &&
+				TileImageTypes[wTileImageNo] == TIT_Transparent)
+			ReplaceAntiAliasingColors(wTileImageNo, Replace75, Replace50);
 	}
 
 	UnlockTileImagesSurface();
 
-	SDL_FreeSurface(pSrcSurface);
-
 	return true;
 }
 
+//**********************************************************************************
+void CDrodBitmapManager::GetStyleTilesName(
+//Gets the name of the bitmap holding a style's tile images.
+//
+//Params:
+	const UINT wStyleNo,	//(in)	Style.
+	WSTRING &wstrName)	//(out)	Bitmap name without extension.
+{
+	AsciiToUnicode("Style", wstrName);
+	WCHAR szNum[3];
+	wstrName += _itoW(wStyleNo, szNum, 10);
+	WSTRING wstr;
+	AsciiToUnicode("Tiles", wstr);
+	wstrName += wstr;
+}
+
 //**********************************************************************************
 void CDrodBitmapManager::GetAntiAliasReplacementColors(
 //Gets the best anti-aliasing colors for transparent blits on currently loaded
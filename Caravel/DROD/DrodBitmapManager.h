@@ -39,12 +39,14 @@ public:
 	
 	virtual UINT	Init();
 	bool			LoadTileImagesForStyle(const UINT wStyleNo);
+	void			PrefetchTileImagesForStyle(const UINT wStyleNo);
 
 	static UINT DISPLAY_COLS, DISPLAY_ROWS, CX_ROOM, CY_ROOM;
 
 private:
 	void			GetAntiAliasReplacementColors(SURFACECOLOR &Replace75, 
 			SURFACECOLOR &Replace50);
+	static void	GetStyleTilesName(const UINT wStyleNo, WSTRING &wstrName);
 	virtual bool			LoadTileImages(const WCHAR *pszName, bool bReplaceAntiAliasColors);
 };
 
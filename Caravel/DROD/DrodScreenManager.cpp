@@ -81,8 +81,9 @@ CDrodScreenManager::CDrodScreenManager(
 //Constructor.
 //
 //Params:
-	SDL_Surface *pSetScreenSurface) //(in)	The screen surface.
-	: CScreenManager(pSetScreenSurface)
+	SDL_Surface *pSetScreenSurface, //(in)	The screen surface.
+	const bool bSetHeadless)			//(in)	Whether nothing is displayed.  Default false.
+	: CScreenManager(pSetScreenSurface, bSetHeadless)
 {
 }
 
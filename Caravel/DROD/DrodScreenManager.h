@@ -68,7 +68,7 @@ class CScreen;
 class CDrodScreenManager : public CScreenManager
 {
 public:
-	CDrodScreenManager(SDL_Surface *pSetScreenSurface);
+	CDrodScreenManager(SDL_Surface *pSetScreenSurface, const bool bSetHeadless=false);
 
 	virtual UINT		Init();
     virtual void        GetScreenName(const UINT eScreen, string &strName) const;
@@ -30,10 +30,18 @@
 #include <BackEndLib/Files.h>
 
 //*****************************************************************************
-CDrodSound::CDrodSound(const bool bNoSound)
-: CSound(bNoSound, SEID_COUNT, ::SAMPLE_CHANNEL_COUNT, ::MODULE_CHANNEL_COUNT)
+CDrodSound::CDrodSound(
+//Constructor.
+//
+//Params:
+	const bool bNoSound,					//(in)	If true, all sound is disabled.
+	const AUDIOBACKENDTYPE eBackend,		//(in)	Sound library to use.
+	const char *pszAudioLogFilepath)		//(in)	Where ABT_Recording writes its log.
+: CSound(bNoSound, SEID_COUNT, ::SAMPLE_CHANNEL_COUNT, ::MODULE_CHANNEL_COUNT,
+		eBackend, pszAudioLogFilepath)
 {	
 	//Load sound effects ahead of time so that playing a sample takes less time.
+	//They load on the audio thread, so this doesn't hold up startup.
 	if (this->bSoundEffectsAvailable)
 		this->bSoundEffectsAvailable = LoadSoundEffects();
 }
@@ -186,15 +194,20 @@ bool CDrodSound::GetSongFilepath(
 
 //**********************************************************************************
 bool CDrodSound::LoadSoundEffects(void)
-//Load sound effects into an array.
+//Queue sound effects to be loaded into an array by the audio thread.
 //
 //Returns:
-//True if at least one sound effect loaded, false if not.
+//True if sound effects were queued, false if not.
 {
-#ifdef __sgi
-	return false;
-#else
-	bool bOneSoundEffectLoaded = false;
+	//Reserve the sample channels so that the backend doesn't use them for
+	//playing songs.  This is done before any samples are queued for the
+	//audio thread.
+	for (UINT nReserveChannel = MODULE_CHANNEL_COUNT;
+			nReserveChannel < CHANNEL_COUNT;	++nReserveChannel)
+	{
+		if (!this->pBackend->ReserveChannel(nReserveChannel))
+			ASSERTP(false, "Failed to reserve sample channel.");
+	}
 
 	//Sound effect channels come after module channels.
 	int nSoundEffectChannel = MODULE_CHANNEL_COUNT;
@@ -203,7 +216,7 @@ bool CDrodSound::LoadSoundEffects(void)
 	//For readability--macro that loads one sound effect.
 #	define SHARED_CHANNEL_SOUNDEFFECT(s) \
 	GetWaveFilepaths((s), FilepathArray); \
-	this->SoundEffectArray[(s)].Load(FilepathArray, nSoundEffectChannel, true)
+	QueueSoundEffect((s), FilepathArray, nSoundEffectChannel, true)
 
 	//Channel n+1--Beethro's voice.	
 	SHARED_CHANNEL_SOUNDEFFECT( SEID_OOF );
@@ -234,7 +247,7 @@ bool CDrodSound::LoadSoundEffects(void)
 	++nSoundEffectChannel;
 	SHARED_CHANNEL_SOUNDEFFECT( SEID_MIMIC );
 	GetWaveFilepaths(SEID_WALK, FilepathArray);
-	this->SoundEffectArray[SEID_WALK].Load(FilepathArray, nSoundEffectChannel, false);
+	QueueSoundEffect(SEID_WALK, FilepathArray, nSoundEffectChannel, false);
 
 	//Channel n+6--Won't play at the same time.
 	++nSoundEffectChannel;
@@ -246,7 +259,7 @@ bool CDrodSound::LoadSoundEffects(void)
 //Macro for readability.
 #	define PRIVATE_CHANNEL_SOUNDEFFECT(s) \
 	GetWaveFilepaths((s), FilepathArray); \
-	this->SoundEffectArray[(s)].Load(FilepathArray, ++nSoundEffectChannel)
+	QueueSoundEffect((s), FilepathArray, ++nSoundEffectChannel)
 
 	//Each sound effect below gets a separate channel.
 	PRIVATE_CHANNEL_SOUNDEFFECT( SEID_READ );
@@ -265,31 +278,8 @@ bool CDrodSound::LoadSoundEffects(void)
 	//samples.
    ASSERT(static_cast<UINT>(nSoundEffectChannel + 1) == CHANNEL_COUNT);
 
-	//Reserve the sample channels so that FMOD doesn't use them for playing
-	//songs.
-	for (UINT nReserveChannel = MODULE_CHANNEL_COUNT;
-			nReserveChannel < CHANNEL_COUNT;	++nReserveChannel)
-	{
-		if (!FSOUND_SetReserved(nReserveChannel, true)) ASSERTP(false, "FSOUND_SetReserved() failed.");
-	}
-
-	//Check sound effects to see what got loaded.
-	for (int nSEI = 0; nSEI < SEID_COUNT; ++nSEI)
-	{
-		if (this->SoundEffectArray[nSEI].IsLoaded())
-			bOneSoundEffectLoaded = true;
-		else
-      {
-			//If this fires, check 1. a load macro is present for each
-			//SEID_* value. 2. filenames specified in DROD.INI are correct.
-         CFiles f;
-         f.AppendErrorLog("A sound effect failed to load.  Check whether "
-            "the filenames specified in DROD.INI are correct.\r\n");
-			ASSERTP(false, "Sound effect failed to load.");
-      }
-	}
-	return bOneSoundEffectLoaded;
-#endif
+	//Whether they loaded is checked once the audio thread is done with them.
+	return true;
 }
 
 // $Log: DrodSound.cpp,v $
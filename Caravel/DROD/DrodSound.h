@@ -125,7 +125,8 @@ const UINT MODULE_CHANNEL_COUNT = 16;
 class CDrodSound : public CSound
 {
 public:
-	CDrodSound(const bool bNoSound);
+	CDrodSound(const bool bNoSound, const AUDIOBACKENDTYPE eBackend=ABT_Default,
+			const char *pszAudioLogFilepath=NULL);
 	virtual ~CDrodSound() {}
 
 protected:
@@ -154,7 +154,7 @@ void CFaceWidget::SetMoodDelay(
   Uint32 lDelay)          //(in) Amount of time in msecs to pass before mood reverts to previous.
 {
   lDelayMood=lDelay;
-  lStartDelayMood=SDL_GetTicks();
+  lStartDelayMood=GetAnimationTicks();
 }
 
 //****************************************************************************
@@ -505,7 +505,7 @@ void CFaceWidget::Paint(
 void CFaceWidget::HandleAnimate(void)
 //Handle animation of the widget.
 {
-	Uint32 dwNow = SDL_GetTicks();
+	Uint32 dwNow = GetAnimationTicks();
 
 	//After timing of a temporary face is done (i.e., happy for a moment after 
 	//a monster kill) go back to previous mood
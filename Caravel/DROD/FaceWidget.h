@@ -92,7 +92,7 @@ class CFaceWidget : public CWidget
 		inline void			DrawPupils_DrawOnePupil(
 				SDL_Surface *pDestSurface, const int nDestX, const int nDestY, 
 				const int nMaskX, const int nMaskY) const;
-		bool				bHasMoodDelayPassed() {return SDL_GetTicks()-lStartDelayMood>lDelayMood;}
+		bool				bHasMoodDelayPassed() {return GetAnimationTicks()-lStartDelayMood>lDelayMood;}
 		void				SetMoodDelay(Uint32 lDelay);
 
 		SDL_Surface *		pFacesSurface;
@@ -189,6 +189,9 @@ void CGameScreen::SetMusicStyle(
 	}
 
 	CRoomScreen::SetMusicStyle(wStyle);
+
+	//Have the level complete song ready for when the level gets cleared.
+	g_pTheSound->PrefetchSong(SONGID_LEVELCOMPLETE);
 }
 
 //*****************************************************************************
@@ -823,6 +826,14 @@ SCREENTYPE CGameScreen::HandleEventsForLevelExit()
 
 	//Show the screen after first arriving here.
 	Paint();
+
+	//Nobody is watching a headless display, so continue right away.
+	if (g_pTheSM->IsHeadless())
+	{
+		g_pTheSound->StopSong();
+		this->pRoomWidget->ShowSwordsman();
+		return SCR_LevelStart;
+	}
 	DWORD dwLastStep = SDL_GetTicks(), dwLastAnimate = dwLastStep, dwStarted = dwLastStep;
 
 	//Process events.
@@ -885,6 +896,7 @@ SCREENTYPE CGameScreen::HandleEventsForLevelExit()
 		{
 			this->pRoomWidget->Paint();
 			this->pFaceWidget->Paint();
+			FlushUpdateRects();
 			dwLastAnimate = dwNow;
 		}
 
@@ -930,6 +942,8 @@ void CGameScreen::HandleEventsForPlayerDeath()
 	//Show the screen after first arriving here.
 	this->pRoomWidget->Repaint();
 	this->pRoomWidget->Paint();
+	if (g_pTheSM->IsHeadless())
+		return;	//no one to watch the death animation
    {
    CFade fade(this->pRoomWidget->pRoomSnapshotSurface,NULL);
 
@@ -996,6 +1010,7 @@ void CGameScreen::HandleEventsForPlayerDeath()
 
 		this->pFaceWidget->Paint();
 		this->pRoomWidget->Paint();
+		FlushUpdateRects();
 
 		//Scream has finished.  Return from animation.
 		if (dwNow - dwStart > dwDeathDuration)
@@ -34,6 +34,7 @@
 #	include <errno.h>
 #endif
 
+#include "DemoRender.h"
 #include "DrodFontManager.h"
 #include "DrodBitmapManager.h"
 #include "DrodScreenManager.h"
@@ -68,6 +69,9 @@ static char *lockfile = NULL;
 
 CFiles *	m_pFiles = NULL;
 
+//Offscreen surface standing in for the window when running headless.
+static SDL_Surface *m_pHeadlessSurface = NULL;
+
 #ifdef BETA
 char windowTitle[] = "DROD BETA BUILD 40 - DO NOT DISTRIBUTE (buggy releases make us look bad)";
 #else
@@ -86,12 +90,18 @@ static void         DeinitSound();
 static void         DisplayInitErrorMessage(MESSAGE_ID dwMessageID);
 static int          FindArg(int argc, char *argv[], const char *pszArgName);
 static void         GetAppPath(const char *pszArg0, WSTRING &wstrAppPath);
+static bool         GetExportArgs(int argc, char *argv[], const int nExportArg,
+		DWORD &dwDemoID, FRAMEEXPORTOPTIONS &Options);
 static bool         ShouldUpgradeData();
-static MESSAGE_ID   Init(const bool bNoFullscreen, const bool bNoSound);
+static void         PrintFrameStats();
+static MESSAGE_ID   Init(const bool bNoFullscreen, const bool bNoSound,
+		const bool bHeadless, const AUDIOBACKENDTYPE eAudioBackend,
+		const char *pszAudioLogFilepath);
 static void         InitCDate(void);
 static MESSAGE_ID   InitDB();
-static MESSAGE_ID   InitGraphics(const bool bNoFullscreen);
-static MESSAGE_ID   InitSound(const bool bNoSound);
+static MESSAGE_ID   InitGraphics(const bool bNoFullscreen, const bool bHeadless);
+static MESSAGE_ID   InitSound(const bool bNoSound,
+		const AUDIOBACKENDTYPE eAudioBackend, const char *pszAudioLogFilepath);
 static bool         IsAppAlreadyRunning();
 
 //*****************************************************************************
@@ -102,6 +112,78 @@ int main(int argc, char *argv[])
     bool bNoFullscreen = FindArg(argc, argv, "nofullscreen") != -1;
     bool bNoSound = FindArg(argc, argv, "nosound") != -1;
 
+    //Render benchmark: "--bench-render <demoID> [frames per turn]".
+    //Runs without a display or sound and exits when the demo is done.
+    DWORD dwBenchDemoID = 0L;
+    UINT wBenchFramesPerTurn = 10;
+    const int nBenchArg = FindArg(argc, argv, "--bench-render");
+    if (nBenchArg != -1)
+    {
+        if (nBenchArg + 1 < argc)
+            dwBenchDemoID = strtoul(argv[nBenchArg + 1], NULL, 10);
+        if (!dwBenchDemoID)
+        {
+            fprintf(stderr, "Usage: %s --bench-render <demoID> [frames per turn]\n", argv[0]);
+            return 1;
+        }
+        if (nBenchArg + 2 < argc)
+            wBenchFramesPerTurn = strtoul(argv[nBenchArg + 2], NULL, 10);
+        bNoFullscreen = true;
+    }
+
+    //Frame export: "--export-frames <demoID> <output> [options]".
+    DWORD dwExportDemoID = 0L;
+    FRAMEEXPORTOPTIONS ExportOptions;
+    const int nExportArg = FindArg(argc, argv, "--export-frames");
+    if (nExportArg != -1)
+    {
+        if (!GetExportArgs(argc, argv, nExportArg, dwExportDemoID, ExportOptions))
+        {
+            fprintf(stderr, "Usage: %s --export-frames <demoID> <output dir or file>\n"
+                    "  [--format png|raw] [--fps N] [--skip N] [--scale percent]\n"
+                    "  [--room] [--turns first-last]\n", argv[0]);
+            return 1;
+        }
+        bNoFullscreen = true;
+    }
+    const bool bHeadless = dwBenchDemoID != 0L || dwExportDemoID != 0L;
+
+    //Sound library: "--audio fmod|sdl_mixer|null", or "--audio-log <file>" to
+    //record what would have played ("-" for stdout).  Headless runs go
+    //through the null backend unless told otherwise, so they don't need a
+    //sound device but still run the same sound code.
+    AUDIOBACKENDTYPE eAudioBackend = bHeadless ? ABT_Null : ABT_Default;
+    const char *pszAudioLogFilepath = NULL;
+    int nAudioArg = FindArg(argc, argv, "--audio");
+    if (nAudioArg != -1)
+    {
+        const char *pszAudio = nAudioArg + 1 < argc ? argv[nAudioArg + 1] : "";
+        if (!strcmp(pszAudio, "fmod"))
+            eAudioBackend = ABT_FMOD;
+        else if (!strcmp(pszAudio, "sdl_mixer"))
+            eAudioBackend = ABT_SDLMixer;
+        else if (!strcmp(pszAudio, "null"))
+            eAudioBackend = ABT_Null;
+        else
+        {
+            fprintf(stderr, "Usage: %s --audio fmod|sdl_mixer|null\n", argv[0]);
+            return 1;
+        }
+    }
+    if ((nAudioArg = FindArg(argc, argv, "--audio-log")) != -1)
+    {
+        if (nAudioArg + 1 >= argc)
+        {
+            fprintf(stderr, "Usage: %s --audio-log <file or ->\n", argv[0]);
+            return 1;
+        }
+        eAudioBackend = ABT_Recording;
+        pszAudioLogFilepath = argv[nAudioArg + 1];
+    }
+
+    //Print frame pacing histograms on exit: "--frame-stats".
+    const bool bFrameStats = FindArg(argc, argv, "--frame-stats") != -1;
+
 #ifndef __linux__
     //Disallow running more than one instance of the app at a time.
     if (IsAppAlreadyRunning()) return 1;
@@ -120,10 +202,16 @@ int main(int argc, char *argv[])
         return 1;
     }
 #endif
-    MESSAGE_ID ret = Init(bNoFullscreen, bNoSound);
+    MESSAGE_ID ret = Init(bNoFullscreen, bNoSound, bHeadless, eAudioBackend,
+            pszAudioLogFilepath);
+    int nBenchRet = 0;
 
 	if (ret != MID_Success && ret != MID_DatCorrupted_Restored)
 		DisplayInitErrorMessage(ret);
+	else if (dwExportDemoID)
+		nBenchRet = ExportDemoFrames(dwExportDemoID, ExportOptions);
+	else if (bHeadless)
+		nBenchRet = RunRenderBenchmark(dwBenchDemoID, wBenchFramesPerTurn);
 	else
 	{
        SCREENTYPE eNextScreen = SCR_None;
@@ -167,11 +255,13 @@ int main(int argc, char *argv[])
 
         //Show hourglass.
         SDL_SetCursor(g_pTheSM->GetCursor(CUR_Wait));
+
+        if (bFrameStats) PrintFrameStats();
 	}
 
     //Deinitialize the app.
     Deinit();
-    return ret!=MID_Success;
+    return ret!=MID_Success || nBenchRet!=0;
 }
 
 //*****************************************************************************
@@ -186,8 +276,12 @@ static MESSAGE_ID Init(
 //Params:
   const bool bNoFullscreen,         //(in)  If true, then app will run windowed regardless
                               //      of player settings.
-  const bool bNoSound)              //(in)  If true, then all sound will be disabled
+  const bool bNoSound,              //(in)  If true, then all sound will be disabled
                               //      regardless of player settings.
+  const bool bHeadless,             //(in)  If true, render offscreen without
+                              //      opening a window.
+  const AUDIOBACKENDTYPE eAudioBackend,  //(in)  Sound library to use.
+  const char *pszAudioLogFilepath)  //(in)  Where ABT_Recording writes its log.
 //
 //Returns:
 //MID_Success or Message ID of a failure message to display to user.
@@ -213,11 +307,11 @@ static MESSAGE_ID Init(
 
 	//Initialize graphics before other things, because I want to show the
 	//screen quickly for the user.
-	ret = InitGraphics(bNoFullscreen);
+	ret = InitGraphics(bNoFullscreen, bHeadless);
 	if (ret) return ret;
 
 	//Initialize sound.  Music will not play until title screen loads.
-	ret = InitSound(bNoSound);
+	ret = InitSound(bNoSound, eAudioBackend, pszAudioLogFilepath);
 	if (ret) return ret;
 
 	//Enable international support.
@@ -300,7 +394,9 @@ static MESSAGE_ID InitGraphics(
 //a window.
 //
 //Params:
-  const bool bNoFullscreen) //(in)  If true, then fullscreen window will not be used.
+  const bool bNoFullscreen, //(in)  If true, then fullscreen window will not be used.
+  const bool bHeadless)     //(in)  If true, SDL's dummy video driver is used and
+                            //      everything is drawn to an offscreen surface.
 //
 //Returns:
 //MID_Success or an error message ID.
@@ -308,6 +404,12 @@ static MESSAGE_ID InitGraphics(
     LOGCONTEXT("InitGraphics");
 
 	char szErrMsg[80];
+	if (bHeadless)
+	{
+		static char szDummyDriver[] = "SDL_VIDEODRIVER=dummy";
+		SDL_putenv(szDummyDriver);
+	}
+
 	//Initialize the library.
 	if ( SDL_Init(SDL_INIT_VIDEO) < 0 )
 	{
@@ -339,7 +441,12 @@ static MESSAGE_ID InitGraphics(
 			"Fullscreen", false) : false);
 	const Uint32 flags = bFullscreen ? SDL_FULLSCREEN : 0;
 	delete pCurrentPlayer;
-	SDL_Surface *pScreenSurface = SDL_SetVideoMode(640, 480, 24, flags);
+	SDL_Surface *pScreenSurface;
+	if (bHeadless)
+		pScreenSurface = m_pHeadlessSurface = SDL_CreateRGBSurface(SDL_SWSURFACE,
+				640, 480, 24, 0, 0, 0, 0);
+	else
+		pScreenSurface = SDL_SetVideoMode(640, 480, 24, flags);
 
    if (!pScreenSurface)
 	{
@@ -369,7 +476,7 @@ static MESSAGE_ID InitGraphics(
 
 	//Init the screen manager.
 	ASSERT(!g_pTheSM);
-	g_pTheDSM = new CDrodScreenManager(pScreenSurface);
+	g_pTheDSM = new CDrodScreenManager(pScreenSurface, bHeadless);
 	g_pTheSM = (CScreenManager*)g_pTheDSM;
 	if (!g_pTheSM) return MID_OutOfMemory;
 	ret = (MESSAGE_ID)g_pTheDSM->Init();
@@ -426,6 +533,12 @@ static void DeinitGraphics()
 		g_pTheBM = NULL;
 	}
 
+	if (m_pHeadlessSurface)
+	{
+		SDL_FreeSurface(m_pHeadlessSurface);
+		m_pHeadlessSurface = NULL;
+	}
+
 	SDL_Quit();
 }
 
@@ -434,9 +547,11 @@ static MESSAGE_ID InitSound(
 //After this call, g_pTheSound can be used.
 //
 //Params:
-  const bool bNoSound)  //(in)  If true, then all sound will be disabled.  Unlike,
+  const bool bNoSound,  //(in)  If true, then all sound will be disabled.  Unlike,
                   //      partial disablement, this will prevent any sound library
                   //      calls to be made during this session.
+  const AUDIOBACKENDTYPE eAudioBackend,  //(in)  Sound library to use.
+  const char *pszAudioLogFilepath)  //(in)  Where ABT_Recording writes its log.
 //
 //Returns:
 //MID_Success or an error message ID.
@@ -445,9 +560,13 @@ static MESSAGE_ID InitSound(
 	ASSERT(!g_pTheSound);
 
 	//Create global instance of CSound object.
-	g_pTheSound = (CSound*)new CDrodSound(bNoSound);
+	g_pTheSound = (CSound*)new CDrodSound(bNoSound, eAudioBackend,
+			pszAudioLogFilepath);
 	ASSERT(g_pTheSound);
 	if (bNoSound) return MID_Success;
+	if (eAudioBackend != ABT_Default && !g_pTheSound->IsSoundEffectsAvailable())
+		fprintf(stderr, "The requested audio backend couldn't be started.  "
+				"See the error log for details.\n");
 
 	//CSound() disables itself if a failure occurs during construction.
 	//Future calls to a disabled g_pTheSound don't do anything, which is okay.
@@ -595,6 +714,86 @@ static void DisplayInitErrorMessage(
 #endif
 }
 
+//*****************************************************************************
+static void PrintFrameStats()
+//Prints the event loop's frame pacing totals and histograms to stderr.
+{
+	const FRAMESTATS &stats = CEventHandlerWidget::GetFrameStats();
+	if (!stats.dwFrames) return;
+
+	fprintf(stderr, "Frames: %lu  over budget: %lu  idle: %lums  overslept: %lums\n",
+			(unsigned long)stats.dwFrames, (unsigned long)stats.dwOverBudgetFrames,
+			(unsigned long)stats.dwIdleMSecs, (unsigned long)stats.dwOversleptMSecs);
+	fprintf(stderr, "%9s %10s %10s\n", "ms", "frame", "work");
+	for (UINT wBucket = 0; wBucket < FRAME_HISTOGRAM_BUCKETS; ++wBucket)
+	{
+		char szRange[16];
+		if (wBucket + 1 < FRAME_HISTOGRAM_BUCKETS)
+			sprintf(szRange, "%u-%u", wBucket * FRAME_HISTOGRAM_MSECS,
+					(wBucket + 1) * FRAME_HISTOGRAM_MSECS - 1);
+		else
+			sprintf(szRange, "%u+", wBucket * FRAME_HISTOGRAM_MSECS);
+		fprintf(stderr, "%9s %10lu %10lu\n", szRange,
+				(unsigned long)stats.dwFrameTimes[wBucket],
+				(unsigned long)stats.dwWorkTimes[wBucket]);
+	}
+}
+
+//*****************************************************************************
+static bool GetExportArgs(
+//Reads the arguments for a frame export.
+//
+//Params:
+  int argc, char *argv[],         //(in)  Command line.
+  const int nExportArg,           //(in)  Index of "--export-frames".
+  DWORD &dwDemoID,                //(out) Demo to export.
+  FRAMEEXPORTOPTIONS &Options)    //(out) Everything else.
+//
+//Returns:
+//True if the arguments were valid, false otherwise.
+{
+	if (nExportArg + 2 >= argc) return false;
+	dwDemoID = strtoul(argv[nExportArg + 1], NULL, 10);
+	Options.pszOutput = argv[nExportArg + 2];
+	if (!dwDemoID) return false;
+
+	int nArg;
+	if ((nArg = FindArg(argc, argv, "--format")) != -1)
+	{
+		if (nArg + 1 >= argc) return false;
+		if (!strcmp(argv[nArg + 1], "raw")) Options.bRaw = true;
+		else if (strcmp(argv[nArg + 1], "png")) return false;
+	}
+	if ((nArg = FindArg(argc, argv, "--fps")) != -1)
+	{
+		if (nArg + 1 >= argc) return false;
+		Options.wFPS = strtoul(argv[nArg + 1], NULL, 10);
+		if (!Options.wFPS || Options.wFPS > 1000) return false;
+	}
+	if ((nArg = FindArg(argc, argv, "--skip")) != -1)
+	{
+		if (nArg + 1 >= argc) return false;
+		Options.wFrameSkip = strtoul(argv[nArg + 1], NULL, 10);
+	}
+	if ((nArg = FindArg(argc, argv, "--scale")) != -1)
+	{
+		if (nArg + 1 >= argc) return false;
+		Options.wScalePercent = strtoul(argv[nArg + 1], NULL, 10);
+		if (!Options.wScalePercent || Options.wScalePercent > 400) return false;
+	}
+	Options.bRoomOnly = FindArg(argc, argv, "--room") != -1;
+	if ((nArg = FindArg(argc, argv, "--turns")) != -1)
+	{
+		if (nArg + 1 >= argc) return false;
+		char *pszEnd;
+		Options.wFirstTurn = strtoul(argv[nArg + 1], &pszEnd, 10);
+		if (*pszEnd == '-')
+			Options.wLastTurn = strtoul(pszEnd + 1, NULL, 10);
+		if (Options.wLastTurn < Options.wFirstTurn) return false;
+	}
+	return true;
+}
+
 //*****************************************************************************
 static int FindArg(
 //Find an argument by its name.
@@ -738,45 +738,36 @@ void CMapWidget::InitMapColors()
 bool CMapWidget::LoadMapSurface()
 //Creates map surface resource containing representation of all rooms in level.
 {
-	bool bSuccess = true;
-
-	//Load every room in the current level.
-	list<CDbRoom *> DrawRooms;
-	CDbRoom *pRoom = this->pLevel->Rooms.GetFirst();
-	if (!pRoom)
+	//Get map squares of every room in the current level.  Rooms are not loaded.
+	vector<const CRoomMap *> RoomMaps, DrawRooms;
+	CDbRooms::GetMapsForLevel(this->pLevel->dwLevelID, RoomMaps);
+	if (RoomMaps.empty())
 	{
 		//No rooms to display.
 		DrawPlaceholder();
 		return true;
 	}
-	this->dwLeftRoomX = this->dwRightRoomX = pRoom->dwRoomX;
-	this->dwBottomRoomY = this->dwTopRoomY = pRoom->dwRoomY;
-	while (pRoom)
+	this->dwLeftRoomX = this->dwRightRoomX = RoomMaps[0]->dwRoomX;
+	this->dwBottomRoomY = this->dwTopRoomY = RoomMaps[0]->dwRoomY;
+	for (vector<const CRoomMap *>::const_iterator iRoom = RoomMaps.begin();
+			iRoom != RoomMaps.end(); ++iRoom)
 	{
+		const CRoomMap *pRoomMap = *iRoom;
+
 		//Look for expansion of level boundaries.
-		if (pRoom->dwRoomX < this->dwLeftRoomX)
-			this->dwLeftRoomX = pRoom->dwRoomX;
-		else if (pRoom->dwRoomX > this->dwRightRoomX)
-			this->dwRightRoomX = pRoom->dwRoomX;
-		if (pRoom->dwRoomY < this->dwTopRoomY)
-			this->dwTopRoomY = pRoom->dwRoomY;
-		else if (pRoom->dwRoomY > this->dwBottomRoomY)
-			this->dwBottomRoomY = pRoom->dwRoomY;
+		if (pRoomMap->dwRoomX < this->dwLeftRoomX)
+			this->dwLeftRoomX = pRoomMap->dwRoomX;
+		else if (pRoomMap->dwRoomX > this->dwRightRoomX)
+			this->dwRightRoomX = pRoomMap->dwRoomX;
+		if (pRoomMap->dwRoomY < this->dwTopRoomY)
+			this->dwTopRoomY = pRoomMap->dwRoomY;
+		else if (pRoomMap->dwRoomY > this->dwBottomRoomY)
+			this->dwBottomRoomY = pRoomMap->dwRoomY;
 
 		//Keep the rooms that have been explored in a list.
-		if (this->bEditing)
-			DrawRooms.push_back(pRoom);
-		else
-		{
-			if (this->pCurrentGame->IsRoomAtCoordsExplored(pRoom->dwRoomX, 
-					pRoom->dwRoomY))
-				DrawRooms.push_back(pRoom);
-			else
-				delete pRoom;
-		}
-
-		//Get next room in level.
-		pRoom = this->pLevel->Rooms.GetNext();
+		if (this->bEditing || this->pCurrentGame->IsRoomAtCoordsExplored(
+				pRoomMap->dwRoomX, pRoomMap->dwRoomY))
+			DrawRooms.push_back(pRoomMap);
 	}
 
    //Currently, a room's y-coordinate contains a pseudo-level encoding in its 100s place.
@@ -813,8 +804,7 @@ bool CMapWidget::LoadMapSurface()
 	{
         CFiles Files;
 		Files.AppendErrorLog("CMapWidget::LoadMapSurface()--SDL_CreateRGBSurface() failed.");
-		bSuccess = false;
-		goto Cleanup;
+		return false;
 	}
 
 	//Get colors for drawing on map surface.
@@ -824,22 +814,14 @@ bool CMapWidget::LoadMapSurface()
 	SDL_FillRect(this->pMapSurface,NULL,m_arrColor[MAP_DKCYAN].byt3 << 16 |
 			m_arrColor[MAP_DKCYAN].byt2 << 8 | m_arrColor[MAP_DKCYAN].byt1);
 
-	{	
-		//Draw each room onto the map.
-		for( list<CDbRoom *>::const_iterator iSeek = DrawRooms.begin();
+	//Draw each room onto the map.
+	for (vector<const CRoomMap *>::const_iterator iSeek = DrawRooms.begin();
 			iSeek != DrawRooms.end(); ++iSeek)
-		{
-			DrawMapSurfaceFromRoom(*iSeek);
-		}
-	}
-
-Cleanup:
-	for( list<CDbRoom *>::const_iterator iSeek = DrawRooms.begin();
-		iSeek != DrawRooms.end(); ++iSeek)
 	{
-		delete *iSeek;
+		DrawMapSurfaceFromRoom(*iSeek);
 	}
-	return bSuccess;
+
+	return true;
 }
 
 //*****************************************************************************
@@ -871,14 +853,9 @@ void CMapWidget::UpdateMapSurface()
 					bDrawCurrentRoom = true;
 				else
 				{
-					//Load the room in.
-					CDbRoom *pTempRoom = this->pLevel->Rooms.GetByID(
-							pConquered->dwID);
-					if (pTempRoom)
-					{
-						DrawMapSurfaceFromRoom(pTempRoom);
-						delete pTempRoom;
-					}
+					const CRoomMap *pRoomMap = CDbRooms::GetMap(pConquered->dwID);
+					if (pRoomMap)
+						DrawMapSurfaceFromRoom(pRoomMap);
 					else
 						ASSERTP(false, "Failed to retrieve room");
 				}
@@ -906,14 +883,9 @@ void CMapWidget::UpdateMapSurface()
 						bDrawCurrentRoom = true;
 					else
 					{
-						//Load the room in.
-						CDbRoom *pTempRoom = this->pLevel->Rooms.GetByID(
-								pExplored->dwID);
-						if (pTempRoom)
-						{
-							DrawMapSurfaceFromRoom(pTempRoom);
-							delete pTempRoom;
-						}
+						const CRoomMap *pRoomMap = CDbRooms::GetMap(pExplored->dwID);
+						if (pRoomMap)
+							DrawMapSurfaceFromRoom(pRoomMap);
 						else
 							ASSERTP(false, "Failed to retrieve room.");
 					}
@@ -939,25 +911,47 @@ void CMapWidget::UpdateMapSurface()
 
 //*****************************************************************************
 void CMapWidget::DrawMapSurfaceFromRoom(
-//Loads a room from disk into a specified position in the map surface.
+//Draws a loaded room, in its current state, into its position in the map surface.
 //
 //Params:
-  const CDbRoom *pRoom)	//(in)	Contains coords of room to update on map
-						//		as well as the squares of the room to use
-						//		in determining pixels.
+  const CDbRoom *pRoom)	//(in)	Room to draw.
 {
 	ASSERT(pRoom);
 
+	CRoomMap RoomMap;
+	RoomMap.dwRoomID = pRoom->dwRoomID;
+	RoomMap.dwLevelID = pRoom->dwLevelID;
+	RoomMap.dwRoomX = pRoom->dwRoomX;
+	RoomMap.dwRoomY = pRoom->dwRoomY;
+	RoomMap.wRoomCols = pRoom->wRoomCols;
+	RoomMap.wRoomRows = pRoom->wRoomRows;
+	RoomMap.SetTiles(pRoom->pszOSquares, pRoom->pszTSquares, pRoom->CalcRoomArea());
+	DrawMapSurfaceFromRoom(&RoomMap);
+}
+
+//*****************************************************************************
+void CMapWidget::DrawMapSurfaceFromRoom(
+//Draws a room's map squares into its position in the map surface.
+//
+//Params:
+  const CRoomMap *pRoomMap)	//(in)	Contains coords of room to update on map
+							//		as well as the squares of the room to use
+							//		in determining pixels.
+{
+	ASSERT(pRoomMap);
+	ASSERT(pRoomMap->Tiles.size() == (DWORD)CDrodBitmapManager::DISPLAY_COLS *
+			CDrodBitmapManager::DISPLAY_ROWS);
+
 	//Get variables that affect how map pixels are set.
 	//When there is no current game, then show everything fully.
 	const bool bConquered = (this->pCurrentGame ? this->pCurrentGame->
-			IsRoomAtCoordsConquered(pRoom->dwRoomX, pRoom->dwRoomY) : true);
+			IsRoomAtCoordsConquered(pRoomMap->dwRoomX, pRoomMap->dwRoomY) : true);
 	const bool bCompleted = (this->pCurrentGame ? this->pCurrentGame->
 			IsCurrentLevelComplete() : false);
 	const bool bDarkened  = (this->pCurrentGame ?
-			this->DarkenedRooms.IsIDInList(pRoom->dwRoomID) : false);
+			this->DarkenedRooms.IsIDInList(pRoomMap->dwRoomID) : false);
    const bool bPendingExit = (this->pCurrentGame ?
-         pRoom->dwRoomID == this->pCurrentGame->pRoom->dwRoomID &&   //only applies to current room
+         pRoomMap->dwRoomID == this->pCurrentGame->pRoom->dwRoomID &&   //only applies to current room
          this->pCurrentGame->IsCurrentRoomPendingExit() : false);
 
 	//Set colors in map surface to correspond to squares in the room.
@@ -966,9 +960,9 @@ void CMapWidget::DrawMapSurfaceFromRoom(
 	SURFACECOLOR Color;
 	static const UINT wBPP = this->pMapSurface->format->BytesPerPixel;
 	const DWORD dwRowOffset = this->pMapSurface->pitch - (CDrodBitmapManager::DISPLAY_COLS * wBPP);
-	Uint8 *pSeek = GetRoomStart(pRoom->dwRoomX, pRoom->dwRoomY);
+	Uint8 *pSeek = GetRoomStart(pRoomMap->dwRoomX, pRoomMap->dwRoomY);
 	Uint8 *pStop = pSeek + (this->pMapSurface->pitch * CDrodBitmapManager::DISPLAY_ROWS);
-	UINT wSquareIndex=0;
+	const BYTE *pTile = &pRoomMap->Tiles[0];
 
 	//Each iteration draws one row.
 	while (pSeek != pStop)
@@ -979,15 +973,12 @@ void CMapWidget::DrawMapSurfaceFromRoom(
 		//Each iteration draws one pixel.
 		while (pSeek != pEndOfRow)
 		{
-			Color = GetMapColorFromTile(
-				(unsigned char) pRoom->pszOSquares[wSquareIndex],
-				(unsigned char) pRoom->pszTSquares[wSquareIndex],
+			Color = GetMapColorFromTile(*pTile++,
 				bConquered, bCompleted, bDarkened, bPendingExit);
 			pSeek[0] = Color.byt1;
 			pSeek[1] = Color.byt2;
 			pSeek[2] = Color.byt3;
 
-			++wSquareIndex;
 			pSeek += wBPP;
 		}
 		pSeek += dwRowOffset;
@@ -1018,18 +1009,16 @@ inline SURFACECOLOR CMapWidget::GetMapColorFromTile(
 //Returns the map image color that corresponds to a given tile#.
 //
 //Accepts:
-	const UINT wOpaqueTile, 
-	const UINT wTransparentTile,
+	const UINT wMapTile,		//T_TAR, or else an o-square tile.
 	const bool bRoomConquered, 
 	const bool bLevelComplete,
 	const bool bDarkened,
    const bool bPendingExit)
 {
-	if (wTransparentTile == T_TAR)
-		return m_arrColor[MAP_MAGENTA];
-
-	switch (wOpaqueTile)
+	switch (wMapTile)
 	{
+		case T_TAR:
+			return m_arrColor[MAP_MAGENTA];
 		case T_WALL: case T_WALL_B:
 			return bDarkened ? m_arrColor[MAP_DKCYAN2] : m_arrColor[MAP_BLACK];
 		case T_STAIRS: case T_DOOR_Y:
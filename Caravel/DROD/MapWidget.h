@@ -28,6 +28,8 @@
 #include <FrontEndLib/FocusWidget.h>
 #include "../DRODLib/CurrentGame.h"
 
+class CRoomMap;
+
 //******************************************************************************
 class CMapWidget : public CFocusWidget
 {		
@@ -64,8 +66,9 @@ class CMapWidget : public CFocusWidget
     
 	private:
 		void				DrawMapSurfaceFromRoom(const CDbRoom *pRoom);
-		inline SURFACECOLOR	GetMapColorFromTile(const UINT wOpaqueTile,
-				const UINT wTransparentTile, const bool bRoomConquered,
+		void				DrawMapSurfaceFromRoom(const CRoomMap *pRoomMap);
+		inline SURFACECOLOR	GetMapColorFromTile(const UINT wMapTile,
+				const bool bRoomConquered,
 				const bool bLevelComplete, const bool bDarkened,
                 const bool bPendingExit);
 		inline Uint8 *		GetRoomStart(const DWORD dwRoomX, const DWORD dwRoomY);
@@ -27,8 +27,6 @@
 #include "TileImageConstants.h"
 #include "DrodBitmapManager.h"
 #include "../DRODLib/GameConstants.h"
-#include "../DRODLib/TileConstants.h"
-#include "../DRODLib/DbRooms.h"
 
 const UINT EXPLOSION_SPEED = 2;
 const UINT EXPLOSION_DURATION = 7;
@@ -46,11 +44,12 @@ CParticleExplosionEffect::CParticleExplosionEffect(
    const UINT wMaxParticleSize,  //(in) Max dimensions of particle sprite
 	const UINT wParticles)	      //(in) Number of particles to generate
 	: CEffect(pSetWidget)
-   , wMaxParticleSize(wMaxParticleSize)
 {
 	ASSERT(pSetWidget->GetType() == WT_Room);
+	this->pParticles = DYN_CAST(CRoomWidget*, CWidget*, pSetWidget)->GetParticleSystem();
 
-	pSetWidget->GetRect(this->screenRect);
+	SDL_Rect screenRect;
+	pSetWidget->GetRect(screenRect);
 
 	//Determine explosion point of origin (center of tile).
 	const int x = MoveCoord.wCol*CBitmapManager::CX_TILE + CBitmapManager::CX_TILE/2;
@@ -70,18 +69,10 @@ CParticleExplosionEffect::CParticleExplosionEffect(
 	}
 
 	//Add random explosion particles.
-	this->wParticleCount = wParticles + RAND(wParticles/2);
-	this->parrParticles = new PARTICLE[this->wParticleCount];
-	for (UINT nIndex=this->wParticleCount; nIndex--; )
-	{
-		this->parrParticles[nIndex].x = screenRect.x + x;
-		this->parrParticles[nIndex].y = screenRect.y + y;
-		this->parrParticles[nIndex].mx = nXOffset + fRAND_MID(nXRange*0.5);
-		this->parrParticles[nIndex].my = nYOffset + fRAND_MID(nYRange*0.5);
-		this->parrParticles[nIndex].wDurationLeft = EXPLOSION_DURATION;
-		this->parrParticles[nIndex].type = (RAND(3)==0 ? 1 : 0);	//one of two styles
-		this->parrParticles[nIndex].bActive= true;
-	}
+	const UINT wParticleCount = wParticles + RAND(wParticles/2);
+	this->dwParticlesID = this->pParticles->AddParticles(wParticleCount,
+			(float)(screenRect.x + x), (float)(screenRect.y + y),
+			nXOffset, nXRange, nYOffset, nYRange, EXPLOSION_DURATION, wMaxParticleSize);
 
 	MoveParticles();
 }
@@ -90,7 +81,20 @@ CParticleExplosionEffect::CParticleExplosionEffect(
 CParticleExplosionEffect::~CParticleExplosionEffect()
 //Destructor.
 {
-	delete [] this->parrParticles;
+	this->pParticles->RemoveParticles(this->dwParticlesID);
+}
+
+//*****************************************************************************
+void CParticleExplosionEffect::DrawParticles(
+//Draws the live particles.
+//
+//Params:
+	const PARTICLESPRITE *pSprites,	//(in)	Sprite for each of the two particle types.
+	SDL_Surface *pDestSurface)		//(in)	Where to draw, or NULL for the widget's surface.
+{
+   if (!pDestSurface)
+      pDestSurface = GetDestSurface();
+	this->pParticles->DrawParticles(this->dwParticlesID, pSprites, pDestSurface);
 }
 
 //*****************************************************************************
@@ -100,117 +104,19 @@ bool CParticleExplosionEffect::MoveParticles()
 //
 //Returns: whether any particles are still active
 {
-	UINT xMax=0, yMax=0;	//bottom edge of bounding box
-	bool bActiveParticles = false;	//whether any particles are still active
-
-	//Reset bounding box.
-	this->rAreaOfEffect.x = this->screenRect.x + this->screenRect.w;
-	this->rAreaOfEffect.y = this->screenRect.y + this->screenRect.h;
-	this->rAreaOfEffect.w = this->rAreaOfEffect.h = 0;
-
-	const Uint32 dwNow = SDL_GetTicks();
+	const Uint32 dwNow = GetAnimationTicks();
    const Uint32 dwTimeElapsed = this->dwTimeOfLastMove >= dwNow ? 1 :
          dwNow - this->dwTimeOfLastMove;
    const float fMultiplier = dwTimeElapsed / 33.0;
-	const int nDecay = ROUND(2.0f / fMultiplier);
-	for (UINT nIndex=wParticleCount; nIndex--; )
-	{
-		//See if particle should still be active and moved.
-		if (this->parrParticles[nIndex].bActive)
-		{
-			//Update real position in real time.
-			this->parrParticles[nIndex].x += this->parrParticles[nIndex].mx * fMultiplier;
-			this->parrParticles[nIndex].y += this->parrParticles[nIndex].my * fMultiplier;
-
-			//If particle is going to go out of bounds, kill it.
-			if (OutOfBounds(this->parrParticles[nIndex]))
-			{
-				this->parrParticles[nIndex].bActive=false;
-				continue;
-			}
 
-         //Does particle runs into an obstacle?
-         if (HitsObstacle(this->parrParticles[nIndex]))
-				ReflectParticle(this->parrParticles[nIndex]);
+	const bool bActiveParticles = this->pParticles->MoveParticles(
+			this->dwParticlesID, fMultiplier, this->rAreaOfEffect);
 
-			//Exponential particle decay.
-			if (RAND(nDecay) == 0)
-				if (--this->parrParticles[nIndex].wDurationLeft == 0)	//display time is over
-				{
-					this->parrParticles[nIndex].bActive=false;
-					continue;
-				}
-			bActiveParticles = true;
-
-			//Update bounding box of area of effect.
-			const int x = ROUND(this->parrParticles[nIndex].x);
-			const int y = ROUND(this->parrParticles[nIndex].y);
-			const int x2 = x + this->wMaxParticleSize;
-			const int y2 = y + this->wMaxParticleSize;
-			if (x < this->rAreaOfEffect.x)
-				this->rAreaOfEffect.x = x;
-			if (y < this->rAreaOfEffect.y)
-				this->rAreaOfEffect.y = y;
-			if (x2 > static_cast<int>(xMax))
-				xMax = x2;
-			if (y2 > static_cast<int>(yMax))
-				yMax = y2;
-		}
-	}
-	if (bActiveParticles)
-	{
-		this->rAreaOfEffect.w = xMax - this->rAreaOfEffect.x;
-		this->rAreaOfEffect.h = yMax - this->rAreaOfEffect.y;
-	}
-
-	this->dwTimeOfLastMove = SDL_GetTicks();
+	this->dwTimeOfLastMove = dwNow;
 
 	return bActiveParticles;
 }
 
-//*****************************************************************************
-inline bool CParticleExplosionEffect::OutOfBounds(const PARTICLE &particle) const
-{
-	return (particle.x < screenRect.x || particle.y < screenRect.y ||
-				particle.x >= screenRect.x + screenRect.w - this->wMaxParticleSize ||
-				particle.y >= screenRect.y + screenRect.h - this->wMaxParticleSize);
-}
-
-//*****************************************************************************
-inline bool CParticleExplosionEffect::HitsObstacle(const PARTICLE &particle) const
-//O-square obstacle?
-{
-	const CDbRoom *pRoom = DYN_CAST(CRoomWidget*, CWidget*, this->pOwnerWidget)->GetCurrentGame()->pRoom;
-	const UINT wOTileNo = (UINT)(pRoom->pszOSquares[
-		((((Sint16)particle.y - screenRect.y) / CBitmapManager::CY_TILE) * pRoom->wRoomCols) +
-		(((Sint16)particle.x - screenRect.x) / CBitmapManager::CX_TILE)]);
-	switch (wOTileNo) {
-		case T_FLOOR:
-		case T_DOOR_YO:
-		case T_PIT:
-		case T_CHECKPOINT:
-		case T_TRAPDOOR: return false;	//particle can go through these things
-		default: return true;
-	}
-}
-
-//*****************************************************************************
-inline void CParticleExplosionEffect::ReflectParticle(PARTICLE &particle) const
-{
-	particle.x -= particle.mx;	//offset the move just done the other way
-	particle.y -= particle.my;
-
-	//Randomly reflect particle trajectory.
-	if (RAND(2) == 0)
-	{
-		particle.mx = -particle.mx;
-		particle.x += particle.mx;
-	} else {
-		particle.my = -particle.my;
-		particle.y += particle.my;
-	}
-}
-
 // $Log: ParticleExplosionEffect.cpp,v $
 // Revision 1.22  2003/09/16 20:40:24  mrimer
 // Converted int momentums to floats for more realism.
@@ -33,21 +33,11 @@
 #define CPARTICLEEXPLOSIONEFFECT_H
 
 #include "DrodEffect.h"
+#include "ParticleSystem.h"
 #include "../DRODLib/CurrentGame.h"
 
-#define ROUND(x)	(int)((x) + 0.5)
-
 const UINT PARTICLES_PER_EXPLOSION=25;
 
-struct PARTICLE
-{
-	float x, y;    //position
-	float mx, my;	//momentum
-	int type;      //tile #
-	UINT wDurationLeft;
-	bool bActive;
-};
-
 //******************************************************************************
 class CParticleExplosionEffect : public CEffect
 {
@@ -59,18 +49,12 @@ public:
 	//virtual bool	Draw() = 0;
 
 protected:
+	void DrawParticles(const PARTICLESPRITE *pSprites, SDL_Surface *pDestSurface);
 	bool MoveParticles();
 
-	PARTICLE *parrParticles;
-	UINT wParticleCount;
-   const UINT wMaxParticleSize;
-
 private:
-	bool OutOfBounds(const PARTICLE &particle) const;
-	bool HitsObstacle(const PARTICLE &particle) const;
-	void ReflectParticle(PARTICLE &particle) const;
-
-	SDL_Rect screenRect;
+	CParticleSystem *pParticles;	//owned by the room widget
+	DWORD dwParticlesID;
 };
 
 #endif	//...#ifndef CPARTICLEEXPLOSIONEFFECT_H
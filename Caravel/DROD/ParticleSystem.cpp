@@ -0,0 +1,303 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is Deadly Rooms of Death.
+ *
+ * The Initial Developer of the Original Code is
+ * Caravel Software.
+ * Portions created by the Initial Developer are Copyright (C) 2005
+ * Caravel Software. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+
+//ParticleSystem.cpp
+//Implementation of CParticleSystem.
+
+#include "ParticleSystem.h"
+#include "DrodBitmapManager.h"
+#include "../DRODLib/DbRooms.h"
+#include "../DRODLib/TileConstants.h"
+#include <BackEndLib/Assert.h>
+
+#define ROUND(x)	(int)((x) + 0.5)
+
+//*****************************************************************************
+CParticleSystem::CParticleSystem()
+//Constructor.
+	: dwLastID(0L)
+	, wLiveParticles(0)
+	, wMaskCols(0), wMaskRows(0)
+{
+	memset(&this->RoomRect, 0, sizeof(this->RoomRect));
+}
+
+//*****************************************************************************
+DWORD CParticleSystem::AddParticles(
+//Adds a burst of particles starting from one point.
+//
+//Params:
+	const UINT wCount,				//(in)	Number of particles.
+	const float fX, const float fY,	//(in)	Starting point, in screen coords.
+	const int nXOffset, const int nXRange,	//(in)	Momentums are offset +/- range/2.
+	const int nYOffset, const int nYRange,	//
+	const UINT wDuration,			//(in)	Decay steps before a particle is gone.
+	const UINT wMaxParticleSize)	//(in)	Max dimensions of particle sprite.
+//
+//Returns:
+//ID for the particles, to pass to the other methods.
+{
+	ASSERT(wDuration > 0 && wDuration < 256);
+
+	PARTICLEBLOCK block;
+	block.dwID = ++this->dwLastID;
+	block.wFirst = this->x.size();
+	block.wCount = block.wCapacity = wCount;
+	block.wMaxParticleSize = wMaxParticleSize;
+	this->Blocks.push_back(block);
+
+	const UINT wSize = block.wFirst + wCount;
+	this->x.resize(wSize, fX);
+	this->y.resize(wSize, fY);
+	this->mx.resize(wSize);
+	this->my.resize(wSize);
+	this->wDurationLeft.resize(wSize, (Uint8)wDuration);
+	this->type.resize(wSize);
+	for (UINT wIndex = wSize; wIndex-- > block.wFirst; )
+	{
+		this->mx[wIndex] = nXOffset + fRAND_MID(nXRange*0.5);
+		this->my[wIndex] = nYOffset + fRAND_MID(nYRange*0.5);
+		this->type[wIndex] = (RAND(3)==0 ? 1 : 0);	//one of two styles
+	}
+	this->wLiveParticles += wCount;
+
+	return block.dwID;
+}
+
+//*****************************************************************************
+void CParticleSystem::DrawParticles(
+//Draws live particles of one effect.
+//
+//Params:
+	const DWORD dwID,					//(in)	Particles to draw.
+	const PARTICLESPRITE *pSprites,	//(in)	Sprite for each particle type.
+	SDL_Surface *pDestSurface)		//(in)	Where to draw.
+const
+{
+	const PARTICLEBLOCK *pBlock = FindBlock(dwID);
+	if (!pBlock) return;
+
+	const float *px = &this->x[pBlock->wFirst];
+	const float *py = &this->y[pBlock->wFirst];
+	const Uint8 *pType = &this->type[pBlock->wFirst];
+	for (UINT wIndex = pBlock->wCount; wIndex--; )
+	{
+		const PARTICLESPRITE &sprite = pSprites[pType[wIndex]];
+		g_pTheBM->BlitTileImagePart(sprite.wTileImageNo, ROUND(px[wIndex]),
+				ROUND(py[wIndex]), sprite.wW, sprite.wH, pDestSurface);
+	}
+}
+
+//*****************************************************************************
+bool CParticleSystem::MoveParticles(
+//Moves one effect's particles, bouncing them off obstacles and removing the
+//ones that left the room or decayed.
+//
+//Params:
+	const DWORD dwID,			//(in)	Particles to move.
+	const float fMultiplier,	//(in)	Frames of movement since the last move.
+	SDL_Rect &rAreaOfEffect)	//(out)	Bounding box of the live particles.
+//
+//Returns: whether any particles are still live
+{
+	rAreaOfEffect.x = this->RoomRect.x + this->RoomRect.w;
+	rAreaOfEffect.y = this->RoomRect.y + this->RoomRect.h;
+	rAreaOfEffect.w = rAreaOfEffect.h = 0;
+
+	PARTICLEBLOCK *pBlock = FindBlock(dwID);
+	if (!pBlock || !pBlock->wCount) return false;
+
+	float *px = &this->x[pBlock->wFirst];
+	float *py = &this->y[pBlock->wFirst];
+	float *pmx = &this->mx[pBlock->wFirst];
+	float *pmy = &this->my[pBlock->wFirst];
+	Uint8 *pDuration = &this->wDurationLeft[pBlock->wFirst];
+	Uint8 *pType = &this->type[pBlock->wFirst];
+	const UINT wCount = pBlock->wCount;
+	UINT wIndex;
+
+	//Update real position in real time.
+	for (wIndex = 0; wIndex < wCount; ++wIndex)
+		px[wIndex] += pmx[wIndex] * fMultiplier;
+	for (wIndex = 0; wIndex < wCount; ++wIndex)
+		py[wIndex] += pmy[wIndex] * fMultiplier;
+
+	//Area particles must stay inside of.
+	const float fLeft = this->RoomRect.x, fTop = this->RoomRect.y;
+	const float fRight = (float)(this->RoomRect.x + this->RoomRect.w) - pBlock->wMaxParticleSize;
+	const float fBottom = (float)(this->RoomRect.y + this->RoomRect.h) - pBlock->wMaxParticleSize;
+
+	//Collide, decay and pack live particles at the front of the block.
+	const int nDecay = ROUND(2.0f / fMultiplier);
+	int xMin = rAreaOfEffect.x, yMin = rAreaOfEffect.y, xMax = 0, yMax = 0;
+	UINT wLive = 0;
+	for (wIndex = 0; wIndex < wCount; ++wIndex)
+	{
+		//If particle went out of bounds, kill it.
+		if (px[wIndex] < fLeft || py[wIndex] < fTop ||
+				px[wIndex] >= fRight || py[wIndex] >= fBottom)
+			continue;
+
+		//Does particle run into an obstacle?
+		const UINT wCol = ((Sint16)px[wIndex] - this->RoomRect.x) / CBitmapManager::CX_TILE;
+		const UINT wRow = ((Sint16)py[wIndex] - this->RoomRect.y) / CBitmapManager::CY_TILE;
+		if (wCol < this->wMaskCols && wRow < this->wMaskRows &&
+				this->ObstacleMask[wRow * this->wMaskCols + wCol])
+		{
+			px[wIndex] -= pmx[wIndex];	//offset the move just done the other way
+			py[wIndex] -= pmy[wIndex];
+
+			//Randomly reflect particle trajectory.
+			if (RAND(2) == 0)
+			{
+				pmx[wIndex] = -pmx[wIndex];
+				px[wIndex] += pmx[wIndex];
+			} else {
+				pmy[wIndex] = -pmy[wIndex];
+				py[wIndex] += pmy[wIndex];
+			}
+		}
+
+		//Exponential particle decay.
+		if (RAND(nDecay) == 0)
+			if (--pDuration[wIndex] == 0)	//display time is over
+				continue;
+
+		if (wLive != wIndex)
+		{
+			px[wLive] = px[wIndex];
+			py[wLive] = py[wIndex];
+			pmx[wLive] = pmx[wIndex];
+			pmy[wLive] = pmy[wIndex];
+			pDuration[wLive] = pDuration[wIndex];
+			pType[wLive] = pType[wIndex];
+		}
+		++wLive;
+
+		//Update bounding box of area of effect.
+		const int x = ROUND(px[wIndex]);
+		const int y = ROUND(py[wIndex]);
+		if (x < xMin) xMin = x;
+		if (y < yMin) yMin = y;
+		if (x + (int)pBlock->wMaxParticleSize > xMax) xMax = x + pBlock->wMaxParticleSize;
+		if (y + (int)pBlock->wMaxParticleSize > yMax) yMax = y + pBlock->wMaxParticleSize;
+	}
+	this->wLiveParticles -= wCount - wLive;
+	pBlock->wCount = wLive;
+
+	if (!wLive) return false;
+	rAreaOfEffect.x = xMin;
+	rAreaOfEffect.y = yMin;
+	rAreaOfEffect.w = xMax - xMin;
+	rAreaOfEffect.h = yMax - yMin;
+	return true;
+}
+
+//*****************************************************************************
+void CParticleSystem::RemoveParticles(
+//Removes one effect's particles.  Particles added after them move down.
+//
+//Params:
+	const DWORD dwID)	//(in)	Particles to remove.
+{
+	for (vector<PARTICLEBLOCK>::iterator iBlock = this->Blocks.begin();
+			iBlock != this->Blocks.end(); ++iBlock)
+	{
+		if (iBlock->dwID != dwID) continue;
+
+		const UINT wFirst = iBlock->wFirst, wEnd = wFirst + iBlock->wCapacity;
+		this->x.erase(this->x.begin() + wFirst, this->x.begin() + wEnd);
+		this->y.erase(this->y.begin() + wFirst, this->y.begin() + wEnd);
+		this->mx.erase(this->mx.begin() + wFirst, this->mx.begin() + wEnd);
+		this->my.erase(this->my.begin() + wFirst, this->my.begin() + wEnd);
+		this->wDurationLeft.erase(this->wDurationLeft.begin() + wFirst,
+				this->wDurationLeft.begin() + wEnd);
+		this->type.erase(this->type.begin() + wFirst, this->type.begin() + wEnd);
+		this->wLiveParticles -= iBlock->wCount;
+
+		iBlock = this->Blocks.erase(iBlock);
+		for ( ; iBlock != this->Blocks.end(); ++iBlock)
+			iBlock->wFirst -= wEnd - wFirst;
+		return;
+	}
+}
+
+//*****************************************************************************
+void CParticleSystem::SetRoom(
+//Builds the obstacle mask for a room.  Call whenever the room's o-squares change.
+//
+//Params:
+	const CDbRoom *pRoom,		//(in)	Room particles are in.
+	const SDL_Rect &RoomRect)	//(in)	Where the room is drawn on screen.
+{
+	ASSERT(pRoom);
+	this->RoomRect = RoomRect;
+	this->wMaskCols = pRoom->wRoomCols;
+	this->wMaskRows = pRoom->wRoomRows;
+
+	const DWORD dwSquareCount = pRoom->CalcRoomArea();
+	this->ObstacleMask.resize(dwSquareCount);
+	for (DWORD dwSquareI = 0; dwSquareI < dwSquareCount; ++dwSquareI)
+	{
+		switch ((UINT)pRoom->pszOSquares[dwSquareI])
+		{
+			case T_FLOOR:
+			case T_DOOR_YO:
+			case T_PIT:
+			case T_CHECKPOINT:
+			case T_TRAPDOOR:
+				this->ObstacleMask[dwSquareI] = 0;	//particle can go through these things
+			break;
+			default:
+				this->ObstacleMask[dwSquareI] = 1;
+			break;
+		}
+	}
+}
+
+//
+//Private methods.
+//
+
+//*****************************************************************************
+CParticleSystem::PARTICLEBLOCK * CParticleSystem::FindBlock(const DWORD dwID)
+{
+	for (vector<PARTICLEBLOCK>::iterator iBlock = this->Blocks.begin();
+			iBlock != this->Blocks.end(); ++iBlock)
+		if (iBlock->dwID == dwID)
+			return &*iBlock;
+	return NULL;
+}
+
+//*****************************************************************************
+const CParticleSystem::PARTICLEBLOCK * CParticleSystem::FindBlock(const DWORD dwID)
+const
+{
+	for (vector<PARTICLEBLOCK>::const_iterator iBlock = this->Blocks.begin();
+			iBlock != this->Blocks.end(); ++iBlock)
+		if (iBlock->dwID == dwID)
+			return &*iBlock;
+	return NULL;
+}
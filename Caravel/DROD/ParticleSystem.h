@@ -0,0 +1,97 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is Deadly Rooms of Death.
+ *
+ * The Initial Developer of the Original Code is
+ * Caravel Software.
+ * Portions created by the Initial Developer are Copyright (C) 2005
+ * Caravel Software. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+
+//ParticleSystem.h
+//Declarations for CParticleSystem.
+//
+//CParticleSystem keeps the particles of every particle explosion effect in a
+//room widget.  Particles are stored as parallel arrays (one per field) so that
+//each effect's particles can be moved with tight loops over contiguous memory,
+//and they are tested against an obstacle mask of the room instead of looking
+//up room squares.
+
+#ifndef PARTICLESYSTEM_H
+#define PARTICLESYSTEM_H
+
+#include <BackEndLib/Types.h>
+
+#include <SDL.h>
+#include <vector>
+using std::vector;
+
+//How particles of one type are drawn.
+struct PARTICLESPRITE
+{
+	UINT wTileImageNo;
+	UINT wW, wH;	//part of the tile image to blit
+};
+
+class CDbRoom;
+class CParticleSystem
+{
+public:
+	CParticleSystem();
+
+	DWORD			AddParticles(const UINT wCount, const float fX, const float fY,
+			const int nXOffset, const int nXRange, const int nYOffset, const int nYRange,
+			const UINT wDuration, const UINT wMaxParticleSize);
+	void			DrawParticles(const DWORD dwID, const PARTICLESPRITE *pSprites,
+			SDL_Surface *pDestSurface) const;
+	UINT			GetParticleCount() const {return this->wLiveParticles;}
+	bool			MoveParticles(const DWORD dwID, const float fMultiplier,
+			SDL_Rect &rAreaOfEffect);
+	void			RemoveParticles(const DWORD dwID);
+	void			SetRoom(const CDbRoom *pRoom, const SDL_Rect &RoomRect);
+
+private:
+	//Particles added together by one effect.  They occupy wCapacity slots
+	//starting at wFirst, the first wCount of which are still live.
+	struct PARTICLEBLOCK
+	{
+		DWORD dwID;
+		UINT wFirst, wCount, wCapacity;
+		UINT wMaxParticleSize;
+	};
+
+	PARTICLEBLOCK *	FindBlock(const DWORD dwID);
+	const PARTICLEBLOCK *	FindBlock(const DWORD dwID) const;
+
+	//Particle fields.
+	vector<float>	x, y;		//position
+	vector<float>	mx, my;		//momentum
+	vector<Uint8>	wDurationLeft;
+	vector<Uint8>	type;		//sprite #
+
+	vector<PARTICLEBLOCK>	Blocks;
+	DWORD			dwLastID;
+	UINT			wLiveParticles;
+
+	//Room squares particles bounce off of, and where the room is on screen.
+	vector<Uint8>	ObstacleMask;
+	UINT			wMaskCols, wMaskRows;
+	SDL_Rect		RoomRect;
+};
+
+#endif //...#ifndef PARTICLESYSTEM_H
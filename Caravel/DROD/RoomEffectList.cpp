@@ -63,10 +63,18 @@ void CRoomEffectList::DirtyTilesForEffect(
 	CEffect *pEffect)
 const
 {
-	UINT xStart, yStart, xEnd, yEnd;
-	SDL_Rect rect;
+	DirtyTilesInArea(pEffect->GetAreaOfEffect());
+}
 
-	rect = pEffect->GetAreaOfEffect();
+//*****************************************************************************
+void CRoomEffectList::DirtyTilesInArea(
+//Dirties room tiles within an area of the screen.
+//
+//Params:
+	SDL_Rect rect)	//(in)	Area in screen coords.
+const
+{
+	UINT xStart, yStart, xEnd, yEnd;
 	if (rect.w || rect.h)
 	{
 		//Non-zero effect area -- dirty the tiles this effect covers.
@@ -124,7 +132,7 @@ void CRoomEffectList::RemoveEffectsOfType(
 	const UINT eEffectType)	//(in)	Type of effect to remove.
 {
 	//Clear list of given effect type.
-	list<CEffect *>::const_iterator iSeek = this->Effects.begin();
+	list<CEffect *>::iterator iSeek = this->Effects.begin();
 	while (iSeek != this->Effects.end())
 	{
 		if (eEffectType == (*iSeek)->GetEffectType())
@@ -132,8 +140,7 @@ void CRoomEffectList::RemoveEffectsOfType(
 			//Remove from list.
 			CEffect *pDelete = *iSeek;
 			DirtyTilesForEffect(pDelete);	//touch up area before deleting
-			++iSeek;
-			this->Effects.remove(pDelete);
+			iSeek = this->Effects.erase(iSeek);
 			delete pDelete;
 		}
 		else
@@ -39,6 +39,7 @@ public:
 	virtual void	Clear(const bool bRepaint=false);
 	void				DirtyTiles() const;
 	void				DirtyTilesForEffect(CEffect *pEffect) const;
+	void				DirtyTilesInArea(SDL_Rect rect) const;
 	void				DirtyTilesInRect(const UINT xStart, const UINT yStart,
 			const UINT xEnd, const UINT yEnd) const;
 	virtual void	RemoveEffectsOfType(const UINT eEffectType);
@@ -27,13 +27,16 @@
 #include "DrodBitmapManager.h"
 #include "DrodScreen.h"
 #include "NeatherStrikesOrbEffect.h"
+#include "ParticleSystem.h"
 #include "RoomEffectList.h"
 #include "StrikeOrbEffect.h"
 #include "TileImageCalcs.h"
 #include "TileImageConstants.h"
 #include <FrontEndLib/Bolt.h>
+#include <FrontEndLib/FontManager.h>
 #include <FrontEndLib/FrameRateEffect.h>
 #include <FrontEndLib/Pan.h>
+#include <FrontEndLib/ScreenManager.h>
 #include <FrontEndLib/ShadeEffect.h>
 
 #include "../DRODLib/CurrentGame.h"
@@ -47,6 +50,7 @@
 #include "../Texts/MIDs.h"
 #include <BackEndLib/Assert.h>
 #include <BackEndLib/Files.h>
+#include <BackEndLib/SysTimer.h>
 
 #define IS_COLROW_IN_DISP(c,r) \
 		(static_cast<UINT>(c) < CDrodBitmapManager::DISPLAY_COLS && \
@@ -74,6 +78,7 @@ CRoomWidget::CRoomWidget(
 
 	, dwRoomX(0L), dwRoomY(0L)
 	, wStyle((UINT)-1)
+	, dwPrefetchedLevelID(0L)
 	, wShowCol(0), wShowRow(0)
 
    , pCurrentGame(pSetCurrentGame)
@@ -87,7 +92,7 @@ CRoomWidget::CRoomWidget(
 	, bShowFrameRate(false)
 
 	, dwLastDrawSquareInfoUpdateCount(0L)
-   , dwLastAnimationFrame(SDL_GetTicks())
+   , dwLastAnimationFrame(GetAnimationTicks())
 
 	, bAllDirty(true)
 	, bWasPlacingMimic(false)
@@ -96,10 +101,13 @@ CRoomWidget::CRoomWidget(
 	, wLastOrientation(0), wLastX(0), wLastY(0)
 	, bLastRaised(false)
 
+	, pPaintTimes(NULL)
+
 	, CX_TILE(CBitmapManager::CX_TILE), CY_TILE(CBitmapManager::CY_TILE)
 {
    this->pLastLayerEffects = new CRoomEffectList(this);
 	this->pTLayerEffects = new CRoomEffectList(this);
+	this->pParticles = new CParticleSystem;
 }
 
 //*****************************************************************************
@@ -210,6 +218,7 @@ bool CRoomWidget::LoadFromCurrentGame(
 
 	//Load tile images.
 	if (!g_pTheDBM->LoadTileImagesForStyle(this->wStyle)) return false;
+	PrefetchLevelStyles();
 
 	//Set tile image arrays to new current room.
 	ResetForPaint();
@@ -254,7 +263,9 @@ void CRoomWidget::ShowRoomTransition(
 //Params:
 	const UINT wExitOrientation)	//(in) direction of exit
 {
-	if (IsValidOrientation(wExitOrientation) && wExitOrientation != NO_ORIENTATION)
+	//Nobody is watching a headless display, so just cut to the new room.
+	if (IsValidOrientation(wExitOrientation) && wExitOrientation != NO_ORIENTATION &&
+			!g_pTheSM->IsHeadless())
 	{
 		//Show a smooth transition between rooms.
 		PanDirection panDirection;
@@ -300,6 +311,7 @@ void CRoomWidget::ShowRoomTransition(
 				SDL_BlitSurface(pOldRoomSurface, &tempRect,
 						GetDestSurface(), &rect);
 				UpdateRect();
+				CEventHandlerWidget::FlushUpdateRects();
 				if (dwNow - dwStart > dwPanDuration)
 				{
 					//Done panning.
@@ -339,6 +351,7 @@ void CRoomWidget::UpdateFromCurrentGame()
 		this->wStyle = this->pRoom->wStyle;
 		if (!g_pTheDBM->LoadTileImagesForStyle(this->wStyle)) ASSERTP(false, "Failed to load tile images.");
 	}
+	PrefetchLevelStyles();
 
 	DirtyRoom();
 	if (this->dwRoomX != this->pRoom->dwRoomX ||
@@ -354,6 +367,25 @@ void CRoomWidget::UpdateFromCurrentGame()
 	}
 }
 
+//*****************************************************************************
+void CRoomWidget::PrefetchLevelStyles()
+//When a new level is entered, start decoding tile images for the other styles
+//used by its rooms, so that walking into one of them doesn't wait on the disk.
+{
+	ASSERT(this->pRoom);
+	if (this->pRoom->dwLevelID == this->dwPrefetchedLevelID) return;
+	this->dwPrefetchedLevelID = this->pRoom->dwLevelID;
+
+	vector<const CRoomMap *> Maps;
+	CDbRooms::GetMapsForLevel(this->dwPrefetchedLevelID, Maps);
+	for (vector<const CRoomMap *>::const_iterator iMap = Maps.begin();
+			iMap != Maps.end(); ++iMap)
+	{
+		if ((*iMap)->wStyle != this->wStyle)
+			g_pTheDBM->PrefetchTileImagesForStyle((*iMap)->wStyle);
+	}
+}
+
 //*****************************************************************************
 void CRoomWidget::UpdateFromPlots()
 //Refresh the tile image arrays after plots have been made.
@@ -627,8 +659,19 @@ void CRoomWidget::Paint(
 	if (this->pRoom != this->pCurrentGame->pRoom)
 		this->pRoom = this->pCurrentGame->pRoom;
 
+	//Timing of paint stages, when requested.
+	ULONGLONG qwMark = this->pPaintTimes ? GetPaintTicks() : 0;
+
 	SDL_Surface *pDestSurface = GetDestSurface();
 	const bool bPlayerIsAlive = !this->pCurrentGame->SwordsmanIsDying();
+
+	//What's on screen has to match what the room thinks it has drawn, or later
+	//paints of only dirty tiles would leave stale frames.  So the room always
+	//paints whole tiles unclipped.  PaintClipped() dirties just the tiles
+	//under its rect instead.
+	SDL_Rect OldClipRect;
+	SDL_GetClipRect(pDestSurface, &OldClipRect);
+	SDL_SetClipRect(pDestSurface, NULL);
 	const bool bIsPlacingMimic = this->pCurrentGame->swordsman.bIsPlacingMimic;
 	const UINT wTurn = this->pCurrentGame->wSpawnCycleCount;
 	TILEINFO *pbMI;
@@ -672,6 +715,7 @@ void CRoomWidget::Paint(
 		//Redraw all tiles that have changed.
 		BlitDirtyRoomTiles();
 	}
+	PaintStageDone(&ROOMPAINTTIMES::qwTiles, qwMark);
 
 	//2. Draw mimic cursor only.
 	//(The action is frozen and everything else has been drawn already.)
@@ -685,6 +729,7 @@ void CRoomWidget::Paint(
 		{
 			//3a. Draw effects that go on top of room image, under monsters/swordsman.
 			this->pTLayerEffects->DrawEffects();
+			PaintStageDone(&ROOMPAINTTIMES::qwEffects, qwMark);
 
 			//3b. Repaint player/monsters.
 			if (this->bAllDirty)
@@ -765,9 +810,11 @@ void CRoomWidget::Paint(
          }
 		}
 	}
+	PaintStageDone(&ROOMPAINTTIMES::qwMonsters, qwMark);
 
 	//6. Draw effects that go on top of everything else drawn in the room.
 	this->pLastLayerEffects->DrawEffects();
+	PaintStageDone(&ROOMPAINTTIMES::qwEffects, qwMark);
 
 	//Everything should have been (re)painted by now.
 	//Undirty all the tiles.
@@ -777,22 +824,61 @@ void CRoomWidget::Paint(
 			CDrodBitmapManager::DISPLAY_ROWS * CDrodBitmapManager::DISPLAY_COLS;
 	while (pbMI != pbMIStop)
 		(pbMI++)->dirty = 0;
+	SDL_SetClipRect(pDestSurface, &OldClipRect);
 
 	//Paint widget children on top of everything.
 	PaintChildren();
+	PaintStageDone(&ROOMPAINTTIMES::qwChildren, qwMark);
+	if (this->pPaintTimes)
+		++this->pPaintTimes->dwPaints;
 
 	//Put it up on the screen.
 	if (bUpdateRect) UpdateRect();
 }
 
 //*****************************************************************************
-void CRoomWidget::PaintClipped(int /*nX*/, int /*nY*/, UINT /*wW*/, UINT /*wH*/,
-		const bool /*bUpdateRect*/)
+ULONGLONG CRoomWidget::GetPaintTicks()
+//Returns:
+//A microsecond clock for timing paint stages.  It stands still while the font
+//manager renders text, which it times separately.
+const
+{
+	return GetMicroTicks() - g_pTheFM->GetRenderTime();
+}
+
+//*****************************************************************************
+void CRoomWidget::PaintStageDone(
+//Adds the time since the last stage of Paint() ended to a stage's total, when
+//paint timings are requested.
+//
+//Params:
+	ULONGLONG ROOMPAINTTIMES::*pqwStage,	//(in)	Stage's total in pPaintTimes.
+	ULONGLONG &qwMark)	//(in/out)	When the last stage ended.  Set to now.
+const
+{
+	if (!this->pPaintTimes) return;
+	const ULONGLONG qwNow = GetPaintTicks();
+	this->pPaintTimes->*pqwStage += qwNow - qwMark;
+	qwMark = qwNow;
+}
+
+//*****************************************************************************
+void CRoomWidget::PaintClipped(
+//Repaints the room under a rect.  Paint() uses direct access to pixels, so it
+//can't be clipped with SDL_SetClipRect().  Instead the room tiles under the
+//rect are dirtied and repainted whole.
+//
+//Params:
+	const int nX, const int nY,	//(in)	Rect to repaint, in screen coords.
+	const UINT wW, const UINT wH,
+	const bool bUpdateRect)			//(in)	If true (default) and destination
+										//		surface is the screen, the screen
+										//		will be immediately updated in
+										//		the widget's rect.
 {
-	//Paint() uses direct access to pixels, so it can't be clipped with
-	//SDL_SetClipRect().  Either you need to write PaintClipped() or change
-	//the situation which causes this widget to be clipped.
-	ASSERTP(false, "Can't paint clipped.");
+	SDL_Rect rect = {nX, nY, wW, wH};
+	this->pLastLayerEffects->DirtyTilesInArea(rect);
+	Paint(bUpdateRect);
 }
 
 //*****************************************************************************
@@ -854,6 +940,7 @@ CRoomWidget::~CRoomWidget()
 	ASSERT(!this->bIsLoaded);
    delete this->pLastLayerEffects;
 	delete this->pTLayerEffects;
+	delete this->pParticles;	//after the effects using it
 }
 
 //*****************************************************************************
@@ -1231,7 +1318,7 @@ void CRoomWidget::AnimateMonsters()
 	UINT wX, wY;
 
 	//Animate monsters in real time.
-	const Uint32 dwNow=SDL_GetTicks();
+	const Uint32 dwNow=GetAnimationTicks();
 	Uint32 dwTimeElapsed = dwNow - this->dwLastAnimationFrame;
 	if (dwTimeElapsed==0)
 		dwTimeElapsed=1;
@@ -1693,6 +1780,11 @@ bool CRoomWidget::UpdateDrawSquareInfo()
 		this->bAllDirty = true;
 	}
 
+	//Particles bounce off of the room's current obstacles.
+	SDL_Rect rect;
+	GetRect(rect);
+	this->pParticles->SetRoom(this->pRoom, rect);
+
 	//Set tile image elements of arrays.
 	UINT *pwO = this->pwOSquareTI;
 	UINT *pwT = this->pwTSquareTI;
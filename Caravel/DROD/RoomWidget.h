@@ -69,11 +69,27 @@ typedef struct {
 	BYTE sword : 1;	//there is a sword here
 } TILEINFO;
 
+//Time spent in each stage of CRoomWidget::Paint(), in microseconds.
+struct ROOMPAINTTIMES {
+	ROOMPAINTTIMES() :
+		dwPaints(0L),
+		qwTiles(0), qwMonsters(0), qwEffects(0), qwChildren(0)
+	{}
+
+	DWORD dwPaints;
+	ULONGLONG qwTiles;		//room image and dirty tile repaints
+	ULONGLONG qwMonsters;	//monsters, swordsman and mimic cursor
+	ULONGLONG qwEffects;		//both effect layers
+	ULONGLONG qwChildren;	//child widgets
+	//Text the font manager renders is timed by it, and left out of these.
+};
+
 //******************************************************************************
 class CCurrentGame;
 class CEffect;
 class CMimic;
 class CNeather;
+class CParticleSystem;
 class CRoomEffectList;
 class CRoomWidget : public CWidget
 {
@@ -108,6 +124,8 @@ public:
 	void				ResetForPaint();
    void           ResetRoom() {this->pRoom = NULL;}
 	void				ShowCheckpoints() {this->bShowCheckpoints = true;}
+	void				SetPaintTimes(ROOMPAINTTIMES *pSetPaintTimes)
+			{this->pPaintTimes = pSetPaintTimes;}
 	void				ShowRoomTransition(const UINT wExitOrientation);
 	void				ShowSwordsman() {this->bShowingSwordsman = true;}
 	void				ShowFrameRate();
@@ -116,6 +134,7 @@ public:
 	void				UpdateFromPlots();
 
 	const CCurrentGame * GetCurrentGame() {return pCurrentGame;}
+	CParticleSystem *	GetParticleSystem() const {return this->pParticles;}
 
 	SDL_Surface *	pRoomSnapshotSurface;	//image of the pre-rendered room
 
@@ -176,10 +195,15 @@ protected:
 	void				DrawTileImage(const UINT wCol, const UINT wRow,
 			const UINT wTileImageNo, const bool bDrawRaised,
 			SDL_Surface *pDestSurface, const Uint8 nOpacity=255);
+	ULONGLONG		GetPaintTicks() const;
+	void				PaintStageDone(ULONGLONG ROOMPAINTTIMES::*pqwStage,
+			ULONGLONG &qwMark) const;
+	void				PrefetchLevelStyles();
 	bool				UpdateDrawSquareInfo();
 
 	DWORD					dwRoomX, dwRoomY;
 	UINT					wStyle;
+	DWORD					dwPrefetchedLevelID;
 	UINT					wShowCol, wShowRow;
 
 	const CCurrentGame *	pCurrentGame;	//to show room of a game in progress
@@ -191,6 +215,7 @@ protected:
 
 	CRoomEffectList *		pLastLayerEffects;
 	CRoomEffectList *		pTLayerEffects;
+	CParticleSystem *		pParticles;	//particles of all particle explosion effects
 
 	SDL_Surface *			pBoltPartsSurface;
 
@@ -214,6 +239,8 @@ protected:
 
 	CCoordStack 		lastSwordCoords;
 
+	ROOMPAINTTIMES *	pPaintTimes;	//if set, Paint() adds its timings here
+
    int					CX_TILE, CY_TILE;
 };
 
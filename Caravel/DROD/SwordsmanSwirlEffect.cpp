@@ -78,7 +78,7 @@ bool CSwordsmanSwirlEffect::Draw(SDL_Surface* pDestSurface)
    if (!pDestSurface)
 	   pDestSurface = GetDestSurface();
 
-   const Uint32 dwNow = SDL_GetTicks();
+   const Uint32 dwNow = GetAnimationTicks();
 	const Uint32 dwTimeElapsed = dwNow - this->dwTimeStarted;
 	
 	//Get swordsman's position.
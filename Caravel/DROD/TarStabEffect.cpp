@@ -49,18 +49,9 @@ bool CTarStabEffect::Draw(SDL_Surface* pDestSurface)
 	if (!MoveParticles())
 		return false;
 
-   if (!pDestSurface)
-      pDestSurface = GetDestSurface();
-
-   for (int nIndex=wParticleCount; nIndex--; )
-		//If particle is still active, plot to display.
-		if (parrParticles[nIndex].bActive)
-			if (parrParticles[nIndex].type)
-				g_pTheBM->BlitTileImagePart(TI_TARBLOOD_2, ROUND(parrParticles[nIndex].x),
-						ROUND(parrParticles[nIndex].y), 5, 5, pDestSurface);
-			else
-				g_pTheBM->BlitTileImagePart(TI_TARBLOOD_1, ROUND(parrParticles[nIndex].x),
-						ROUND(parrParticles[nIndex].y), 4, 4, pDestSurface);
+	static const PARTICLESPRITE sprites[2] = {
+		{TI_TARBLOOD_1, 4, 4}, {TI_TARBLOOD_2, 5, 5}};
+	DrawParticles(sprites, pDestSurface);
 
 	return true;
 }
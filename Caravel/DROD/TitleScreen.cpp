@@ -279,8 +279,10 @@ void CTitleScreen::OnKeyDown(
 	HighlightMenuItem(wSetPos);
 	g_pTheSound->PlaySoundEffect(SEID_TITLEBUTTON);
 	DrawPushedBrick(wSetPos);
+	FlushUpdateRects();
 	SDL_Delay(200);
 	DrawBrick(wSetPos);
+	FlushUpdateRects();
 	SDL_Delay(50);
 
 	SCREENTYPE eNextScreen = ProcessMenuSelection(wSetPos);
@@ -328,8 +330,10 @@ void CTitleScreen::OnMouseUp(
 		//Show brick being pushed.
 		g_pTheSound->PlaySoundEffect(SEID_TITLEBUTTON);
 		DrawPushedBrick(wSelectedPos);
+		FlushUpdateRects();
 		SDL_Delay(200);
 		DrawBrick(wSelectedPos);
+		FlushUpdateRects();
 		SDL_Delay(50);
 
 		SCREENTYPE eNextScreen = ProcessMenuSelection(this->wSelectedPos);
@@ -2765,7 +2765,8 @@ void CCurrentGame::SetRoomStartToSwordsman()
 
 //***************************************************************************************
 void CCurrentGame::CalcPathMaps()
-//Calculate PathMaps for each movement ability type.
+//Calculate PathMaps for each movement ability type.  Paths are calculated
+//as monsters query them, only as far from the swordsman as they need.
 //
 //NOTE: Should only need to be done when a brain can sense the swordsman and
 //provide monsters with smart movement information.
@@ -2773,9 +2774,9 @@ void CCurrentGame::CalcPathMaps()
    this->bBrainSensesSwordsman = this->pRoom->BrainSensesSwordsman();
    if (this->bBrainSensesSwordsman)
    {
-	   for (int n=0; n<NumMovementTypes; n++)
-		   if (this->pRoom->pPathMap[n])
-			   this->pRoom->pPathMap[n]->CalcPaths();
+	   //One wavefront calculates every movement type's paths.
+	   if (this->pRoom->pPathMap)
+		   this->pRoom->pPathMap->RequestPaths();
    }
 }
 
@@ -2820,9 +2821,8 @@ void CCurrentGame::SetPathMapsTarget(
 	const UINT wX, const UINT wY)	//(in) Target for each pathmaps
 {
 	POINT p = {wX, wY};
-	for (int n=0; n<NumMovementTypes; n++)
-		if (this->pRoom->pPathMap[n])
-			this->pRoom->pPathMap[n]->SetTarget(p);
+	if (this->pRoom->pPathMap)
+		this->pRoom->pPathMap->SetTarget(p);
 }
 
 //***************************************************************************************
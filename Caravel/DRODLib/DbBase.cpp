@@ -30,6 +30,7 @@
 
 #include "DbBase.h"
 #include "DBProps.h"
+#include "DbRooms.h"
 #include "GameConstants.h"
 #include "../Texts/MIDs.h"
 #include <BackEndLib/Files.h>
@@ -202,6 +203,9 @@ void CDbBase::Rollback()
     m_pHoldStorage->Rollback();
     m_pPlayerStorage->Rollback();
     m_pTextStorage->Rollback();
+
+    //Cached room maps may no longer match the rooms.
+    CDbRooms::ForgetMaps();
 }
 
 //*****************************************************************************
@@ -319,6 +323,8 @@ MESSAGE_ID CDbBase::Open(
 void CDbBase::Close(const bool bCommit)   //Commit before closing (default).
 //Closes database files.
 {
+	CDbRooms::ForgetMaps();
+
 	//Close hold database.
 	if (m_pHoldStorage)
    {
@@ -37,10 +37,24 @@
 #include <BackEndLib/Base64.h>
 #include <BackEndLib/Ports.h>
 
+#include <map>
+using std::map;
+
+//Map squares of rooms that have been drawn on a level map, by room ID.
+//An entry is dropped whenever its room is written to or deleted.
+static map<DWORD, CRoomMap *> m_RoomMaps;
+
 //Macros.
 //Uniform way of accessing 2D information in 1D array (column-major).
 #define ARRAYINDEX(x,y)	(((y) * this->wRoomCols) + (x))
 
+//Door component of a square that isn't part of a yellow door.
+const UINT NO_DOOR_COMPONENT = (UINT)-1;
+const UINT NO_ROOM_OBJECT = (UINT)-1;
+
+//Rows of a column held in each word of the bitboards used by GrowTar().
+const UINT TAR_WORD_BITS = 32;
+
 //
 //CDbRooms public methods.
 //
@@ -94,6 +108,7 @@ void CDbRooms::Delete(
 
 	//Delete the room.
 	RoomsView.RemoveAt(dwRoomRowI);
+	ForgetMap(dwRoomID);
 
 	//After room object is deleted, membership might change, so reset the flag.
 	this->bIsMembershipLoaded = false;
@@ -368,6 +383,80 @@ DWORD CDbRooms::FindIDAtCoords(
 	return 0;
 }
 
+//*****************************************************************************
+const CRoomMap * CDbRooms::GetMap(
+//Gets the map squares of a room.  Only the squares are unpacked, and only the
+//first time a room is asked for.
+//
+//Params:
+	const DWORD dwRoomID)	//(in)	Room to get.
+//
+//Returns:
+//Pointer to cached map squares, or NULL if the room doesn't exist.
+{
+	map<DWORD, CRoomMap *>::const_iterator iMap = m_RoomMaps.find(dwRoomID);
+	if (iMap != m_RoomMaps.end())
+		return iMap->second;
+
+	ASSERT(IsOpen());
+	c4_View RoomsView = GetView(ViewTypeStr(V_Rooms));
+	const DWORD dwRoomI = LookupRowByPrimaryKey(dwRoomID, p_RoomID, RoomsView);
+	if (dwRoomI == ROW_NO_MATCH) return NULL;
+	return LoadMap(RoomsView, dwRoomI);
+}
+
+//*****************************************************************************
+void CDbRooms::GetMapsForLevel(
+//Gets the map squares of every room in a level.
+//
+//Params:
+	const DWORD dwLevelID,				//(in)	Level to get rooms for.
+	vector<const CRoomMap *> &Maps)	//(out)	Cached map squares of its rooms.
+{
+	ASSERT(IsOpen());
+	c4_View RoomsView = GetView(ViewTypeStr(V_Rooms));
+	const DWORD dwRoomCount = RoomsView.GetSize();
+
+	Maps.clear();
+	for (DWORD dwRoomI = 0; dwRoomI < dwRoomCount; ++dwRoomI)
+	{
+		if (dwLevelID != (DWORD) p_LevelID(RoomsView[dwRoomI]))
+			continue;
+
+		const DWORD dwRoomID = (DWORD) p_RoomID(RoomsView[dwRoomI]);
+		map<DWORD, CRoomMap *>::const_iterator iMap = m_RoomMaps.find(dwRoomID);
+		const CRoomMap *pMap = iMap != m_RoomMaps.end() ? iMap->second :
+				LoadMap(RoomsView, dwRoomI);
+		if (pMap)
+			Maps.push_back(pMap);
+	}
+}
+
+//*****************************************************************************
+void CDbRooms::ForgetMap(
+//Drops a room's cached map squares, so they are read again next time.
+//
+//Params:
+	const DWORD dwRoomID)	//(in)	Room that changed.
+{
+	map<DWORD, CRoomMap *>::iterator iMap = m_RoomMaps.find(dwRoomID);
+	if (iMap != m_RoomMaps.end())
+	{
+		delete iMap->second;
+		m_RoomMaps.erase(iMap);
+	}
+}
+
+//*****************************************************************************
+void CDbRooms::ForgetMaps()
+//Drops all cached map squares.
+{
+	for (map<DWORD, CRoomMap *>::iterator iMap = m_RoomMaps.begin();
+			iMap != m_RoomMaps.end(); ++iMap)
+		delete iMap->second;
+	m_RoomMaps.clear();
+}
+
 //*****************************************************************************
 CDbRoom * CDbRooms::GetNew()
 //Get a new room object that will be added to database when it is updated.
@@ -426,6 +515,252 @@ void CDbRooms::LoadMembership()
 	this->bIsMembershipLoaded = true;
 }
 
+//*****************************************************************************
+CRoomMap * CDbRooms::LoadMap(
+//Reads a room's coords, style and squares into the map cache.
+//
+//Params:
+	c4_View &RoomsView,		//(in)	Rooms view.
+	const DWORD dwRoomI)	//(in)	Row of room to read.
+//
+//Returns:
+//Pointer to new cache entry, or NULL if the squares couldn't be read.
+{
+	CRoomMap *pMap = new CRoomMap;
+	pMap->dwRoomID = (DWORD) p_RoomID(RoomsView[dwRoomI]);
+	pMap->dwLevelID = (DWORD) p_LevelID(RoomsView[dwRoomI]);
+	pMap->dwRoomX = (DWORD) p_RoomX(RoomsView[dwRoomI]);
+	pMap->dwRoomY = (DWORD) p_RoomY(RoomsView[dwRoomI]);
+	pMap->wRoomCols = (UINT) p_RoomCols(RoomsView[dwRoomI]);
+	pMap->wRoomRows = (UINT) p_RoomRows(RoomsView[dwRoomI]);
+	pMap->wStyle = (UINT) p_Style(RoomsView[dwRoomI]);
+
+	const DWORD dwSquareCount = pMap->wRoomCols * pMap->wRoomRows;
+	char *pszOSquares = new char[dwSquareCount + 1];
+	char *pszTSquares = new char[dwSquareCount + 1];
+	c4_Bytes SquaresBytes = p_Squares(RoomsView[dwRoomI]);
+	const bool bSuccess = CDbRoom::UnpackSquares(SquaresBytes.Contents(),
+			SquaresBytes.Size(), dwSquareCount, pszOSquares, pszTSquares);
+	if (bSuccess)
+		pMap->SetTiles(pszOSquares, pszTSquares, dwSquareCount);
+	delete[] pszOSquares;
+	delete[] pszTSquares;
+
+	if (!bSuccess)
+	{
+		delete pMap;
+		return NULL;
+	}
+	m_RoomMaps[pMap->dwRoomID] = pMap;
+	return pMap;
+}
+
+//
+//CTileSquares public methods.
+//
+
+//*****************************************************************************
+void CTileSquares::Build(
+//Indexes the squares of a room by tile.
+//
+//Params:
+	const char *pszOSquares, const char *pszTSquares,	//(in)	Room squares.
+	const UINT wSquareCount)	//(in)	Number of squares in room.
+{
+	Clear();
+	this->Positions[0].resize(wSquareCount);
+	this->Positions[1].resize(wSquareCount);
+	for (UINT wSquareI = 0; wSquareI < wSquareCount; ++wSquareI)
+	{
+		Add(wSquareI, (unsigned char)pszOSquares[wSquareI]);
+		Add(wSquareI, (unsigned char)pszTSquares[wSquareI]);
+	}
+	this->bBuilt = true;
+}
+
+//*****************************************************************************
+void CTileSquares::Clear()
+//Forgets all squares.
+{
+	for (UINT wTileNo = 0; wTileNo < TILE_COUNT; ++wTileNo)
+		this->Squares[wTileNo].clear();
+	this->Positions[0].clear();
+	this->Positions[1].clear();
+	this->bBuilt = false;
+}
+
+//*****************************************************************************
+void CTileSquares::Replace(
+//Updates the index for a tile being plotted over another on the same layer.
+//
+//Params:
+	const UINT wSquareI,		//(in)	Square plotted to.
+	const UINT wOldTileNo,	//(in)	Tile that was there.
+	const UINT wNewTileNo)	//(in)	Tile now there.
+{
+	ASSERT(this->bBuilt);
+	ASSERT(TILE_LAYER[wOldTileNo] == TILE_LAYER[wNewTileNo]);
+	if (wOldTileNo == wNewTileNo) return;
+	Remove(wSquareI, wOldTileNo);
+	Add(wSquareI, wNewTileNo);
+}
+
+//
+//CTileSquares private methods.
+//
+
+//*****************************************************************************
+void CTileSquares::Add(const UINT wSquareI, const UINT wTileNo)
+{
+	ASSERT(wTileNo < TILE_COUNT);
+	vector<UINT> &TileSquares = this->Squares[wTileNo];
+	this->Positions[TILE_LAYER[wTileNo]][wSquareI] = TileSquares.size();
+	TileSquares.push_back(wSquareI);
+}
+
+//*****************************************************************************
+void CTileSquares::Remove(const UINT wSquareI, const UINT wTileNo)
+//Removes a square from a tile's squares by moving the last one into its place.
+{
+	ASSERT(wTileNo < TILE_COUNT);
+	vector<UINT> &TileSquares = this->Squares[wTileNo];
+	vector<UINT> &LayerPositions = this->Positions[TILE_LAYER[wTileNo]];
+	const UINT wPos = LayerPositions[wSquareI];
+	ASSERT(wPos < TileSquares.size() && TileSquares[wPos] == wSquareI);
+	const UINT wLastSquareI = TileSquares.back();
+	TileSquares[wPos] = wLastSquareI;
+	LayerPositions[wLastSquareI] = wPos;
+	TileSquares.pop_back();
+}
+
+//
+//CSightLines public methods.
+//
+
+//*****************************************************************************
+void CSightLines::Build(
+//Finds how far sight reaches from every square of a room in each direction.
+//
+//Params:
+	const char *pszOSquares, const char *pszTSquares,	//(in)	Room squares.
+	const UINT wCols, const UINT wRows)	//(in)	Room size.
+{
+	this->wCols = wCols;
+	this->wRows = wRows;
+	this->Distances.assign(ORIENTATION_COUNT * wCols * wRows, 0);
+
+	//Each square's distance follows from its neighbor's, so work back from the
+	//edge the direction points at.
+	for (UINT wO = 0; wO < ORIENTATION_COUNT; ++wO)
+	{
+		if (wO == NO_ORIENTATION) continue;
+		const int dx = nGetOX(wO), dy = nGetOY(wO);
+		for (UINT wRow = 0; wRow < wRows; ++wRow)
+		{
+			const UINT y = dy > 0 ? wRows - 1 - wRow : wRow;
+			for (UINT wCol = 0; wCol < wCols; ++wCol)
+			{
+				const UINT x = dx > 0 ? wCols - 1 - wCol : wCol;
+				this->Distances[(wO * wRows + y) * wCols + x] =
+						CalcClearDistance(pszOSquares, pszTSquares, x, y, wO);
+			}
+		}
+	}
+	this->bBuilt = true;
+}
+
+//*****************************************************************************
+void CSightLines::Clear()
+//Forgets all distances.
+{
+	this->Distances.clear();
+	this->bBuilt = false;
+}
+
+//*****************************************************************************
+bool CSightLines::IsSightBlocker(
+//Returns: whether a square with these tiles blocks sight.
+//
+//Params:
+	const UINT wOTileNo, const UINT wTTileNo)	//(in)	Tiles on the square.
+{
+	switch (wOTileNo)
+	{
+		case T_FLOOR:
+		case T_CHECKPOINT:
+		case T_PIT:
+		case T_DOOR_YO:
+		case T_TRAPDOOR:
+			return wTTileNo == T_ORB;
+		default:
+			return true;
+	}
+}
+
+//*****************************************************************************
+void CSightLines::Update(
+//Updates distances for a square having been plotted to.  Only lines of sight
+//running through the square can change, and each is followed back only as far
+//as its distances change.
+//
+//Params:
+	const char *pszOSquares, const char *pszTSquares,	//(in)	Room squares.
+	const UINT wX, const UINT wY)	//(in)	Square plotted to.
+{
+	ASSERT(this->bBuilt);
+	for (UINT wO = 0; wO < ORIENTATION_COUNT; ++wO)
+	{
+		if (wO == NO_ORIENTATION) continue;
+		const int dx = nGetOX(wO), dy = nGetOY(wO);
+		for (UINT x = wX - dx, y = wY - dy; x < this->wCols && y < this->wRows;
+				x -= dx, y -= dy)
+		{
+			USHORT &wDistance = this->Distances[(wO * this->wRows + y) * this->wCols + x];
+			const UINT wNewDistance = CalcClearDistance(pszOSquares, pszTSquares, x, y, wO);
+			if (wDistance == wNewDistance) break;
+			wDistance = wNewDistance;
+		}
+	}
+}
+
+//
+//CSightLines private methods.
+//
+
+//*****************************************************************************
+UINT CSightLines::CalcClearDistance(
+//Returns: number of squares in a row past a square that don't block sight, from
+//the distance already found for the next square.
+//
+//Params:
+	const char *pszOSquares, const char *pszTSquares,	//(in)	Room squares.
+	const UINT wX, const UINT wY, const UINT wO)	//(in)	Square and direction.
+const
+{
+	const UINT x = wX + nGetOX(wO), y = wY + nGetOY(wO);
+	if (x >= this->wCols || y >= this->wRows)
+		return 0;
+	const UINT wSquareI = y * this->wCols + x;
+	if (IsSightBlocker((unsigned char)pszOSquares[wSquareI],
+			(unsigned char)pszTSquares[wSquareI]))
+		return 0;
+	return this->Distances[wO * this->wCols * this->wRows + wSquareI] + 1;
+}
+
+//*****************************************************************************
+void CRoomMap::SetTiles(
+//Sets map squares from a room's squares.
+//
+//Params:
+	const char *pszOSquares, const char *pszTSquares,	//(in)	Room squares.
+	const DWORD dwSquareCount)						//(in)	Number of squares.
+{
+	this->Tiles.resize(dwSquareCount);
+	for (DWORD dwSquareI = 0; dwSquareI < dwSquareCount; ++dwSquareI)
+		this->Tiles[dwSquareI] = (unsigned char) pszTSquares[dwSquareI] == T_TAR ?
+				T_TAR : (BYTE) pszOSquares[dwSquareI];
+}
+
 //*****************************************************************************
 CDbRoom::CDbRoom(CDbRoom &Src)
 	//Set pointers to NULL so Clear() won't try to delete them.
@@ -435,12 +770,10 @@ CDbRoom::CDbRoom(CDbRoom &Src)
 	, pFirstMonster(NULL), pLastMonster(NULL)
 	, pMonsterSquares(NULL)
 	, parrScrolls(NULL)
+	, pPathMap(NULL)
    , pCurrentGame(NULL)
 //Constructor.
 {
-	for (int n=0; n<NumMovementTypes; n++)
-		this->pPathMap[n]=NULL;
-
    SetMembers(Src);
 }
 
@@ -457,12 +790,10 @@ CDbRoom::CDbRoom()
 	, pFirstMonster(NULL), pLastMonster(NULL)
 	, pMonsterSquares(NULL)
 	, parrScrolls(NULL)
+	, pPathMap(NULL)
    , pCurrentGame(NULL)
 //Constructor.
 {
-	for (int n=0; n<NumMovementTypes; n++)
-		this->pPathMap[n]=NULL;
-
 	Clear();
 }
 
@@ -1027,6 +1358,7 @@ bool CDbRoom::Update()
 	}
 
 	if (!bSuccess) return false;
+	CDbRooms::ForgetMap(this->dwRoomID);
 
 	//Filter demos to show demos for the current room only.
 	this->Demos.FilterByRoom(this->dwRoomID);
@@ -1203,6 +1535,12 @@ void CDbRoom::KillMonster(
 	if (pMonster->pNext) pMonster->pNext->pPrevious = pMonster->pPrevious;
 	if (pMonster == this->pLastMonster) this->pLastMonster = pMonster->pPrevious;
 	if (pMonster == this->pFirstMonster) this->pFirstMonster = pMonster->pNext;
+	if (pMonster->pPreviousOfType)
+		pMonster->pPreviousOfType->pNextOfType = pMonster->pNextOfType;
+	else
+		this->pFirstMonsterOfType[pMonster->wType] = pMonster->pNextOfType;
+	if (pMonster->pNextOfType)
+		pMonster->pNextOfType->pPreviousOfType = pMonster->pPreviousOfType;
 	
 	if (pMonster->wType != M_MIMIC)
 	{
@@ -1386,6 +1724,14 @@ void CDbRoom::LinkMonster(
 		}
 	}
 
+	//Add monster to list of its type.
+	ASSERT(IsValidMonsterType(pMonster->wType));
+	CMonster *&pFirstOfType = this->pFirstMonsterOfType[pMonster->wType];
+	pMonster->pPreviousOfType = NULL;
+	pMonster->pNextOfType = pFirstOfType;
+	if (pFirstOfType) pFirstOfType->pPreviousOfType = pMonster;
+	pFirstOfType = pMonster;
+
 	//Set monster array pointer.
 	ASSERT(!this->pMonsterSquares[ARRAYINDEX(pMonster->wX,pMonster->wY)]);
 	this->pMonsterSquares[ARRAYINDEX(pMonster->wX,pMonster->wY)] = pMonster;
@@ -1393,18 +1739,38 @@ void CDbRoom::LinkMonster(
 
 //*****************************************************************************
 void CDbRoom::LinkMonsterSegments()
-//Link long monster segments to monster object.
+//Link long monster segments to monster object, following each serpent's body
+//from its head to its tail.
 {
-	CMonster *pMonster;
-	UINT wX, wY;
-	for (wY=0; wY<this->wRoomRows; ++wY)
-		for (wX=0; wX<this->wRoomCols; ++wX)
-			if (bIsSerpent(GetTSquare(wX,wY)))
+	for (CMonster *pMonster = this->pFirstMonsterOfType[M_SERPENT]; pMonster != NULL;
+			pMonster = pMonster->pNextOfType)
+	{
+		UINT wX = pMonster->wX, wY = pMonster->wY;
+		int dx = -(int)nGetOX(pMonster->wO);
+		int dy = -(int)nGetOY(pMonster->wO);
+		int t;
+		bool bDone = false;
+		for (DWORD dwSegments = CalcRoomArea(); !bDone && dwSegments--; )
+		{
+			wX += dx;
+			wY += dy;
+			if (!IsValidColRow(wX,wY)) break;
+			const UINT tile = GetTSquare(wX, wY);
+			if (!bIsSerpent(tile)) break;
+
+			ASSERT(!this->pMonsterSquares[ARRAYINDEX(wX,wY)]);
+			this->pMonsterSquares[ARRAYINDEX(wX,wY)] = pMonster;
+
+			//Go to next piece.
+			switch (tile)
 			{
-				pMonster = FindLongMonster(wX,wY);
-				ASSERT(!this->pMonsterSquares[ARRAYINDEX(wX,wY)]);
-				this->pMonsterSquares[ARRAYINDEX(wX,wY)] = pMonster;
+				case T_SNK_EW: case T_SNK_NS: break;
+				case T_SNK_NW: case T_SNK_SE: t = dx; dx = -dy; dy = -t; break;
+				case T_SNK_NE: case T_SNK_SW: t = dx; dx = dy; dy = t; break;
+				default: bDone = true; break;	//tail tiles
 			}
+		}
+	}
 }
 
 //*****************************************************************************
@@ -1525,18 +1891,15 @@ const
 {
 	//Check mimic swords.
 	UINT wSX, wSY;
-	CMonster *pSeek = this->pFirstMonster;
+	CMonster *pSeek = this->pFirstMonsterOfType[M_MIMIC];
 	while (pSeek)
 	{
-		if (pSeek->wType == M_MIMIC)
-		{
-			CMimic *pMimic = DYN_CAST(CMimic*, CMonster*, pSeek);
-			wSX = pMimic->GetSwordX();
-			wSY = pMimic->GetSwordY();
-			if (wMinX <= wSX && wSX <= wMaxX && wMinY <= wSY && wSY <= wMaxY)
-				return true;
-		}
-		pSeek = pSeek->pNext;
+		CMimic *pMimic = DYN_CAST(CMimic*, CMonster*, pSeek);
+		wSX = pMimic->GetSwordX();
+		wSY = pMimic->GetSwordY();
+		if (wMinX <= wSX && wSX <= wMaxX && wMinY <= wSY && wSY <= wMaxY)
+			return true;
+		pSeek = pSeek->pNextOfType;
 	}
 
 	//Check player's sword.
@@ -1559,15 +1922,12 @@ bool CDbRoom::BrainSensesSwordsman() const
    if (!IsBrainPresent()) return false;
 	if (this->pCurrentGame->swordsman.bIsVisible) return true;
 
-   CMonster *pMonster = this->pFirstMonster;
+   CMonster *pMonster = this->pFirstMonsterOfType[M_BRAIN];
 	while (pMonster)
 	{
-		if (pMonster->wType == M_BRAIN)
-		{
-         if (pMonster->CanFindSwordsman())
-            return true;
-      }
-		pMonster = pMonster->pNext;
+      if (pMonster->CanFindSwordsman())
+         return true;
+		pMonster = pMonster->pNextOfType;
    }
 
    return false;
@@ -1626,13 +1986,11 @@ COrbData * CDbRoom::GetOrbAtCoords(
 //Pointer to found orb or NULL if no match.
 const
 {
-	for (UINT wOrbI=0; wOrbI < this->wOrbCount; wOrbI++)
-	{
-		if (this->parrOrbs[wOrbI].wX == wX &&
-				this->parrOrbs[wOrbI].wY == wY)
-			return &(this->parrOrbs[wOrbI]);
-	}
-	return NULL;
+	if (!IsValidColRow(wX, wY)) return NULL;
+	if (this->bObjectSquaresDirty) IndexObjectSquares();
+
+	const UINT wOrbI = this->OrbSquares[ARRAYINDEX(wX,wY)];
+	return wOrbI == NO_ROOM_OBJECT ? NULL : this->parrOrbs + wOrbI;
 }
 
 //*****************************************************************************
@@ -1646,13 +2004,12 @@ const WCHAR *	CDbRoom::GetScrollTextAtSquare(
 //Pointer to text of scroll or NULL if no match.
 const
 {
-	for (UINT wScrollI=0; wScrollI < this->wScrollCount; wScrollI++)
-	{
-		if (this->parrScrolls[wScrollI].wX == wX &&
-				this->parrScrolls[wScrollI].wY == wY)
-			return (const WCHAR*) this->parrScrolls[wScrollI].ScrollText;
-	}
-	return NULL;
+	if (!IsValidColRow(wX, wY)) return NULL;
+	if (this->bObjectSquaresDirty) IndexObjectSquares();
+
+	const UINT wScrollI = this->ScrollSquares[ARRAYINDEX(wX,wY)];
+	return wScrollI == NO_ROOM_OBJECT ? NULL :
+			(const WCHAR*) this->parrScrolls[wScrollI].ScrollText;
 }
 
 //*****************************************************************************
@@ -1683,6 +2040,44 @@ const
 	return (UINT) (unsigned char) (this->pszTSquares[ARRAYINDEX(wX,wY)]);
 }
 
+//*****************************************************************************
+const vector<UINT> & CDbRoom::GetSquaresWithTile(
+//Gets the squares holding a tile, in no particular order.
+//
+//Params:
+	const UINT wTileNo)	//(in)	Tile on either the o- or t-layer.
+//
+//Returns:
+//Square indices (y * wRoomCols + x).  Changes when the room is plotted to.
+{
+	return GetTileSquares().GetSquares(wTileNo);
+}
+
+//*****************************************************************************
+UINT CDbRoom::GetTileCount(
+//Gets the number of squares holding a tile.
+//
+//Params:
+	const UINT wTileNo)	//(in)	Tile on either the o- or t-layer.
+{
+	return GetTileSquares().GetCount(wTileNo);
+}
+
+//*****************************************************************************
+UINT CDbRoom::GetSightDistance(
+//Gets how far sight reaches from a square before something blocks it.
+//
+//Params:
+	const UINT wX, const UINT wY,	//(in)	Square looked from.
+	const UINT wO)						//(in)	Direction looked in.
+//
+//Returns:
+//Number of squares in a row past (wX,wY) that don't block sight.
+{
+	ASSERT(IsValidColRow(wX, wY));
+	return GetSightLines().GetClearDistance(ARRAYINDEX(wX,wY), wO);
+}
+
 //*****************************************************************************
 void CDbRoom::SetCurrentGame(
 //Sets the current game pointer for anything associated with this room.
@@ -1705,17 +2100,10 @@ UINT CDbRoom::GetExitIndexAt(
 	const UINT wX, const UINT wY) //(in)
 const
 {
-	for (UINT i=0; i<this->Exits.size(); ++i)
-	{
-		const CExitData &stairs = *(this->Exits[i]);
-		if (wX >= stairs.wLeft && wX <= stairs.wRight &&
-				wY >= stairs.wTop && wY <= stairs.wBottom) 
-		{
-			return i;
-		}
-	}
+	if (!IsValidColRow(wX, wY)) return static_cast<UINT>(-1);
+	if (this->bObjectSquaresDirty) IndexObjectSquares();
 
-   return static_cast<UINT>(-1);
+	return this->ExitSquares[ARRAYINDEX(wX,wY)];	//NO_ROOM_OBJECT if none
 }
 
 //*****************************************************************************
@@ -1727,15 +2115,11 @@ bool CDbRoom::GetExitLevelIDAt(
    DWORD &dwLevelID) //(out) levelID for the exit at (wX,wY), else 0L if none.
 const
 {
-	for (UINT i=0; i<this->Exits.size(); ++i)
+	const UINT wExitI = GetExitIndexAt(wX, wY);
+	if (wExitI != NO_ROOM_OBJECT)
 	{
-		const CExitData &stairs = *(this->Exits[i]);
-		if (wX >= stairs.wLeft && wX <= stairs.wRight &&
-				wY >= stairs.wTop && wY <= stairs.wBottom) 
-		{
-			dwLevelID = stairs.dwLevelID;
-         return true;
-		}
+		dwLevelID = this->Exits[wExitI]->dwLevelID;
+      return true;
 	}
 
    dwLevelID = 0L;
@@ -1753,17 +2137,12 @@ void CDbRoom::SetExit(
 {
 	ASSERT(GetOSquare(wX,wY) == T_STAIRS);
 
-   UINT i;
-	for (i=0; i<this->Exits.size(); ++i)
+	const UINT wExitI = GetExitIndexAt(wX, wY);
+	if (wExitI != NO_ROOM_OBJECT)
 	{
-		CExitData &stairs = *(this->Exits[i]);
-		if (wX >= stairs.wLeft && wX <= stairs.wRight &&
-				wY >= stairs.wTop && wY <= stairs.wBottom)
-		{
-			//Modify existing exit's value.
-			stairs.dwLevelID = dwLevelID;
-			return;
-		}
+		//Modify existing exit's value.
+		this->Exits[wExitI]->dwLevelID = dwLevelID;
+		return;
 	}
 
 	//Add new exit for the specified rectangular room region.
@@ -1772,6 +2151,7 @@ void CDbRoom::SetExit(
 
 	CExitData *pNewExit = new CExitData(dwLevelID, wX, wX2, wY, wY2);
    this->Exits.push_back(pNewExit);
+	this->bObjectSquaresDirty = true;
 }
 
 //*****************************************************************************
@@ -1908,6 +2288,62 @@ DWORD CDbRoom::GetLocalID() const
 	return 0L;
 }
 
+//*****************************************************************************
+const CTileSquares & CDbRoom::GetTileSquares()
+//Returns: squares of each tile, indexing them first if that hasn't been done
+//since the squares were last set directly.
+{
+	if (!this->TileSquares.IsBuilt())
+		this->TileSquares.Build(this->pszOSquares, this->pszTSquares, CalcRoomArea());
+	return this->TileSquares;
+}
+
+//*****************************************************************************
+const CSightLines & CDbRoom::GetSightLines()
+//Returns: lines of sight from each square, finding them first if that hasn't
+//been done since the squares were last set directly.
+{
+	if (!this->SightLines.IsBuilt())
+		this->SightLines.Build(this->pszOSquares, this->pszTSquares,
+				this->wRoomCols, this->wRoomRows);
+	return this->SightLines;
+}
+
+//*****************************************************************************
+void CDbRoom::IndexObjectSquares()
+//Indexes orbs, scrolls and exits by the squares they're on.  Where two of a kind
+//share a square, the one earlier in its list is indexed, as a scan would find.
+const
+{
+	const UINT wSquareCount = CalcRoomArea();
+	this->OrbSquares.assign(wSquareCount, NO_ROOM_OBJECT);
+	this->ScrollSquares.assign(wSquareCount, NO_ROOM_OBJECT);
+	this->ExitSquares.assign(wSquareCount, NO_ROOM_OBJECT);
+
+	UINT wIndex;
+	for (wIndex=this->wOrbCount; wIndex--; )
+	{
+		const COrbData &orb = this->parrOrbs[wIndex];
+		if (IsValidColRow(orb.wX, orb.wY))
+			this->OrbSquares[ARRAYINDEX(orb.wX,orb.wY)] = wIndex;
+	}
+	for (wIndex=this->wScrollCount; wIndex--; )
+	{
+		const CScrollData &scroll = this->parrScrolls[wIndex];
+		if (IsValidColRow(scroll.wX, scroll.wY))
+			this->ScrollSquares[ARRAYINDEX(scroll.wX,scroll.wY)] = wIndex;
+	}
+	for (wIndex=this->Exits.size(); wIndex--; )
+	{
+		const CExitData &stairs = *(this->Exits[wIndex]);
+		for (UINT wY=stairs.wTop; wY <= stairs.wBottom && wY < this->wRoomRows; ++wY)
+			for (UINT wX=stairs.wLeft; wX <= stairs.wRight && wX < this->wRoomCols; ++wX)
+				this->ExitSquares[ARRAYINDEX(wX,wY)] = wIndex;
+	}
+
+	this->bObjectSquaresDirty = false;
+}
+
 //*****************************************************************************
 void CDbRoom::GetNumber_English(
 //Writes a number in English.  Should only be called by
@@ -1994,13 +2430,10 @@ void CDbRoom::GetLevelPositionDescription_English(
 
 //*****************************************************************************
 void CDbRoom::DeletePathMaps()
-//Deletes all existing PathMaps.
+//Deletes the PathMap and all of its movement type layers.
 {
-	for (int n=0; n<NumMovementTypes; ++n)
-	{
-		delete pPathMap[n];
-		pPathMap[n] = NULL;
-	}
+	delete this->pPathMap;
+	this->pPathMap = NULL;
 }
 
 //*****************************************************************************
@@ -2051,7 +2484,7 @@ void CDbRoom::OpenYellowDoor(
 	const UINT wX, const UINT wY)	//(in) Coords of any square of the door to open.
 {
 	if (GetOSquare(wX, wY)==T_DOOR_Y) 
-		FloodPlot(wX, wY, T_DOOR_YO);
+		PlotDoorComponent(GetDoorComponentAt(wX, wY), T_DOOR_YO);
 }
 
 //*****************************************************************************
@@ -2062,7 +2495,7 @@ void CDbRoom::CloseYellowDoor(
 	const UINT wX, const UINT wY)	//(in) Coords of any square of the door to close.
 {
 	if (GetOSquare(wX, wY)==T_DOOR_YO) 
-		FloodPlot(wX, wY, T_DOOR_Y);
+		PlotDoorComponent(GetDoorComponentAt(wX, wY), T_DOOR_Y);
 }
 
 //*****************************************************************************
@@ -2074,9 +2507,131 @@ void CDbRoom::ToggleYellowDoor(
 {
 	const UINT wTileNo = GetOSquare(wX, wY);
 	if (wTileNo == T_DOOR_YO) 
-		FloodPlot(wX, wY, T_DOOR_Y);
+		PlotDoorComponent(GetDoorComponentAt(wX, wY), T_DOOR_Y);
 	else if (wTileNo == T_DOOR_Y)
-		FloodPlot(wX, wY, T_DOOR_YO);
+		PlotDoorComponent(GetDoorComponentAt(wX, wY), T_DOOR_YO);
+}
+
+//*****************************************************************************
+UINT CDbRoom::GetDoorComponentAt(
+//Gets the yellow door a square is part of, labeling doors again first if door
+//squares have been plotted since they were last labeled.
+//
+//Params:
+	const UINT wX, const UINT wY)	//(in) Coords of square.
+//
+//Returns:
+//Index into DoorComponents, or NO_DOOR_COMPONENT if the square isn't a door.
+{
+	ASSERT(IsValidColRow(wX, wY));
+	if (this->bDoorComponentsDirty)
+		LabelDoorComponents();
+	return this->DoorSquareComponents[ARRAYINDEX(wX,wY)];
+}
+
+//*****************************************************************************
+void CDbRoom::LabelDoorComponents()
+//Divides the room's yellow door squares into the groups FloodPlot() would fill
+//together: squares adjacent (diagonals included) with the same tile.
+{
+	const UINT wSquareCount = CalcRoomArea();
+	this->DoorComponents.clear();
+	this->DoorSquareComponents.assign(wSquareCount, NO_DOOR_COMPONENT);
+	this->bDoorComponentsDirty = false;
+
+	vector<UINT> EvalSquares;
+	for (UINT wStartI = 0; wStartI < wSquareCount; ++wStartI)
+	{
+		const UINT wTileNo = (unsigned char)this->pszOSquares[wStartI];
+		if (!bIsYellowDoor(wTileNo) ||
+				this->DoorSquareComponents[wStartI] != NO_DOOR_COMPONENT)
+			continue;
+
+		//Label every square of this door.  Squares are labeled as they are
+		//pushed, so none is evaluated twice.
+		const UINT wComponent = this->DoorComponents.size();
+		this->DoorComponents.push_back(CDoorComponent());
+		CDoorComponent &Door = this->DoorComponents.back();
+		this->DoorSquareComponents[wStartI] = wComponent;
+		EvalSquares.push_back(wStartI);
+		while (!EvalSquares.empty())
+		{
+			const UINT wSquareI = EvalSquares.back();
+			EvalSquares.pop_back();
+			Door.Squares.push_back(wSquareI);
+
+			const UINT wX = wSquareI % this->wRoomCols, wY = wSquareI / this->wRoomCols;
+			const UINT wMinX = wX ? wX - 1 : 0, wMaxX = wX + 1 < this->wRoomCols ? wX + 1 : wX;
+			const UINT wMinY = wY ? wY - 1 : 0, wMaxY = wY + 1 < this->wRoomRows ? wY + 1 : wY;
+			for (UINT wAdjY = wMinY; wAdjY <= wMaxY; ++wAdjY)
+				for (UINT wAdjX = wMinX; wAdjX <= wMaxX; ++wAdjX)
+				{
+					const UINT wAdjI = ARRAYINDEX(wAdjX, wAdjY);
+					const UINT wAdjTileNo = (unsigned char)this->pszOSquares[wAdjI];
+					if (wAdjTileNo != wTileNo)
+					{
+						if (bIsYellowDoor(wAdjTileNo))
+							Door.bTouchesOtherDoor = true;
+					}
+					else if (this->DoorSquareComponents[wAdjI] == NO_DOOR_COMPONENT)
+					{
+						this->DoorSquareComponents[wAdjI] = wComponent;
+						EvalSquares.push_back(wAdjI);
+					}
+				}
+		}
+	}
+}
+
+//*****************************************************************************
+void CDbRoom::PlotDoorComponent(
+//Plots a yellow door tile to every square of a door.  Does the same as
+//FloodPlot() would, but in one pass over the door's squares, and with each
+//path map only reset once.
+//
+//Params:
+	const UINT wComponent,	//(in) Index of door in DoorComponents.
+	const UINT wTileNo)		//(in) T_DOOR_Y or T_DOOR_YO.
+{
+	ASSERT(wComponent < this->DoorComponents.size());
+	ASSERT(bIsYellowDoor(wTileNo));
+	const CDoorComponent &Door = this->DoorComponents[wComponent];
+
+	//A closed door is an obstacle to every movement type.  An open one is
+	//only an obstacle where something is on it, so only the door's empty
+	//squares change for the path maps.
+	this->DoorPathMapChanges.clear();
+	for (vector<UINT>::const_iterator iSquare = Door.Squares.begin();
+			iSquare != Door.Squares.end(); ++iSquare)
+	{
+		const UINT wSquareI = *iSquare;
+		ASSERT(bIsYellowDoor((unsigned char)this->pszOSquares[wSquareI]));
+		ASSERT((unsigned char)this->pszOSquares[wSquareI] != wTileNo);
+		if (this->TileSquares.IsBuilt())
+			this->TileSquares.Replace(wSquareI,
+					(unsigned char)this->pszOSquares[wSquareI], wTileNo);
+		this->pszOSquares[wSquareI] = static_cast<unsigned char>(wTileNo);
+		if (this->SightLines.IsBuilt())
+			this->SightLines.Update(this->pszOSquares, this->pszTSquares,
+					wSquareI % this->wRoomCols, wSquareI / this->wRoomCols);
+
+		const CMonster *pMonster = this->pMonsterSquares[wSquareI];
+		if (this->pszTSquares[wSquareI] == T_EMPTY &&
+				!(pMonster && pMonster->wType == M_MIMIC))
+			this->DoorPathMapChanges.push_back(wSquareI);
+	}
+
+	if (!this->DoorPathMapChanges.empty())
+		for (int eMovement=0; eMovement<NumMovementTypes; ++eMovement)
+			if (this->pPathMap && this->pPathMap->IsLayerEnabled(eMovement))
+				this->pPathMap->SetSquares(eMovement, this->DoorPathMapChanges,
+						wTileNo == T_DOOR_Y);
+
+	//Once toggled, the door may run into another one with the same tile.
+	if (Door.bTouchesOtherDoor)
+		this->bDoorComponentsDirty = true;
+
+	this->bPlotsMade = true;
 }
 
 //*****************************************************************************
@@ -2113,12 +2668,19 @@ void CDbRoom::Clear()
       this->Exits.pop_back();
    }
 	this->Exits.clear();
+	this->bObjectSquaresDirty = true;
 
 	DeletePathMaps();
 
 	ClearMonsters();
 	ClearDeadMonsters();
 	this->deletedScrollIDs.clear();
+
+	this->TileSquares.Clear();
+	this->SightLines.Clear();
+	this->DoorComponents.clear();
+	this->DoorSquareComponents.clear();
+	this->bDoorComponentsDirty = true;
 }
 
 //*****************************************************************************
@@ -2218,21 +2780,14 @@ bool CDbRoom::LoadOrbs(
 			c4_View OrbAgentsView = p_OrbAgents(OrbsView[wOrbI]);
 			this->parrOrbs[wOrbI].wX = p_X(OrbsView[wOrbI]);
 			this->parrOrbs[wOrbI].wY = p_Y(OrbsView[wOrbI]);
-			this->parrOrbs[wOrbI].wAgentCount = OrbAgentsView.GetSize();
-			if (this->parrOrbs[wOrbI].wAgentCount > 0)
+			const UINT wAgentCount = OrbAgentsView.GetSize();
+			this->parrOrbs[wOrbI].ReserveAgents(wAgentCount);
+			for (wOrbAgentI=0; wOrbAgentI < wAgentCount; wOrbAgentI++)
 			{
-				this->parrOrbs[wOrbI].parrAgents =
-						new COrbAgentData[this->parrOrbs[wOrbI].wAgentCount];
-				if (!this->parrOrbs[wOrbI].parrAgents) {bSuccess=false; goto Cleanup;}
-				for (wOrbAgentI=0; wOrbAgentI < this->parrOrbs[wOrbI].wAgentCount; wOrbAgentI++)
-				{
-					this->parrOrbs[wOrbI].parrAgents[wOrbAgentI].wAction =
-							p_Type(OrbAgentsView[wOrbAgentI]);
-					this->parrOrbs[wOrbI].parrAgents[wOrbAgentI].wX =
-							p_X(OrbAgentsView[wOrbAgentI]);
-					this->parrOrbs[wOrbI].parrAgents[wOrbAgentI].wY =
-							p_Y(OrbAgentsView[wOrbAgentI]);
-				}
+				this->parrOrbs[wOrbI].AddAgent(
+						p_X(OrbAgentsView[wOrbAgentI]),
+						p_Y(OrbAgentsView[wOrbAgentI]),
+						p_Type(OrbAgentsView[wOrbAgentI]));
 			}
 		}
 	}
@@ -2299,6 +2854,8 @@ void CDbRoom::ClearMonsters()
 		delete pDelete;
 	}
 	this->pFirstMonster = this->pLastMonster = NULL;
+	for (UINT wType=0; wType<MONSTER_TYPES; ++wType)
+		this->pFirstMonsterOfType[wType] = NULL;
 	this->wMonsterCount = this->wBrainCount = 0;
 
 	memset(this->pMonsterSquares, 0, this->wRoomRows * this->wRoomCols
@@ -2309,7 +2866,7 @@ void CDbRoom::ClearMonsters()
 void CDbRoom::ClearDeadMonsters()
 //Frees memory and resets members for dead monster list.
 {
-	list<CMonster *>::const_iterator iSeek = this->DeadMonsters.begin(), 
+	vector<CMonster *>::const_iterator iSeek = this->DeadMonsters.begin(), 
 			iStop = this->DeadMonsters.end();
 	while (iSeek != iStop)
 	{
@@ -2376,6 +2933,7 @@ void CDbRoom::AddOrb(
 
 	delete[] this->parrOrbs;
 	this->parrOrbs = pNewOrbs;
+	this->bObjectSquaresDirty = true;
 }
 
 //*****************************************************************************
@@ -2402,6 +2960,7 @@ COrbData* CDbRoom::AddOrbToSquare(
 
 	delete[] this->parrOrbs;
 	this->parrOrbs = pNewOrbs;
+	this->bObjectSquaresDirty = true;
 
 	return pNewOrb;
 }
@@ -2425,6 +2984,7 @@ void CDbRoom::AddScroll(
 
 	delete[] this->parrScrolls;
 	this->parrScrolls = pNewScrolls;
+	this->bObjectSquaresDirty = true;
 }
 
 //*****************************************************************************
@@ -2438,6 +2998,7 @@ bool CDbRoom::AddExit(
 		return false;	//no exit actually here
 
 	this->Exits.push_back(pExit);
+	this->bObjectSquaresDirty = true;
    return true;
 }
 
@@ -2458,6 +3019,7 @@ void CDbRoom::DeleteExitAtSquare(
          delete this->Exits[i];
          this->Exits[i] = this->Exits[this->Exits.size() - 1];
 			this->Exits.pop_back();
+			this->bObjectSquaresDirty = true;
 		}
 	}
 }
@@ -2471,18 +3033,14 @@ void CDbRoom::DeleteOrbAtSquare(
 {
 	ASSERT(GetTSquare(wX,wY) == T_ORB);
 
-   UINT wOrbI;
-	for (wOrbI=0; wOrbI < this->wOrbCount; ++wOrbI)
-	{
-		if (this->parrOrbs[wOrbI].wX == wX && this->parrOrbs[wOrbI].wY == wY)
-		{
-			//Found it.
-			break;
-		}
-	}
+	COrbData *pOrb = GetOrbAtCoords(wX, wY);
+	ASSERT(pOrb);
 
 	//Reorganize orbs array (move last one forward).
-	this->parrOrbs[wOrbI] = this->parrOrbs[--this->wOrbCount];
+	--this->wOrbCount;
+	if (pOrb != this->parrOrbs + this->wOrbCount)
+		*pOrb = this->parrOrbs[this->wOrbCount];
+	this->bObjectSquaresDirty = true;
 }
 
 //*****************************************************************************
@@ -2494,28 +3052,27 @@ void CDbRoom::DeleteScrollTextAtSquare(
 {
 	ASSERT(GetTSquare(wX,wY) == T_SCROLL);
 
-	//Search for scroll in room data.
-   UINT wScrollI;
-	for (wScrollI=0; wScrollI < this->wScrollCount; ++wScrollI)
+	//Look up scroll in room data.
+	if (this->bObjectSquaresDirty) IndexObjectSquares();
+	const UINT wScrollI = this->ScrollSquares[ARRAYINDEX(wX,wY)];
+	if (wScrollI == NO_ROOM_OBJECT)
 	{
-		if (this->parrScrolls[wScrollI].wX == wX &&
-				this->parrScrolls[wScrollI].wY == wY)
-		{
-			//Found it.  Put scroll text ID in list of message texts to remove from DB on Update.
-			DWORD dwMessageID = parrScrolls[wScrollI].ScrollText.GetMessageID();
-			if (dwMessageID)
-				this->deletedScrollIDs.push_back(dwMessageID);
-	      //Remove from scrolls array (copy last item over it and shrink count).
-	      this->parrScrolls[wScrollI] = this->parrScrolls[--this->wScrollCount];
-         //The code below is required to copy the text and message ID over as well.
-         this->parrScrolls[wScrollI].ScrollText.Clear();
-			dwMessageID = this->parrScrolls[this->wScrollCount].ScrollText.GetMessageID();
-			if (dwMessageID)
-				this->parrScrolls[wScrollI].ScrollText.Bind(dwMessageID);
-			return;
-		}
+		ASSERTP(false,"No scroll object found in CDbRoom::DeleteScrollTextAtSquare()");
+		return;
 	}
-   ASSERTP(false,"No scroll object found in CDbRoom::DeleteScrollTextAtSquare()");
+
+	//Put scroll text ID in list of message texts to remove from DB on Update.
+	DWORD dwMessageID = parrScrolls[wScrollI].ScrollText.GetMessageID();
+	if (dwMessageID)
+		this->deletedScrollIDs.push_back(dwMessageID);
+	//Remove from scrolls array (copy last item over it and shrink count).
+	this->parrScrolls[wScrollI] = this->parrScrolls[--this->wScrollCount];
+   //The code below is required to copy the text and message ID over as well.
+   this->parrScrolls[wScrollI].ScrollText.Clear();
+	dwMessageID = this->parrScrolls[this->wScrollCount].ScrollText.GetMessageID();
+	if (dwMessageID)
+		this->parrScrolls[wScrollI].ScrollText.Bind(dwMessageID);
+	this->bObjectSquaresDirty = true;
 }
 
 //*****************************************************************************
@@ -2584,17 +3141,14 @@ void CDbRoom::SetScrollTextAtSquare(
 {
 	ASSERT(GetTSquare(wX,wY) == T_SCROLL);
 
-	//Search for scroll in room data.
-   UINT wScrollI;
-	for (wScrollI=0; wScrollI < this->wScrollCount; ++wScrollI)
+	//Look up scroll in room data.
+	if (this->bObjectSquaresDirty) IndexObjectSquares();
+   UINT wScrollI = this->ScrollSquares[ARRAYINDEX(wX,wY)];
+	if (wScrollI != NO_ROOM_OBJECT)
 	{
-		if (this->parrScrolls[wScrollI].wX == wX &&
-				this->parrScrolls[wScrollI].wY == wY)
-		{
-			//Update text of existing scroll.
-			this->parrScrolls[wScrollI].ScrollText = pwczScrollText;
-			return;
-		}
+		//Update text of existing scroll.
+		this->parrScrolls[wScrollI].ScrollText = pwczScrollText;
+		return;
 	}
 
 	//Add new text.  Reallocate scroll array.
@@ -2609,41 +3163,89 @@ void CDbRoom::SetScrollTextAtSquare(
 
 	delete[] this->parrScrolls;
 	this->parrScrolls = pNewScrolls;
+	this->bObjectSquaresDirty = true;
 }
 
 //*****************************************************************************
-inline bool CDbRoom::NewTarWouldBeStable(
-//Determines whether new tar could be placed at this spot (as opposed to a tar baby)
-//according to rule that a minimum of a 2x2 square of tar can exist.
+static inline UINT TarBitsAbove(
+//Gets a word of a tar bitboard column moved down a row, so that each row's bit
+//tells whether there is tar in the row above it.
 //
 //Params:
-	tartype *added_tar,	//(in) where tar is located in room
-	const UINT tx, const UINT ty)	//(in) square where tar is growing
+	const UINT *pwColumn,	//(in) column of bitboard words
+	const UINT wWord)			//(in) word of column
 //
 //Returns:
-//True if should go here, false if tar baby.
+//Shifted word.
 {
-	bool tar[3][3] = {{false}};
-	UINT x, y;
+	return (pwColumn[wWord] << 1) |
+			(wWord ? pwColumn[wWord - 1] >> (TAR_WORD_BITS - 1) : 0);
+}
 
-	//mark where tar is
-	for (x=tx-1; x!=tx+2; x++)
-		if (x < wRoomCols)
-			for (y=ty-1; y!=ty+2; y++)
-				if (y < wRoomRows)
-					tar[x-tx+1][y-ty+1] = (added_tar[y * wRoomCols + x] != notar);
+//*****************************************************************************
+static inline UINT TarBitsBelow(
+//Gets a word of a tar bitboard column moved up a row, so that each row's bit
+//tells whether there is tar in the row below it.
+//
+//Params:
+	const UINT *pwColumn,	//(in) column of bitboard words
+	const UINT wWord,			//(in) word of column
+	const UINT wWords)		//(in) words in column
+//
+//Returns:
+//Shifted word.
+{
+	return (pwColumn[wWord] >> 1) |
+			(wWord + 1 < wWords ? pwColumn[wWord + 1] << (TAR_WORD_BITS - 1) : 0);
+}
 
-	return (
-		(tar[0][0] && tar[0][1] && tar[1][0]) ||	//upper-left corner
-		(tar[0][2] && tar[0][1] && tar[1][2]) ||	//lower-left corner
-		(tar[2][0] && tar[2][1] && tar[1][0]) ||	//upper-right corner
-		(tar[2][2] && tar[2][1] && tar[1][2]));		//lower-right corner
+//*****************************************************************************
+inline UINT CDbRoom::GetStableTarBits(
+//Determines where new tar could be placed in part of a column (as opposed to a
+//tar baby) according to rule that a minimum of a 2x2 square of tar can exist.
+//
+//Params:
+	const UINT *pwTar,	//(in) where tar is located in room, as a bitboard of
+								//		TAR_WORD_BITS rows per word, column by column
+	const UINT wX,			//(in) column where tar is growing
+	const UINT wWord)		//(in) word of column, starting at row wWord * TAR_WORD_BITS
+//
+//Returns:
+//Bits set for rows where new tar should go, clear where a tar baby should.
+const
+{
+	const UINT wWords = (this->wRoomRows + TAR_WORD_BITS - 1) / TAR_WORD_BITS;
+	const UINT *pwColumn = pwTar + wX * wWords;
+	const UINT wAbove = TarBitsAbove(pwColumn, wWord);
+	const UINT wBelow = TarBitsBelow(pwColumn, wWord, wWords);
+
+	//Tar in a neighbouring column, and beside the square and diagonal to it on
+	//the same side as tar above or below, completes a 2x2 square.
+	UINT wStable = 0;
+	if (wX > 0)
+	{
+		const UINT *pwLeft = pwColumn - wWords;
+		wStable |= pwLeft[wWord] & (
+				(wAbove & TarBitsAbove(pwLeft, wWord)) |					//upper-left corner
+				(wBelow & TarBitsBelow(pwLeft, wWord, wWords)));		//lower-left corner
+	}
+	if (wX + 1 < this->wRoomCols)
+	{
+		const UINT *pwRight = pwColumn + wWords;
+		wStable |= pwRight[wWord] & (
+				(wAbove & TarBitsAbove(pwRight, wWord)) |					//upper-right corner
+				(wBelow & TarBitsBelow(pwRight, wWord, wWords)));		//lower-right corner
+	}
+	return wStable;
 }
 
 //*****************************************************************************
 void CDbRoom::GrowTar(
 //Grows the tar and creates tarbabies.
 //
+//Tar is tracked on bitboards kept between turns, so growth next to tar and the
+//2x2 rule are checked a word of squares at a time without allocating.
+//
 //Params:
 	CCueEvents &CueEvents)	//(out)	May receive some new cue events.
 {
@@ -2653,94 +3255,120 @@ void CDbRoom::GrowTar(
 	//Assign to local vars for speed and brevity.
 	const UINT wSManX = this->pCurrentGame->swordsman.wX;
 	const UINT wSManY = this->pCurrentGame->swordsman.wY;
-
-	//Get coord index with all swords for quick eval.
-	CCoordIndex SwordCoords;
-	GetSwordCoords(SwordCoords);
-
-	//calculate where tar might grow
-	tartype *added_tar = new tartype[wRoomCols * wRoomRows];
-	CCoordStack *possible = new CCoordStack();
-	UINT x, y, pos;
-	for (x = 0; x < wRoomCols; ++x)
-		for (y = 0; y < wRoomRows; ++y)
+	const UINT wSwordX = this->pCurrentGame->swordsman.wSwordX;
+	const UINT wSwordY = this->pCurrentGame->swordsman.wSwordY;
+
+	//Tar is always under tar mothers.
+	CMonster *pSeek;
+	for (pSeek = this->pFirstMonsterOfType[M_TARMOTHER]; pSeek != NULL;
+			pSeek = pSeek->pNextOfType)
+		Plot(pSeek->wX, pSeek->wY, T_TAR);
+
+	//One bitboard for where tar is, one for where new tar is growing.
+	//Squares are in the same column-major order they were always checked in.
+	const UINT wWords = (this->wRoomRows + TAR_WORD_BITS - 1) / TAR_WORD_BITS;
+	const UINT wBoardSize = this->wRoomCols * wWords;
+	if (this->TarBits.size() != 2 * wBoardSize)
+		this->TarBits.resize(2 * wBoardSize);
+	UINT *const pwTar = &this->TarBits[0];
+	UINT *const pwNewTar = pwTar + wBoardSize;
+	memset(pwTar, 0, 2 * wBoardSize * sizeof(UINT));
+
+	//Mark where tar is, and the open squares new tar could grow onto.
+	UINT x, y, w, wI, wN, wB;
+	for (x = 0; x < this->wRoomCols; ++x)
+		for (y = 0; y < this->wRoomRows; ++y)
 		{
-			pos = y * wRoomCols + x;	//shorthand
-			//Determine where old tar is.
-			CMonster *m = GetMonsterAtSquare(x, y);
-			if (m != NULL && m->wType == M_TARMOTHER)
-				Plot(x, y, T_TAR);
-			if (GetTSquare(x, y) == T_TAR)
+			const UINT wSquareIndex = ARRAYINDEX(x,y);
+			const UINT wBit = 1u << (y % TAR_WORD_BITS);
+			wI = x * wWords + y / TAR_WORD_BITS;
+			const UINT wTTile = (unsigned char) this->pszTSquares[wSquareIndex];
+			if (wTTile == T_TAR)
+				pwTar[wI] |= wBit;
+			else if (wTTile == T_EMPTY && !this->pMonsterSquares[wSquareIndex] &&
+					!(x == wSManX && y == wSManY))
 			{
-				added_tar[pos] = oldtar;
-				continue;
-			} else {
-				added_tar[pos] = notar;
+				const UINT wOTile = (unsigned char) this->pszOSquares[wSquareIndex];
+				if (wOTile == T_FLOOR || wOTile == T_DOOR_YO ||
+						wOTile == T_CHECKPOINT || wOTile == T_TRAPDOOR)
+					pwNewTar[wI] |= wBit;
 			}
-			//Determine whether new tar can go here.
-			const UINT tile = GetOSquare(x, y);
-			if ((tile == T_FLOOR || tile == T_DOOR_YO ||
-			     tile == T_CHECKPOINT || tile == T_TRAPDOOR) &&
-			    GetTSquare(x, y) == T_EMPTY &&
-				!(x == wSManX && y == wSManY) && !m)
-				for (UINT o = 0; o < ORIENTATION_COUNT; ++o)
-				{
-					if (o == NO_ORIENTATION) continue;
-					const int nx = x + nGetOX(o);
-					const int ny = y + nGetOY(o);
-
-					if (IsValidColRow(nx, ny)) {
-						CMonster *m2 = GetMonsterAtSquare(nx, ny);
-						if (GetTSquare(nx, ny) == T_TAR || (m2 && m2->wType == M_TARMOTHER))
-						{
-							//Tar is adjacent to this square, so tar might grow here.
-							added_tar[pos] = newtar;
-							possible->Push(x, y);
-							break;
-						}
-					}
-				}
 		}
 
-	//calculate whether tar or tar babies are placed where tar grows
-	bool done = false;
-	while (!done)
-	{
-		done = true;
-		CCoordStack *newPossible = new CCoordStack();
-		while (possible->Pop(x, y))
+	//Tar might grow onto open squares adjacent to tar.
+	for (x = 0; x < this->wRoomCols; ++x)
+		for (w = 0; w < wWords; ++w)
 		{
-			pos = y * wRoomCols + x;	//shorthand
-			if (added_tar[pos] == newtar)	//going to grow here
-				if (NewTarWouldBeStable(added_tar,x,y))
-				{
-					//tar might grow here, but wait until all tar babies have spawned, etc.
-					newPossible->Push(x, y);
-				}
-				else if (!SwordCoords.Exists(x,y))
+			UINT wAdjacent = 0;
+			for (UINT nx = x - 1; nx != x + 2; ++nx)
+				if (nx < this->wRoomCols)
 				{
-					added_tar[pos] = notar;
-					CMonster *m = AddNewMonster(M_TARBABY,x,y);
-					CueEvents.Add(CID_TarBabyFormed, m);
-					m->SetCurrentGame(this->pCurrentGame);
-					m->bIsFirstTurn = false;
-					done = false;
-				}
-				else {	//tar baby can't grow under sword
-					added_tar[pos] = notar;
-					done = false;
+					const UINT *pwColumn = pwTar + nx * wWords;
+					wAdjacent |= pwColumn[w] | TarBitsAbove(pwColumn, w) |
+							TarBitsBelow(pwColumn, w, wWords);
 				}
+			pwNewTar[x * wWords + w] &= wAdjacent;
 		}
+	for (wI = 0; wI < wBoardSize; ++wI)
+		pwTar[wI] |= pwNewTar[wI];
+
+	//calculate whether tar or tar babies are placed where tar grows.
+	//Each pass goes through the squares in the opposite order to the last,
+	//and a tar baby formed early in a pass affects squares checked after it.
+	bool bForward = false;
+	for (;;)
+	{
+		//Done once all the new tar is stable.
+		for (wI = 0; wI < wBoardSize; ++wI)
+			if (pwNewTar[wI] & ~GetStableTarBits(pwTar, wI / wWords, wI % wWords))
+				break;
+		if (wI == wBoardSize)
+			break;
 
-		delete possible;
-		possible = newPossible;
+		for (wN = 0; wN < wBoardSize; ++wN)
+		{
+			wI = bForward ? wN : wBoardSize - 1 - wN;
+			if (!pwNewTar[wI]) continue;
+			x = wI / wWords;
+			w = wI % wWords;
+			for (wB = 0; wB < TAR_WORD_BITS; ++wB)
+			{
+				const UINT wBitNo = bForward ? wB : TAR_WORD_BITS - 1 - wB;
+				const UINT wBit = 1u << wBitNo;
+				if (!(pwNewTar[wI] & wBit) ||
+						(GetStableTarBits(pwTar, x, w) & wBit))
+					continue;
+
+				pwNewTar[wI] &= ~wBit;
+				pwTar[wI] &= ~wBit;
+				y = w * TAR_WORD_BITS + wBitNo;
+				if ((x == wSwordX && y == wSwordY) ||
+						DoesSquareContainMimicSword(x, y))
+					continue;	//tar baby can't grow under sword
+
+				CMonster *m = AddNewMonster(M_TARBABY,x,y);
+				CueEvents.Add(CID_TarBabyFormed, m);
+				m->SetCurrentGame(this->pCurrentGame);
+				m->bIsFirstTurn = false;
+			}
+		}
+		bForward = !bForward;
 	}
 
-	while (possible->Pop(x, y)) 
-		Plot(x, y, T_TAR);
-
-	delete possible;	
-	delete added_tar;
+	//Grow the stable new tar, in reverse of the last pass's order.
+	for (wN = 0; wN < wBoardSize; ++wN)
+	{
+		wI = bForward ? wBoardSize - 1 - wN : wN;
+		if (!pwNewTar[wI]) continue;
+		x = wI / wWords;
+		w = wI % wWords;
+		for (wB = 0; wB < TAR_WORD_BITS; ++wB)
+		{
+			const UINT wBitNo = bForward ? TAR_WORD_BITS - 1 - wB : wB;
+			if (pwNewTar[wI] & (1u << wBitNo))
+				Plot(x, w * TAR_WORD_BITS + wBitNo, T_TAR);
+		}
+	}
 }
 
 //*****************************************************************************
@@ -2987,17 +3615,14 @@ void CDbRoom::GetMimicSwordCoords(
 const
 {
 	MimicSwordCoords.Init(this->wRoomCols, this->wRoomRows);
-	CMonster *pSeek = this->pFirstMonster;
+	CMonster *pSeek = this->pFirstMonsterOfType[M_MIMIC];
 	while (pSeek)
 	{
-		if (pSeek->wType == M_MIMIC)
-		{
-			CMimic *pMimic = DYN_CAST(CMimic*, CMonster*, pSeek);
-			const UINT wSX = pMimic->GetSwordX(), wSY = pMimic->GetSwordY();
-			if (IsValidColRow(wSX, wSY))
-				MimicSwordCoords.Add(wSX, wSY);
-		}
-		pSeek=pSeek->pNext;
+		CMimic *pMimic = DYN_CAST(CMimic*, CMonster*, pSeek);
+		const UINT wSX = pMimic->GetSwordX(), wSY = pMimic->GetSwordY();
+		if (IsValidColRow(wSX, wSY))
+			MimicSwordCoords.Add(wSX, wSY);
+		pSeek=pSeek->pNextOfType;
 	}
 }
 
@@ -3032,39 +3657,46 @@ bool CDbRoom::DoesSquareContainMimicSword(
 //True if it does, false if not.
 const
 {
-	CMonster *pSeek = this->pFirstMonster;
+	CMonster *pSeek = this->pFirstMonsterOfType[M_MIMIC];
 	while (pSeek)
 	{
-		if (pSeek->wType == M_MIMIC)
-		{
-			CMimic *pMimic = DYN_CAST(CMimic*, CMonster*, pSeek);
-			if (pMimic->GetSwordX()==wX && pMimic->GetSwordY()==wY) return true;
-		}
-		pSeek=pSeek->pNext;
+		CMimic *pMimic = DYN_CAST(CMimic*, CMonster*, pSeek);
+		if (pMimic->GetSwordX()==wX && pMimic->GetSwordY()==wY) return true;
+		pSeek=pSeek->pNextOfType;
 	}
 	return false;
 }
 
 //*****************************************************************************
 void CDbRoom::CreatePathMap(
-//Creates a PathMap for the current room.  If a PathMap has already
-//been created, it will reset the PathMap.
+//Creates a PathMap layer for a movement type in the current room.  If the
+//layer has already been created, it will reset it.  All movement types share
+//one PathMap, so their paths are calculated together.
 //
 //Params:
 	const UINT wX, const UINT wY, // (in) Position of target (swordsman)
 	const MovementType eMovement)	// (in) Type of movement path reflects
 {
 	POINT p = {wX, wY};
-	if (!this->pPathMap[eMovement])
-		this->pPathMap[eMovement] = new CPathMap(this->wRoomCols, this->wRoomRows, p);
+	if (!this->pPathMap)
+		this->pPathMap = new CPathMap(this->wRoomCols, this->wRoomRows, p,
+				NumMovementTypes);
 	else
-		this->pPathMap[eMovement]->SetTarget(p);
-	for (UINT x = 0; x < this->wRoomCols; x++)
-		for (UINT y = 0; y < this->wRoomRows; y++)
+		this->pPathMap->SetTarget(p);
+	this->pPathMap->EnableLayer(eMovement);
+
+	//Set the whole layer, resetting it at most twice.
+	vector<UINT> Obstacles, NonObstacles;
+	for (UINT y = 0; y < this->wRoomRows; y++)
+		for (UINT x = 0; x < this->wRoomCols; x++)
 		{
-			const bool obstacle = DoesSquareContainPathMapObstacle(x, y, eMovement);
-			this->pPathMap[eMovement]->SetSquare(x, y, obstacle);
+			if (DoesSquareContainPathMapObstacle(x, y, eMovement))
+				Obstacles.push_back(ARRAYINDEX(x,y));
+			else
+				NonObstacles.push_back(ARRAYINDEX(x,y));
 		}
+	this->pPathMap->SetSquares(eMovement, Obstacles, true);
+	this->pPathMap->SetSquares(eMovement, NonObstacles, false);
 }
 
 //*****************************************************************************
@@ -3331,13 +3963,17 @@ bool CDbRoom::RemoveSerpents()
 //True if any serpent segments were found, false if not.
 {
 	bool bChangedTiles=false;
-	for (UINT unY=0; unY < wRoomRows; ++unY)
-		for (UINT unX=0; unX < wRoomCols; ++unX)
-			if (bIsSerpent(GetTSquare(unX, unY)))
-			{
-				Plot(unX, unY, T_EMPTY);
-				bChangedTiles = true;
-			}
+	for (UINT unTile=T_SNK_EW; unTile <= T_SNKT_E; ++unTile)
+	{
+		//Plotting removes squares from the tile's list, so work from a copy.
+		const vector<UINT> Squares = GetSquaresWithTile(unTile);
+		for (vector<UINT>::const_iterator iSquare = Squares.begin();
+				iSquare != Squares.end(); ++iSquare)
+		{
+			Plot(*iSquare % this->wRoomCols, *iSquare / this->wRoomCols, T_EMPTY);
+			bChangedTiles = true;
+		}
+	}
 	return bChangedTiles;
 }
 
@@ -3348,15 +3984,16 @@ bool CDbRoom::ChangeTiles(const UINT unOldTile, const UINT unNewTile)
 //Retuns:
 //True if any tiles were found
 {
-	bool bChangedTiles=false;
-	for (UINT unY=0; unY < wRoomRows; ++unY)
-		for (UINT unX=0; unX < wRoomCols; ++unX)
-			if (GetOSquare(unX,unY) == unOldTile)
-			{
-				Plot(unX, unY, unNewTile);
-				bChangedTiles=true;
-			}
-	return bChangedTiles;
+	ASSERT(TILE_LAYER[unOldTile] == 0);
+	if (unOldTile == unNewTile)
+		return GetTileCount(unOldTile) != 0;
+
+	//Plotting removes squares from the tile's list, so work from a copy.
+	const vector<UINT> Squares = GetSquaresWithTile(unOldTile);
+	for (vector<UINT>::const_iterator iSquare = Squares.begin();
+			iSquare != Squares.end(); ++iSquare)
+		Plot(*iSquare % this->wRoomCols, *iSquare / this->wRoomCols, unNewTile);
+	return !Squares.empty();
 }
 
 //*****************************************************************************
@@ -3378,7 +4015,7 @@ void CDbRoom::Plot(
 	bool bWasPathMapObstacle[NumMovementTypes];
    int eMovement;
 	for (eMovement=0; eMovement<NumMovementTypes; ++eMovement)
-		if (this->pPathMap[eMovement])
+		if (this->pPathMap && this->pPathMap->IsLayerEnabled(eMovement))
 			bWasPathMapObstacle[eMovement] =
 					DoesSquareContainPathMapObstacle(wX, wY, (MovementType)eMovement);
 
@@ -3387,6 +4024,13 @@ void CDbRoom::Plot(
 	switch(TILE_LAYER[wTileNo])
 	{
 		case 0: //Opaque layer.
+			//Door components are relabeled when next needed.
+			if (bIsYellowDoor(wTileNo) ||
+					bIsYellowDoor((unsigned char)this->pszOSquares[wSquareIndex]))
+				this->bDoorComponentsDirty = true;
+			if (this->TileSquares.IsBuilt())
+				this->TileSquares.Replace(wSquareIndex,
+						(unsigned char)this->pszOSquares[wSquareIndex], wTileNo);
 			this->pszOSquares[wSquareIndex] = static_cast<unsigned char>(wTileNo);
 		break;
 
@@ -3406,17 +4050,24 @@ void CDbRoom::Plot(
 				ASSERT(pMonster);
 				this->pMonsterSquares[wSquareIndex] = pMonster;
 			}
+			if (this->TileSquares.IsBuilt())
+				this->TileSquares.Replace(wSquareIndex,
+						(unsigned char)this->pszTSquares[wSquareIndex], wTileNo);
 			this->pszTSquares[wSquareIndex] = static_cast<unsigned char>(wTileNo);
 		break;
 	}
 
+	//Lines of sight through the square may be blocked or cleared.
+	if (this->SightLines.IsBuilt())
+		this->SightLines.Update(this->pszOSquares, this->pszTSquares, wX, wY);
+
 	for (eMovement=0; eMovement<NumMovementTypes; ++eMovement)
-		if (this->pPathMap[eMovement])
+		if (this->pPathMap && this->pPathMap->IsLayerEnabled(eMovement))
 		{
 			const bool bIsPathMapObstacle = DoesSquareContainPathMapObstacle(wX,
 					wY, (MovementType)eMovement);
 			if (bWasPathMapObstacle[eMovement] != bIsPathMapObstacle)
-				this->pPathMap[eMovement]->SetSquare(wX, wY, bIsPathMapObstacle);
+				this->pPathMap->SetSquare(eMovement, wX, wY, bIsPathMapObstacle);
 		}
 
 	this->bPlotsMade = true;
@@ -3729,6 +4380,10 @@ bool CDbRoom::SetMembers(
 	this->wScrollCount = Src.wScrollCount;
 	this->wTrapDoorsLeft = Src.wTrapDoorsLeft;
 	this->bPlotsMade = Src.bPlotsMade;
+	this->TileSquares = Src.TileSquares;
+	this->DoorComponents = Src.DoorComponents;
+	this->DoorSquareComponents = Src.DoorSquareComponents;
+	this->bDoorComponentsDirty = Src.bDoorComponentsDirty;
 
 	//Room squares
 	const DWORD dwSquareCount = this->wRoomCols * this->wRoomRows;
@@ -3788,9 +4443,8 @@ bool CDbRoom::SetMembers(
 
 	this->pCurrentGame = Src.pCurrentGame;
 
-	//Path maps -- don't copy
-	for (wIndex=NumMovementTypes; wIndex--; )
-		this->pPathMap[wIndex] = NULL;
+	//Path map -- don't copy
+	this->pPathMap = NULL;
 
 Cleanup:
 	if (!bSuccess)
@@ -3803,12 +4457,14 @@ void CDbRoom::InitRoomStats()
 //Initialize variables whose values are implicitly determined by the contents 
 //of squares in the room.
 {
+   //Squares of each tile.
+   this->TileSquares.Build(this->pszOSquares, this->pszTSquares, CalcRoomArea());
+
    //Number of trapdoors left.
-   this->wTrapDoorsLeft = 0;
-   char *pszSeek, *pszStop;
-   pszStop = this->pszOSquares + CalcRoomArea() * sizeof(char);
-   for (pszSeek = this->pszOSquares; pszSeek != pszStop; ++pszSeek)
-      if (*pszSeek == T_TRAPDOOR) ++this->wTrapDoorsLeft;
+   this->wTrapDoorsLeft = this->TileSquares.GetCount(T_TRAPDOOR);
+
+   //Yellow doors that orbs will open and close.
+   LabelDoorComponents();
 }
 
 //*****************************************************************************
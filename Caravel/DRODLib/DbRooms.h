@@ -33,8 +33,10 @@
 #include "DbVDInterface.h"
 #include "DbDemos.h"
 #include "DbSavedGames.h"
+#include "GameConstants.h"
 #include "Monster.h"
 #include "Pathmap.h"
+#include "TileConstants.h"
 #include <BackEndLib/CoordIndex.h>
 #include <BackEndLib/CoordStack.h>
 
@@ -67,7 +69,7 @@ public:
 	COrbData()
 		: CAttachableObject()
       , wX(0), wY(0), wAgentCount(0)
-		, parrAgents(NULL)
+		, parrAgents(NULL), wAgentCapacity(0)
 	{ }
 	~COrbData()
 	{
@@ -84,33 +86,24 @@ public:
 
 	COrbAgentData* AddAgent(const UINT wX, const UINT wY, const UINT wAction)
 	{
-		//Add new agent.  Reallocate agent array.
-		COrbAgentData *pNewAgents = new COrbAgentData[this->wAgentCount+1];
-		COrbAgentData *pNewAgent = pNewAgents + this->wAgentCount;
-		for (UINT wAgentI = 0; wAgentI < this->wAgentCount; wAgentI++)
-			pNewAgents[wAgentI] = this->parrAgents[wAgentI];
+		//Add new agent.
+		if (this->wAgentCount == this->wAgentCapacity)
+			ReserveAgents(this->wAgentCapacity ? this->wAgentCapacity * 2 : 4);
+		COrbAgentData *pNewAgent = this->parrAgents + this->wAgentCount;
 		pNewAgent->wAction = wAction;
 		pNewAgent->wX = wX;
 		pNewAgent->wY = wY;
 		++this->wAgentCount;
 
-		delete[] this->parrAgents;
-		this->parrAgents = pNewAgents;
-
 		return pNewAgent;
 	}
 
 	void AddAgent(COrbAgentData *pAgent)
 	{
-		//Add new agent.  Reallocate agent array.
-		COrbAgentData *pNewAgents = new COrbAgentData[this->wAgentCount+1];
-		for (UINT wAgentI = 0; wAgentI < this->wAgentCount; wAgentI++)
-			pNewAgents[wAgentI] = this->parrAgents[wAgentI];
-		pNewAgents[this->wAgentCount] = *pAgent;
-		++this->wAgentCount;
-
-		delete[] this->parrAgents;
-		this->parrAgents = pNewAgents;
+		//Add new agent.
+		if (this->wAgentCount == this->wAgentCapacity)
+			ReserveAgents(this->wAgentCapacity ? this->wAgentCapacity * 2 : 4);
+		this->parrAgents[this->wAgentCount++] = *pAgent;
 	}
 
 	bool DeleteAgent(COrbAgentData* const pOrbAgent)
@@ -145,18 +138,34 @@ public:
 	UINT			wAgentCount;
 	COrbAgentData *	parrAgents;
 
+	void ReserveAgents(const UINT wCount)
+	{
+		//Make room for wCount agents, so adding that many won't reallocate.
+		//Reallocates the agent array.
+		if (wCount <= this->wAgentCapacity) return;
+		COrbAgentData *pNewAgents = new COrbAgentData[wCount];
+		for (UINT wAgentI = 0; wAgentI < this->wAgentCount; wAgentI++)
+			pNewAgents[wAgentI] = this->parrAgents[wAgentI];
+
+		delete[] this->parrAgents;
+		this->parrAgents = pNewAgents;
+		this->wAgentCapacity = wCount;
+	}
+
 private:
 	void SetMembers(const COrbData &Src)
 	{
 		this->wX = Src.wX;
 		this->wY = Src.wY;
-		this->wAgentCount = Src.wAgentCount;
+		this->wAgentCount = this->wAgentCapacity = Src.wAgentCount;
 		this->parrAgents = new COrbAgentData[this->wAgentCount];
 		for (UINT wAgentI = 0; wAgentI < this->wAgentCount; ++wAgentI)
 		{
 			this->parrAgents[wAgentI] = Src.parrAgents[wAgentI];
 		}
 	}
+
+	UINT			wAgentCapacity;	//size of parrAgents
 };
 
 //******************************************************************************************
@@ -204,6 +213,93 @@ public:
 	UINT			wLeft, wRight, wTop, wBottom;
 };
 
+//******************************************************************************************
+//Squares of a yellow door that an orb opens or closes together, i.e. what
+//FloodPlot() would fill from any one of them.
+class CDoorComponent
+{
+public:
+	CDoorComponent() : bTouchesOtherDoor(false) { }
+
+	vector<UINT>	Squares;	//square indices
+	bool			bTouchesOtherDoor;	//next to a yellow door square in the
+										//other state, which it merges with
+										//after being toggled
+};
+
+//******************************************************************************************
+//Which squares of a room hold each tile, so that all squares of one tile can be
+//found without scanning the room.
+class CTileSquares
+{
+public:
+	CTileSquares() : bBuilt(false) { }
+
+	void			Build(const char *pszOSquares, const char *pszTSquares,
+			const UINT wSquareCount);
+	void			Clear();
+	UINT			GetCount(const UINT wTileNo) const
+			{ASSERT(wTileNo < TILE_COUNT); return this->Squares[wTileNo].size();}
+	const vector<UINT> &	GetSquares(const UINT wTileNo) const
+			{ASSERT(wTileNo < TILE_COUNT); return this->Squares[wTileNo];}
+	bool			IsBuilt() const {return this->bBuilt;}
+	void			Replace(const UINT wSquareI, const UINT wOldTileNo,
+			const UINT wNewTileNo);
+
+private:
+	void			Add(const UINT wSquareI, const UINT wTileNo);
+	void			Remove(const UINT wSquareI, const UINT wTileNo);
+
+	vector<UINT>	Squares[TILE_COUNT];	//square indices holding each tile, unordered
+	vector<UINT>	Positions[2];	//where each square is in Squares[], for the
+											//o- and t-layers
+	bool			bBuilt;
+};
+
+//******************************************************************************************
+//How many squares sight reaches past each square of a room in each direction
+//before something blocks it, so that a line of sight can be checked without
+//walking it.
+class CSightLines
+{
+public:
+	CSightLines() : wCols(0), wRows(0), bBuilt(false) { }
+
+	void			Build(const char *pszOSquares, const char *pszTSquares,
+			const UINT wCols, const UINT wRows);
+	void			Clear();
+	UINT			GetClearDistance(const UINT wSquareI, const UINT wO) const
+			{ASSERT(this->bBuilt && wO < ORIENTATION_COUNT);
+			return this->Distances[wO * this->wCols * this->wRows + wSquareI];}
+	bool			IsBuilt() const {return this->bBuilt;}
+	static bool	IsSightBlocker(const UINT wOTileNo, const UINT wTTileNo);
+	void			Update(const char *pszOSquares, const char *pszTSquares,
+			const UINT wX, const UINT wY);
+
+private:
+	UINT			CalcClearDistance(const char *pszOSquares, const char *pszTSquares,
+			const UINT wX, const UINT wY, const UINT wO) const;
+
+	UINT			wCols, wRows;
+	vector<USHORT>	Distances;	//clear squares past each square, by orientation
+										//then square
+	bool			bBuilt;
+};
+
+//Squares of a room as the level map shows them.  Kept in memory by CDbRooms so
+//the map can be drawn without loading whole rooms.
+class CRoomMap
+{
+public:
+	void SetTiles(const char *pszOSquares, const char *pszTSquares, const DWORD dwSquareCount);
+
+	DWORD			dwRoomID, dwLevelID;
+	DWORD			dwRoomX, dwRoomY;
+	UINT			wRoomCols, wRoomRows;
+	UINT			wStyle;
+	vector<BYTE>	Tiles;	//T_TAR where tar is, otherwise the o-square tile
+};
+
 //******************************************************************************************
 class CDbRooms;
 class CDbSavedGame;
@@ -252,12 +348,14 @@ public:
 	UINT				wBrainCount;
 	CMonster *			pFirstMonster;
 	CMonster *			pLastMonster;
+	CMonster *			pFirstMonsterOfType[MONSTER_TYPES];	//lists chained by
+																		//CMonster::pNextOfType
 	CMonster **			pMonsterSquares;	//points to monster occupying each square
 	UINT				wScrollCount;
 	CScrollData *		parrScrolls;
 	vector<CExitData*> Exits;
 	UINT				wTrapDoorsLeft;
-	CPathMap *			pPathMap[NumMovementTypes];
+	CPathMap *			pPathMap;			//a layer for each MovementType
 	CDbDemos			Demos;
 	CDbSavedGames		SavedGames;
 
@@ -305,6 +403,9 @@ public:
 	const WCHAR *			GetScrollTextAtSquare(const UINT wX, const UINT wY) const;
 	UINT				GetOSquare(const UINT wX, const UINT wY) const;
 	UINT				GetTSquare(const UINT wX, const UINT wY) const;
+	UINT				GetSightDistance(const UINT wX, const UINT wY, const UINT wO);
+	const vector<UINT> &	GetSquaresWithTile(const UINT wTileNo);
+	UINT				GetTileCount(const UINT wTileNo);
 	void				GrowTar(CCueEvents &CueEvents);
 	void				KillMonster(CMonster *pMonster, CCueEvents &CueEvents);
 	bool				KillMonsterAtSquare(const UINT wX, const UINT wY, CCueEvents &CueEvents);
@@ -349,8 +450,6 @@ public:
    void UpdateExitIDs(const DWORD dwNewHoldID=0, const bool bResetIDs=true);
 
 private:
-	enum tartype {oldtar, newtar, notar};
-
 	void				Clear();
 	void				CloseYellowDoor(const UINT wX, const UINT wY);
 	void				DeletePathMaps();
@@ -358,20 +457,27 @@ private:
 			const MovementType eMovement) const;
 	CMonster*		FindLongMonster(const UINT wX, const UINT wY,
 			const UINT wFromDirection=10) const;
+	UINT				GetDoorComponentAt(const UINT wX, const UINT wY);
 	void				GetLevelPositionDescription_English(WSTRING &wstrDescription,
          const int dx, const int dy, const bool bAbbrev=false);
 	DWORD				GetLocalID() const;
+	const CSightLines &	GetSightLines();
+	UINT				GetStableTarBits(const UINT *pwTar, const UINT wX,
+			const UINT wWord) const;
+	const CTileSquares &	GetTileSquares();
+	void				IndexObjectSquares() const;
 	void				GetNumber_English(const DWORD num, WCHAR *str);
    void           InitRoomStats();
+	void				LabelDoorComponents();
 	void				LinkMonster(CMonster *pMonster);
    void           LinkMonsterSegments();
 	bool				LoadOrbs(c4_View &OrbsView);
 	bool				LoadMonsters(c4_View &MonstersView);
 	bool				LoadScrolls(c4_View &ScrollsView);
 	bool				LoadExits(c4_View &ExitsView);
-	bool				NewTarWouldBeStable(tartype *added_tar, const UINT tx, const UINT ty);
 	void				OpenYellowDoor(const UINT wX, const UINT wY);
 	c4_Bytes *				PackSquares() const;
+	void				PlotDoorComponent(const UINT wComponent, const UINT wTileNo);
 	bool				RemoveLongMonsterPieces(CMonster *pMonster);
 	void				SaveOrbs(c4_View &OrbsView) const;
 	void				SaveMonsters(c4_View &MonstersView) const;
@@ -385,7 +491,22 @@ private:
 	bool				UpdateExisting();
 	bool				UpdateNew();
 
-	list<CMonster *>	DeadMonsters;
+	vector<CMonster *>	DeadMonsters;
+	CTileSquares		TileSquares;	//built when first needed
+	CSightLines			SightLines;		//built when first needed
+	vector<UINT>		TarBits;			//GrowTar() bitboards, reused each turn
+	vector<CDoorComponent> DoorComponents;	//yellow doors in the room
+	vector<UINT>		DoorSquareComponents;	//index into DoorComponents for
+													//each square, or NO_DOOR_COMPONENT
+	bool				bDoorComponentsDirty;	//door squares were plotted since
+													//LabelDoorComponents() was called
+	vector<UINT>		DoorPathMapChanges;	//scratch for PlotDoorComponent()
+	mutable vector<UINT>	OrbSquares;	//index into parrOrbs for each square,
+													//or NO_ROOM_OBJECT
+	mutable vector<UINT>	ScrollSquares;	//likewise, into parrScrolls
+	mutable vector<UINT>	ExitSquares;	//likewise, into Exits
+	mutable bool		bObjectSquaresDirty;	//orbs, scrolls or exits changed
+													//since IndexObjectSquares() was called
 	vector<DWORD> deletedScrollIDs;  //message text IDs to be deleted on Update
 	const CCurrentGame *pCurrentGame;
 };
@@ -411,10 +532,17 @@ public:
 			const DWORD dwRoomY);
 	static CDbRoom *	GetByCoords(const DWORD dwLevelID, const DWORD dwRoomX,
 			const DWORD dwRoomY);
+	static const CRoomMap *	GetMap(const DWORD dwRoomID);
+	static void		GetMapsForLevel(const DWORD dwLevelID,
+			vector<const CRoomMap *> &Maps);
 	virtual CDbRoom *	GetNew();
 
+	static void		ForgetMap(const DWORD dwRoomID);
+	static void		ForgetMaps();
+
 private:
 	virtual void		LoadMembership();
+	static CRoomMap *	LoadMap(c4_View &RoomsView, const DWORD dwRoomI);
 
 	DWORD		dwFilterByLevelID;
 };
@@ -48,37 +48,19 @@ void CEvilEye::Process(
 							//sound or graphical effects.
 {
 	if (!this->isActive && CanFindSwordsman()) {
-		//Check whether evil eye sees player and wakes up.
+		//Check whether evil eye sees player and wakes up.  He must be on the line
+		//the eye faces, with nothing between them blocking sight.
 		const int dx = nGetOX(this->wO);
 		const int dy = nGetOY(this->wO);
-		UINT cx = this->wX, cy = this->wY;
-		bool done = false;
-		while (!done) 
+		const int nDistX = this->pCurrentGame->swordsman.wX - this->wX;
+		const int nDistY = this->pCurrentGame->swordsman.wY - this->wY;
+		const int nSteps = dx ? nDistX * dx : nDistY * dy;
+		if (nSteps > 0 && nDistX == nSteps * dx && nDistY == nSteps * dy &&
+				(UINT)nSteps <= this->pCurrentGame->pRoom->GetSightDistance(
+						this->wX, this->wY, this->wO) + 1)
 		{
-			cx += dx;
-			cy += dy;
-			if (cx == this->pCurrentGame->swordsman.wX &&
-					cy == this->pCurrentGame->swordsman.wY)
-			{
-				this->isActive = true;
-				CueEvents.Add(CID_EvilEyeWoke, this);
-				break;
-			}
-			if (cx >= this->pCurrentGame->pRoom->wRoomCols ||
-			    cy >= this->pCurrentGame->pRoom->wRoomRows)
-				break;
-
-			switch (this->pCurrentGame->pRoom->GetOSquare(cx, cy)) {
-			case T_FLOOR:
-			case T_CHECKPOINT:
-			case T_PIT:
-			case T_DOOR_YO:
-			case T_TRAPDOOR: 
-				if (this->pCurrentGame->pRoom->GetTSquare(cx,cy) != T_ORB)
-					break;
-			default:
-					done = true;
-			}
+			this->isActive = true;
+			CueEvents.Add(CID_EvilEyeWoke, this);
 		}
 	}
 
@@ -71,13 +71,13 @@ const
  	if (this->pCurrentGame->bBrainSensesSwordsman)
 	{
 		SQUARE square;
-		this->pCurrentGame->pRoom->pPathMap[this->eMovement]->GetSquare(this->wX,
-				this->wY, square);
+		this->pCurrentGame->pRoom->pPathMap->GetSquare(this->eMovement,
+				this->wX, this->wY, square);
 		if (square.eState == ok && square.wTargetDist > 2)
 		{
 			//Brain-directed goblin movement.
-			this->pCurrentGame->pRoom->pPathMap[this->eMovement]->GetSquare(
-					x, y, square);
+			this->pCurrentGame->pRoom->pPathMap->GetSquare(
+					this->eMovement, x, y, square);
 			//Discourage diagonal movements.
 			const bool diagonal = ((this->wX - x) && (this->wY - y));
 			return (float)(square.wTargetDist * 2 + (diagonal ? 0.5 : 0));
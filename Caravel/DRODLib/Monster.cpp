@@ -30,6 +30,18 @@
 #include "MonsterFactory.h"
 #include "Mimic.h"
 
+//Monster objects are allocated from slabs and recycled through a free list
+//for each object size, so rooms that keep spawning and killing monsters don't
+//go to the heap every turn.  Slabs are kept for the life of the program.
+struct MONSTER_BLOCK
+{
+	MONSTER_BLOCK *pNext;
+};
+const UINT MONSTER_BLOCK_ALIGN = 8;		//block sizes are multiples of this
+const UINT MONSTER_BLOCK_SIZES = 64;	//larger objects aren't pooled
+const UINT MONSTER_BLOCKS_PER_SLAB = 32;
+static MONSTER_BLOCK *pFreeMonsterBlocks[MONSTER_BLOCK_SIZES] = {NULL};
+
 //
 //CMonster methods.
 //
@@ -47,6 +59,7 @@ CMonster::CMonster(
 	, bIsFirstTurn(false)
 	, eMovement(eMovement)
 	, pNext(NULL), pPrevious(NULL)
+	, pNextOfType(NULL), pPreviousOfType(NULL)
 	, pCurrentGame(pSetCurrentGame)
 {	}
 
@@ -56,11 +69,66 @@ CMonster::~CMonster()
 	Clear();
 }
 
+//*****************************************************************************
+void * CMonster::operator new(
+//Allocates a monster object from the pool for its size.
+//
+//Params:
+	size_t size)	//(in) Size of the derived monster object.
+{
+	const UINT wSizeI = (size + MONSTER_BLOCK_ALIGN - 1) / MONSTER_BLOCK_ALIGN;
+	if (wSizeI >= MONSTER_BLOCK_SIZES)
+		return ::operator new(size);
+
+	MONSTER_BLOCK *&pFree = pFreeMonsterBlocks[wSizeI];
+	if (!pFree)
+	{
+		//Carve a new slab into free blocks of this size.
+		const UINT wBlockSize = wSizeI * MONSTER_BLOCK_ALIGN;
+		char *pSlab = static_cast<char*>(
+				::operator new(wBlockSize * MONSTER_BLOCKS_PER_SLAB));
+		for (UINT wBlockI = MONSTER_BLOCKS_PER_SLAB; wBlockI--; )
+		{
+			MONSTER_BLOCK *pBlock =
+					reinterpret_cast<MONSTER_BLOCK*>(pSlab + wBlockI * wBlockSize);
+			pBlock->pNext = pFree;
+			pFree = pBlock;
+		}
+	}
+
+	MONSTER_BLOCK *pBlock = pFree;
+	pFree = pBlock->pNext;
+	return pBlock;
+}
+
+//*****************************************************************************
+void CMonster::operator delete(
+//Returns a monster object's memory to the pool for its size.
+//
+//Params:
+	void *p,			//(in) Memory of a destroyed monster.
+	size_t size)	//(in) Size of the derived monster object.
+{
+	if (!p) return;
+
+	const UINT wSizeI = (size + MONSTER_BLOCK_ALIGN - 1) / MONSTER_BLOCK_ALIGN;
+	if (wSizeI >= MONSTER_BLOCK_SIZES)
+	{
+		::operator delete(p);
+		return;
+	}
+
+	MONSTER_BLOCK *pBlock = static_cast<MONSTER_BLOCK*>(p);
+	pBlock->pNext = pFreeMonsterBlocks[wSizeI];
+	pFreeMonsterBlocks[wSizeI] = pBlock;
+}
+
 //*****************************************************************************
 void CMonster::Clear()
 //Frees resources and zeroes members.
 {	
 	this->pPrevious=this->pNext=NULL;
+	this->pPreviousOfType=this->pNextOfType=NULL;
 	this->wType=this->wX=this->wY=this->wO=this->wProcessSequence=0;
    this->wPrevX = this->wPrevY = 0;
 	this->bIsFirstTurn=false;
@@ -201,17 +269,16 @@ const
 
 	//Check for mimic sword at square.
 	//Note difference from CDbRoom::DoesSquareContainMimicSword().
-	CMonster *pMonster = this->pCurrentGame->pRoom->pFirstMonster;
+	CMonster *pMonster = this->pCurrentGame->pRoom->pFirstMonsterOfType[M_MIMIC];
 	while (pMonster)
 	{
-		if (pMonster->wType == M_MIMIC && 
-				pMonster != this) //Because it's okay for mimics to walk into their own sword square.
+		if (pMonster != this) //Because it's okay for mimics to walk into their own sword square.
 		{
 			CMimic *pMimic = (CMimic*) pMonster;
 			if (wCol == pMimic->GetSwordX() && wRow == pMimic->GetSwordY())
 				return true;
 		}
-		pMonster = pMonster->pNext;
+		pMonster = pMonster->pNextOfType;
 	}
 
 	//No obstacle.
@@ -239,17 +306,14 @@ bool CMonster::IsSwordWithin(
 const
 {
 	//Check mimic swords.
-	CMonster *pSeek = this->pCurrentGame->pRoom->pFirstMonster;
+	CMonster *pSeek = this->pCurrentGame->pRoom->pFirstMonsterOfType[M_MIMIC];
 	while (pSeek)
 	{
-		if (pSeek->wType == M_MIMIC)
-		{
-			CMimic *pMimic = DYN_CAST(CMimic*, CMonster*, pSeek);
-			if (nDist(this->wX, this->wY, pMimic->GetSwordX(),
-					pMimic->GetSwordY()) <= wSquares)
-				return true;
-		}
-		pSeek = pSeek->pNext;
+		CMimic *pMimic = DYN_CAST(CMimic*, CMonster*, pSeek);
+		if (nDist(this->wX, this->wY, pMimic->GetSwordX(),
+				pMimic->GetSwordY()) <= wSquares)
+			return true;
+		pSeek = pSeek->pNextOfType;
 	}
 
 	//Check player's sword.
@@ -375,8 +439,8 @@ const
 {
 	POINT paths[9];
 	UINT num_paths;
-	this->pCurrentGame->pRoom->pPathMap[this->eMovement]->
-			GetRecPaths(this->wX, this->wY, paths, num_paths);
+	this->pCurrentGame->pRoom->pPathMap->
+			GetRecPaths(this->eMovement, this->wX, this->wY, paths, num_paths);
 	for (UINT i = 0; i < num_paths; i++)
 		if ((UINT)paths[i].x == this->wX && (UINT)paths[i].y == this->wY)
 			break;	//no advantageous brain-directed path found -- beeline
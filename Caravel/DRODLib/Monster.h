@@ -37,7 +37,7 @@
 //USAGE
 //
 //You can derive new monsters from CMonster.  It's necessary to add a new
-//MONSTERTYPE enumeration at the top of MonsterFactory.h and add a switch
+//MONSTERTYPE enumeration at the top of Monster.h and add a switch
 //handler in CMonsterFactory::GetNewMonster() that will construct your new class.
 //Also, add an entry for the monster in TileConstants.h.
 //
@@ -70,6 +70,26 @@
 #include <BackEndLib/MessageIDs.h>
 #include <BackEndLib/AttachableObject.h>
 
+//Monster types.
+enum MONSTERTYPE {
+	M_ROACH=0,
+	M_QROACH,
+	M_REGG,
+	M_GOBLIN,
+	M_NEATHER,
+	M_WWING,
+	M_EYE,
+	M_SERPENT,
+	M_TARMOTHER,
+	M_TARBABY,
+	M_BRAIN,
+	M_MIMIC,
+	M_SPIDER,
+	MONSTER_TYPES
+};
+
+#define IsValidMonsterType(mt)	((mt)>=0 && (mt)<MONSTER_TYPES)
+
 const UINT DEFAULT_PROCESS_SEQUENCE = 1000;
 
 //Within this radius, a monster can sense the player when invisible.
@@ -103,6 +123,9 @@ protected:
 public:
 	virtual ~CMonster(void);
 
+	void *        operator new(size_t size);
+	void          operator delete(void *p, size_t size);
+
 	virtual CMonster *Clone() const=0;
 
 	void          AskYesNo(MESSAGE_ID eMessageID, CCueEvents &CueEvents) const;
@@ -149,6 +172,8 @@ public:
 
 	CMonster *		pNext;	//should be updated by caller when copying a monster
 	CMonster *		pPrevious;
+	CMonster *		pNextOfType;	//in the room's list of monsters of this type,
+	CMonster *		pPreviousOfType;	//likewise updated by caller
 
 protected:
 	const CCurrentGame *	pCurrentGame;
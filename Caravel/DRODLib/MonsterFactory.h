@@ -39,26 +39,6 @@
 
 #include <BackEndLib/Types.h>
 
-//Monster types.
-enum MONSTERTYPE {
-	M_ROACH=0,
-	M_QROACH,
-	M_REGG,
-	M_GOBLIN,
-	M_NEATHER,
-	M_WWING,
-	M_EYE,
-	M_SERPENT,
-	M_TARMOTHER,
-	M_TARBABY,
-	M_BRAIN,
-	M_MIMIC,
-	M_SPIDER,
-	MONSTER_TYPES
-};
-
-#define IsValidMonsterType(mt)	((mt)>=0 && (mt)<MONSTER_TYPES)
-
 class CMonster;
 class CMonsterFactory
 {
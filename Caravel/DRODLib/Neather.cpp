@@ -26,6 +26,45 @@
 #include "Neather.h"
 #include "../Texts/MIDs.h"
 
+//Goal routine for each room the Neather appears in.
+const CNeather::ROOMGOALS CNeather::RoomGoals[] =
+{
+	{50, 2550, &CNeather::GetRoom1Goal},
+	{50, 2549, &CNeather::GetRoom2Goal},
+	{49, 2549, &CNeather::GetRoom3Goal},
+	{48, 2549, &CNeather::GetRoom4Goal},
+	{48, 2550, &CNeather::GetRoom5Goal},
+	{48, 2551, &CNeather::GetRoom6Goal},
+	{48, 2552, &CNeather::GetRoom7Goal},
+	{49, 2552, &CNeather::GetRoom8Goal},
+	{50, 2552, &CNeather::GetRoom9Goal},
+	{50, 2551, &CNeather::GetRoom10Goal},
+	{49, 2551, &CNeather::GetRoom11Goal},
+	{49, 2550, &CNeather::GetRoom12Goal}
+};
+
+//Doors guarded in room 4, once the swordsman is in room E.
+static const NEATHERDOORGUARD Room4DoorGuards[] =
+{
+	{20, 13, 23, 17,  20, 13, 23, 17,  19, 15,  25, 5},	//West door of room E.
+	{22, 18, 25, 24,  22, 18, 25, 24,  21, 21,  24, 5},	//West door of room F.
+	{26,  7, 31, 11,  26,  7, 31, 11,  32,  9,  26, 5},	//West door of room G.
+	{29, 13, 36, 15,  29, 13, 36, 15,  34, 12,  27, 5},	//South door of room G.
+	{13,  3, 19,  7,  13,  3, 19,  7,  16,  4,  22, 5},	//North door of room H.
+	{13,  9, 21, 13,  13,  9, 21, 13,  16, 12,  23, 5}	//South door of room H.
+};
+
+//Doors guarded from the control center in room 6.
+static const NEATHERDOORGUARD Room6DoorGuards[] =
+{
+	{16, 10, 26, 10,  16, 10, 26, 10,  21, 11,  35, 28},
+	{27, 11, 27, 16,  27, 11, 27, 16,  26, 16,  34, 28},
+	{12, 21, 17, 21,  12, 21, 17, 21,  18, 21,  32, 28},
+	{ 6, 13, 12, 19,   6, 13, 12, 19,   9, 16,  33, 28},
+	{ 6, 25, 16, 25,   6, 25, 16, 25,  11, 26,  31, 28},
+	{18, 25, 24, 25,  24, 20, 25, 24,  23, 26,  30, 28}
+};
+
 //
 //Public methods.
 //
@@ -120,46 +159,23 @@ bool CNeather::GetGoal(
 //Returns:
 //true if successful, false otherwise.
 {
-	int nX, nY;
 	bool bRetVal=false;
 	
-	//Call a GetGoalX() routine based on current room.
-	nX=this->pCurrentGame->pRoom->dwRoomX;
-	nY=this->pCurrentGame->pRoom->dwRoomY;
-	switch (nX)
+	//Look up the GetRoomXGoal() routine for the current room the first time.
+	if (!this->pfnGetRoomGoal)
 	{
-		case 48:
-			switch (nY)
-			{
-				case 2549: bRetVal=GetRoom4Goal(pGoal,CueEvents); break;
-				case 2550: bRetVal=GetRoom5Goal(pGoal,CueEvents); break;
-				case 2551: bRetVal=GetRoom6Goal(pGoal,CueEvents); break;
-				case 2552: bRetVal=GetRoom7Goal(pGoal,CueEvents); break;
-				default: ASSERTP(false, "Bad neather room."); break;
-			}
-			 break;
-		case 49:
-			switch (nY)
+		const DWORD dwRoomX=this->pCurrentGame->pRoom->dwRoomX;
+		const DWORD dwRoomY=this->pCurrentGame->pRoom->dwRoomY;
+		for (UINT wIndex=0; wIndex<sizeof(RoomGoals)/sizeof(RoomGoals[0]); ++wIndex)
+			if (RoomGoals[wIndex].dwRoomX==dwRoomX && RoomGoals[wIndex].dwRoomY==dwRoomY)
 			{
-				case 2549: bRetVal=GetRoom3Goal(pGoal,CueEvents);  break;
-				case 2550: bRetVal=GetRoom12Goal(pGoal,CueEvents);  break;
-				case 2551: bRetVal=GetRoom11Goal(pGoal,CueEvents);  break;
-				case 2552: bRetVal=GetRoom8Goal(pGoal,CueEvents);  break;
-				default: ASSERTP(false, "Bad neather room."); break;
-			}
-			break;
-		case 50:
-			switch (nY)
-			{
-				case 2549: bRetVal=GetRoom2Goal(pGoal,CueEvents); break;
-				case 2550: bRetVal=GetRoom1Goal(pGoal,CueEvents); break;
-				case 2551: bRetVal=GetRoom10Goal(pGoal,CueEvents); break;
-				case 2552: bRetVal=GetRoom9Goal(pGoal,CueEvents); break;
-				default: ASSERTP(false, "Bad neather room."); break;
+				this->pfnGetRoomGoal = RoomGoals[wIndex].pfnGetGoal;
+				break;
 			}
-			break;
-		default: ASSERTP(false, "Bad neather room.");; 
-   }//...switch (nX)
+		ASSERTP(this->pfnGetRoomGoal != NULL, "Bad neather room.");
+	}
+	if (this->pfnGetRoomGoal)
+		bRetVal=(this->*pfnGetRoomGoal)(pGoal,CueEvents);
 	
 	if (!bRetVal) {pGoal.eType=wait;}
 	
@@ -226,6 +242,72 @@ inline bool CNeather::SquareFree(
 			this->pCurrentGame->swordsman.wSwordY==sy));
 }
 
+//*****************************************************************************
+UINT CNeather::GetDoorGuardsNearSwordsman(
+//Returns: bit for each door guard whose region the swordsman is in.  The regions
+//are laid out per square the first time a set of guards is used in a room.
+//
+//Params:
+	const NEATHERDOORGUARD *pGuards,	//(in) Door guards, at most 32.
+	const UINT wGuardCount)				//(in)
+{
+	const CDbRoom &room = *this->pCurrentGame->pRoom;
+	if (this->pDoorGuardRegionsFor != pGuards)
+	{
+		ASSERT(wGuardCount <= 32);
+		this->DoorGuardRegions.assign(room.wRoomCols * room.wRoomRows, 0);
+		for (UINT wGuardI=0; wGuardI<wGuardCount; ++wGuardI)
+		{
+			const NEATHERDOORGUARD &guard = pGuards[wGuardI];
+			const UINT wBit = 1 << wGuardI;
+			for (UINT y=0; y<room.wRoomRows; ++y)
+				for (UINT x=0; x<room.wRoomCols; ++x)
+					if (IsInRect(x, y, guard.wLeft, guard.wTop, guard.wRight, guard.wBottom) ||
+							IsInRect(x, y, guard.wLeft2, guard.wTop2, guard.wRight2, guard.wBottom2))
+						this->DoorGuardRegions[y * room.wRoomCols + x] |= wBit;
+		}
+		this->pDoorGuardRegionsFor = pGuards;
+	}
+
+	const UINT swX=this->pCurrentGame->swordsman.wX, swY=this->pCurrentGame->swordsman.wY;
+	if (!room.IsValidColRow(swX, swY))
+		return 0;
+	return this->DoorGuardRegions[swY * room.wRoomCols + swX];
+}
+
+//*****************************************************************************
+bool CNeather::SetDoorGuardGoal(
+//Sets a goal to strike the orb of the first guarded door that is open while the
+//swordsman is near it, or shut while he isn't.
+//
+//Params:
+	const NEATHERDOORGUARD *pGuards,	//(in) Door guards, in order of priority.
+	const UINT wGuardCount,				//(in)
+	const bool bCloseFirst,				//(in) Close doors near the swordsman before
+												//		opening any others.
+	GOAL &pGoal)							//(out) Goal set, if any.
+//
+//Returns:
+//true if a goal was set, false if every door is as it should be.
+{
+	const UINT wNear = GetDoorGuardsNearSwordsman(pGuards, wGuardCount);
+
+	//Guards checked in each pass.
+	const UINT wPassGuards[2] = {bCloseFirst ? wNear : ~0U, bCloseFirst ? ~wNear : 0U};
+	for (UINT wPass=0; wPass<2; ++wPass)
+		for (UINT wGuardI=0; wGuardI<wGuardCount; ++wGuardI)
+		{
+			const UINT wBit = 1 << wGuardI;
+			if (!(wPassGuards[wPass] & wBit))
+				continue;
+			const NEATHERDOORGUARD &guard = pGuards[wGuardI];
+			const bool bNear = (wNear & wBit) != 0;
+			if (bNear == this->pCurrentGame->pRoom->IsDoorOpen(guard.wDoorX, guard.wDoorY))
+				return SetGoal(guard.wOrbX, guard.wOrbY, strikeorb, pGoal);
+		}
+	return false;
+}
+
 //*****************************************************************************
 bool CNeather::OnAnswer(
 //Overridable method for responding to an answer given by player to a question asked by the
@@ -599,24 +681,8 @@ bool CNeather::GetRoom4Goal(
 				}
 
 				//Check for doors that Swordsman is too close too.
-				if ((IsInRect(swX, swY, 20, 13, 23, 17) && this->pCurrentGame->pRoom->IsDoorOpen(19, 15)) ||
-					(!IsInRect(swX, swY, 20, 13, 23, 17) && !this->pCurrentGame->pRoom->IsDoorOpen(19, 15))) //West door of room E.
-					{return SetGoal(25, 5, strikeorb, pGoal);}
-				if ((IsInRect(swX, swY, 22, 18, 25, 24) && this->pCurrentGame->pRoom->IsDoorOpen(21, 21)) ||
-					(!IsInRect(swX, swY, 22, 18, 25, 24) && !this->pCurrentGame->pRoom->IsDoorOpen(21, 21))) //West door of room F.
-					{return SetGoal(24, 5, strikeorb, pGoal);}
-				if ((IsInRect(swX, swY, 26, 7, 31, 11) && this->pCurrentGame->pRoom->IsDoorOpen(32, 9)) ||
-					(!IsInRect(swX, swY, 26, 7, 31, 11) && !this->pCurrentGame->pRoom->IsDoorOpen(32, 9))) //West door of room G.
-					{return SetGoal(26, 5, strikeorb, pGoal);}
-				if ((IsInRect(swX, swY, 29, 13, 36, 15) && this->pCurrentGame->pRoom->IsDoorOpen(34, 12)) ||
-					(!IsInRect(swX, swY, 29, 13, 36, 15) && !this->pCurrentGame->pRoom->IsDoorOpen(34, 12))) //South door of room G.
-					{return SetGoal(27, 5, strikeorb, pGoal);}
-				if ((IsInRect(swX, swY, 13, 3, 19, 7) && this->pCurrentGame->pRoom->IsDoorOpen(16, 4)) ||
-					(!IsInRect(swX, swY, 13, 3, 19, 7) && !this->pCurrentGame->pRoom->IsDoorOpen(16, 4))) //North door of room H.
-					{return SetGoal(22, 5, strikeorb, pGoal);}
-				if ((IsInRect(swX, swY, 13, 9, 21, 13) && this->pCurrentGame->pRoom->IsDoorOpen(16, 12)) ||
-					(!IsInRect(swX, swY, 13, 9, 21, 13) && !this->pCurrentGame->pRoom->IsDoorOpen(16, 12))) //South door of room H.
-					{return SetGoal(23, 5, strikeorb, pGoal);}
+				SetDoorGuardGoal(Room4DoorGuards,
+						sizeof(Room4DoorGuards)/sizeof(Room4DoorGuards[0]), false, pGoal);
 			return true;
 
 			case rx_stFleeing:   //Flee to fork.
@@ -920,8 +986,6 @@ bool CNeather::GetRoom6Goal(
 {
 	bool bRetVal=false;
 	
-	const UINT swX=this->pCurrentGame->swordsman.wX, swY=this->pCurrentGame->swordsman.wY;
-
 	//Get Neather state.
 	if (this->m_CurrentState==0) this->m_CurrentState = rx_stx;
 			
@@ -954,37 +1018,12 @@ bool CNeather::GetRoom6Goal(
 					break;
 				}
 										
-				//Close any open doors that Swordsman is too close to.
-				if (IsInRect(swX, swY, 16, 10, 26, 10) && this->pCurrentGame->pRoom->IsDoorOpen(21, 11))
-					{return SetGoal(35, 28, strikeorb, pGoal);}
-				if (IsInRect(swX, swY, 27, 11, 27, 16) && this->pCurrentGame->pRoom->IsDoorOpen(26, 16))
-					{return SetGoal(34, 28, strikeorb, pGoal);}
-				if (IsInRect(swX, swY, 12, 21, 17, 21) && this->pCurrentGame->pRoom->IsDoorOpen(18, 21))
-					{return SetGoal(32, 28, strikeorb, pGoal);}
-				if (IsInRect(swX, swY, 6, 13, 12, 19) && this->pCurrentGame->pRoom->IsDoorOpen(9, 16))
-					{return SetGoal(33, 28, strikeorb, pGoal);}
-				if (IsInRect(swX, swY, 6, 25, 16, 25) && this->pCurrentGame->pRoom->IsDoorOpen(11, 26))
-					{return SetGoal(31, 28, strikeorb, pGoal);}
-				if ((IsInRect(swX, swY, 18, 25, 24, 25) || IsInRect(swX, swY, 24, 20, 25, 24))
-				 && this->pCurrentGame->pRoom->IsDoorOpen(23, 26))
-					{return SetGoal(30, 28, strikeorb, pGoal);}
-				
-				//Open whatever doors Swordsman isn't close to.
-				if (!IsInRect(swX, swY, 16, 10, 26, 10) && !this->pCurrentGame->pRoom->IsDoorOpen(21, 11))
-					{return SetGoal(35, 28, strikeorb, pGoal);}
-				if (!IsInRect(swX, swY, 27, 11, 27, 16) && !this->pCurrentGame->pRoom->IsDoorOpen(26, 16))
-					{return SetGoal(34, 28, strikeorb, pGoal);}
-				if (!IsInRect(swX, swY, 12, 21, 17, 21) && !this->pCurrentGame->pRoom->IsDoorOpen(18, 21))
-					{return SetGoal(32, 28, strikeorb, pGoal);}
-				if (!IsInRect(swX, swY, 6, 13, 12, 19) && !this->pCurrentGame->pRoom->IsDoorOpen(9, 16))
-					{return SetGoal(33, 28, strikeorb, pGoal);}
-				if (!IsInRect(swX, swY, 6, 25, 16, 25) && !this->pCurrentGame->pRoom->IsDoorOpen(11, 26))
-					{return SetGoal(31, 28, strikeorb, pGoal);}
-				if (!(IsInRect(swX, swY, 18, 25, 24, 25) || IsInRect(swX, swY, 24, 20, 25, 24))
-				 && !this->pCurrentGame->pRoom->IsDoorOpen(23, 26))
-					{return SetGoal(30, 28, strikeorb, pGoal);}
-				//Just wait.
-				return true;
+				//Close any open doors that Swordsman is too close to,
+				//then open whatever doors Swordsman isn't close to.
+				//Otherwise just wait.
+				SetDoorGuardGoal(Room6DoorGuards,
+						sizeof(Room6DoorGuards)/sizeof(Room6DoorGuards[0]), true, pGoal);
+			return true;
 			
 			case r6_PreparingEscapeRoute:  //Close south doors so it is safe to flee.
 				if (this->pCurrentGame->pRoom->IsDoorOpen(23, 26))
@@ -33,6 +33,9 @@
 #include "Monster.h"
 #include "MonsterFactory.h"
 
+#include <vector>
+using std::vector;
+
 typedef enum tagNeatherState
 // The following convention was used in the naming of the enumerations
 // rx = State consistent in all rooms
@@ -154,12 +157,22 @@ typedef struct tagGoal
 	int nX, nY;
 } GOAL;
 
+//A door the Neather keeps shut while the swordsman is near it, and open otherwise.
+typedef struct tagNeatherDoorGuard
+{
+	UINT wLeft, wTop, wRight, wBottom;		//Swordsman is near the door in this rect...
+	UINT wLeft2, wTop2, wRight2, wBottom2;	//...or in this one.
+	UINT wDoorX, wDoorY;	//A square of the door.
+	UINT wOrbX, wOrbY;		//Orb that toggles the door.
+} NEATHERDOORGUARD;
+
 class CNeather : public CMonster
 {
 public:
 	CNeather(CCurrentGame *pSetCurrentGame = NULL) : CMonster(M_NEATHER,
 		pSetCurrentGame, GROUND, 200)
-		, bStrikingOrb(false), bLaughWhenOrbHit(false) { }
+		, bStrikingOrb(false), pfnGetRoomGoal(NULL)
+		, pDoorGuardRegionsFor(NULL), bLaughWhenOrbHit(false) { }
 	IMPLEMENT_CLONE(CMonster, CNeather)
 
 	virtual bool IsAggressive(void) {return false;}
@@ -179,6 +192,19 @@ public:
 	bool bStrikingOrb;
 
 private:
+	typedef bool (CNeather::*GETROOMGOAL)(GOAL &pGoal, CCueEvents &CueEvents);
+	typedef struct tagRoomGoals
+	{
+		DWORD dwRoomX, dwRoomY;
+		GETROOMGOAL pfnGetGoal;
+	} ROOMGOALS;
+	static const ROOMGOALS RoomGoals[];
+
+	UINT GetDoorGuardsNearSwordsman(const NEATHERDOORGUARD *pGuards,
+			const UINT wGuardCount);
+	bool SetDoorGuardGoal(const NEATHERDOORGUARD *pGuards, const UINT wGuardCount,
+			const bool bCloseFirst, GOAL &pGoal);
+
 	bool GetRoom1Goal(GOAL &pGoal, CCueEvents &CueEvents);
 	bool GetRoom2Goal(GOAL &pGoal, CCueEvents &CueEvents);
 	bool GetRoom3Goal(GOAL &pGoal, CCueEvents &CueEvents);
@@ -197,6 +223,12 @@ private:
 	GOAL m_CurrentGoal;
 	NEATHERSTATE m_CurrentState;
 
+	GETROOMGOAL pfnGetRoomGoal;	//goal routine for the current room, once looked up
+	const NEATHERDOORGUARD *pDoorGuardRegionsFor;	//door guards DoorGuardRegions
+																//was built for
+	vector<UINT> DoorGuardRegions;	//for each square, bit for each door guard that
+												//the swordsman is near there
+
 	bool bLaughWhenOrbHit;	//set during call to SetGoal()
 };
 
@@ -46,46 +46,38 @@ const int m_dyDir[]={-1, -1, -1, 0, 0, 0, 1, 1, 1}; //y offsets that correspond
 
 //**********************************************************************************
 CPathMap::CPathMap(
-//Constructor.  Sets object vars to default values and allocates and initializes the map squares and immediate
-//recalc arrays.
+//Constructor.  Sets object vars to default values and allocates and initializes the map squares.
+//Layer 0 is enabled; other layers are calculated once enabled with EnableLayer().
 //
 //Accepts:
 	const UINT wCols, const UINT wRows, //Size to initialize map to.
-	POINT xyTarget)
+	POINT xyTarget,
+	const UINT wLayers)						//Number of obstacle layers (default=1).
 	: bConstructorSuccess(false)
 	, wCols(wCols)
 	, wRows(wRows)
-	, lpSquares(NULL)
 	, xyTarget(xyTarget)
-	, lpxyImmRecalc(NULL)
+	, wLayers(wLayers)
+	, bytEnabledLayers(0)
+	, bytRequestedLayers(0)
+	, bytHeldLayers(0)
+	, wWaveDistance(0)
 {
-	UINT wSquareI;
-	SQUARE *pSquare;
+	ASSERT(wLayers && wLayers <= MAX_PATHMAP_LAYERS);
 
-	//Allocate map.
+	//Allocate map.  Every square starts out as a non-obstacle needing recalc.
 	const UINT wArea=wCols*wRows;
-	this->lpSquares=new SQUARE[wArea];
-	if (this->lpSquares==NULL) {ASSERTP(false, "Alloc failed."); return;}
-
-	//Initialize all of the map squares.
-	for (wSquareI=wArea; wSquareI--; )
-	{
-		this->lpSquares[wSquareI].eState=recalc;
-		this->lpSquares[wSquareI].eDirection=none;
-	}
-
-	//Allocate immediate recalc array
-	this->lpxyImmRecalc=new POINT[wArea];
-	if (!this->lpxyImmRecalc) {ASSERTP(false, "Alloc failed.(2)");}
+	this->ObstacleLayers.resize(wArea, 0);
+	this->CalcLayers.resize(wArea, 0);
+	this->WaveLayers.resize(wArea, 0);
+	this->NextWaveLayers.resize(wArea, 0);
+	this->Distances.resize(wArea*wLayers, 0);
+	this->Directions.resize(wArea*wLayers, none);
+	this->Wave.reserve(wArea);
+	this->NextWave.reserve(wArea);
 
 	//Get squares ready for recalc.
-	pSquare = this->lpSquares + GetSquareIndex(this->xyTarget);
-	pSquare->eDirection=none;
-	pSquare->eState=ok;
-	pSquare->wTargetDist=0;
-	this->wNumImmRecalcs=1;
-	this->lpxyImmRecalc[0]=this->xyTarget;
-	this->wImmRecalcI=0;
+	EnableLayer(0);
 
 	this->bConstructorSuccess=true;
 }
@@ -94,8 +86,6 @@ CPathMap::CPathMap(
 CPathMap::~CPathMap(void)
 //Destructor.
 {
-	delete [] this->lpSquares;
-	delete [] this->lpxyImmRecalc;
 }
 
 //**********************************************************************************
@@ -109,94 +99,116 @@ bool CPathMap::CalcPaths(
 //Returns:
 //true if requested path calculations are completed, false if not.
 {
-	UINT wImmRecI;
-	UINT wNewImmRecalcs;
-	UINT x, y;
-	SQUARE *pSquare;
-	UINT wLowestScore, wScore;
-	SQUARE *pScoreSquare;
-
-	if (this->IsCalcDone())
-		return true;
-
-	//Get current distance from target of calculated squares by looking at the
-	//first square in the imm recalc array.
-	UINT wDistance=this->lpSquares[GetSquareIndex(this->lpxyImmRecalc[0])].wTargetDist;
-	
-	//If a maximum distance has been specified, see if I've already reached it.
-	if (wMaxDistance && wDistance>=wMaxDistance)
-		goto IncompletePathMap;
+	//Paths for every layer are wanted now.
+	RequestPaths();
 
 	//Main loop--the perimeter of squares to be calculated reaches one square farther out from the
 	//target each iteration.  Loop and function will exit (return true) if it runs out of squares to 
 	//calculate.  Loop will exit if maximum range criteria has been specified and met.
-	while (true)
+	while (!this->IsCalcDone())
 	{
-		//Add new squares to immediate recalculation array by finding eligible squares adjacent to
-		//the current imm rec squares.
-		wNewImmRecalcs=this->wNumImmRecalcs;
-		for (wImmRecI = 0; wImmRecI < wNewImmRecalcs; wImmRecI++)
-		{					
-			x = this->lpxyImmRecalc[wImmRecI].x;
-			y = this->lpxyImmRecalc[wImmRecI].y;
-					
-			//Check every adjacent square for recalc eligibility.
-			for (DIRECTION dir = (DIRECTION)0; dir<DIR_COUNT; dir++)
-			{
-				if (dir == none)
-					continue;
-
-				const UINT nx = x + m_dxDir[dir];
-				const UINT ny = y + m_dyDir[dir];
-				
-				if (nx >= this->wCols || ny >= this->wRows)
-					continue;
-
-				pSquare = this->lpSquares + (ny*this->wCols + nx);
-
-				if (pSquare->eState == recalc)
-				{
-					pSquare->eState = immediate; 
-					this->lpxyImmRecalc[this->wNumImmRecalcs].x = nx;
-					this->lpxyImmRecalc[this->wNumImmRecalcs].y = ny;
-					++this->wNumImmRecalcs;
-				}
-			}
-		}
-						
-		//See if any squares were added to imm rec.
-		if (this->wNumImmRecalcs == wNewImmRecalcs)
-		{//Nope--done with calculating paths.
-			this->wNumImmRecalcs = 0;
+		//If a maximum distance has been specified, see if I've already reached it.
+		if (wMaxDistance && this->wWaveDistance>=wMaxDistance)
+		{
+		  	//Exit without completing.
 #ifdef DEBUG_PATHMAP
 			{
-				string strOutput = "---Complete Pathmap---\r\n";
-				GetDebugOutput(true,false,false,strOutput);
+				string strOutput = "---Incomplete Pathmap---\r\n";
+				GetDebugOutput(0,true,false,false,strOutput);
 				strOutput += "\r\n";
-				GetDebugOutput(false,true,false,strOutput);
+				GetDebugOutput(0,false,true,false,strOutput);
 				DEBUGPRINT(strOutput.begin());
 			}
+#endif //DEBUG_PATHMAP
+			return false;
+		}
+
+		CalcNextWave();
+	}
+
+#ifdef DEBUG_PATHMAP
+	{
+		string strOutput = "---Complete Pathmap---\r\n";
+		GetDebugOutput(0,true,false,false,strOutput);
+		strOutput += "\r\n";
+		GetDebugOutput(0,false,true,false,strOutput);
+		DEBUGPRINT(strOutput.begin());
+	}
 #endif // DEBUG_PATHMAP
-			return true;
+	return true;
+}
+
+//**********************************************************************************
+bool CPathMap::CalcNextWave(void)
+//Calculates paths for the squares one farther from the target than the current wave,
+//for every layer at once, and makes them the new wave.
+//
+//Returns:
+//true if any squares were calculated, false if the calculation is done.
+{
+	const UINT wArea = this->wCols*this->wRows;
+	vector<UINT>::const_iterator iSquare;
+
+	//Add new squares to the next wave by finding squares adjacent to the current
+	//wave that are not obstacles and haven't been calculated, in each layer.
+	ASSERT(this->NextWave.empty());
+	for (iSquare = this->Wave.begin(); iSquare != this->Wave.end(); ++iSquare)
+	{
+		const BYTE bytLayers = this->WaveLayers[*iSquare];
+		const UINT x = GetCol(*iSquare);
+		const UINT y = GetRow(*iSquare);
+
+		//Check every adjacent square for recalc eligibility.
+		for (DIRECTION dir = (DIRECTION)0; dir<DIR_COUNT; dir++)
+		{
+			if (dir == none)
+				continue;
+
+			const UINT nx = x + m_dxDir[dir];
+			const UINT ny = y + m_dyDir[dir];
+			if (nx >= this->wCols || ny >= this->wRows)
+				continue;
+
+			const UINT wNeighborI = GetSquareIndex(nx, ny);
+			const BYTE bytAdd = bytLayers & ~(this->ObstacleLayers[wNeighborI] |
+					this->CalcLayers[wNeighborI] | this->NextWaveLayers[wNeighborI]);
+			if (bytAdd)
+			{
+				if (!this->NextWaveLayers[wNeighborI])
+					this->NextWave.push_back(wNeighborI);
+				this->NextWaveLayers[wNeighborI] |= bytAdd;
+			}
 		}
+	}
 
-		//Move the new immediate recalculations up the array to the beginning.
-		memmove((void *) this->lpxyImmRecalc,
-				(void *) &this->lpxyImmRecalc[wNewImmRecalcs],
-				(size_t) (sizeof(POINT) * (this->wNumImmRecalcs-wNewImmRecalcs)));
-		this->wNumImmRecalcs -= wNewImmRecalcs;
-			
-		//For every square in the immediate recalculation array:
-		for (wImmRecI = 0; wImmRecI < this->wNumImmRecalcs; wImmRecI++)
+	//The current wave is finished with.
+	for (iSquare = this->Wave.begin(); iSquare != this->Wave.end(); ++iSquare)
+		this->WaveLayers[*iSquare] = 0;
+	this->Wave.clear();
+
+	//See if any squares were added.
+	if (this->NextWave.empty())
+		return false;	//Nope--done with calculating paths.
+
+	//For every square in the next wave, in each of its layers:
+	for (iSquare = this->NextWave.begin(); iSquare != this->NextWave.end(); ++iSquare)
+	{
+		const UINT wSquareI = *iSquare;
+		const UINT x = GetCol(wSquareI);
+		const UINT y = GetRow(wSquareI);
+		const BYTE bytLayers = this->NextWaveLayers[wSquareI];
+
+		for (UINT wLayer = 0; wLayer < this->wLayers; ++wLayer)
 		{
-			x = this->lpxyImmRecalc[wImmRecI].x;
-			y = this->lpxyImmRecalc[wImmRecI].y;
-			ASSERT(x <= this->wCols && y <= this->wRows);
-			pSquare = this->lpSquares + (y * this->wCols + x);
+			const BYTE bytLayer = 1 << wLayer;
+			if (!(bytLayers & bytLayer))
+				continue;
 
-			//Score all adjacent squares for movement towards the target.
-			wLowestScore=10000;
+			const USHORT *const pDistances = &this->Distances[wLayer*wArea];
+			BYTE &bytDirection = this->Directions[wLayer*wArea + wSquareI];
 
+			//Score all adjacent squares for movement towards the target.
+			UINT wLowestScore=10000;
 			for (DIRECTION dir = (DIRECTION)0; dir<DIR_COUNT; dir++)
 			{
 				if (dir == none)
@@ -208,18 +220,17 @@ bool CPathMap::CalcPaths(
 				const UINT ny = y + dy;
 				const bool perp = (!dx != !dy);  // horz or vert movement
 
-				pScoreSquare = this->lpSquares + (ny*this->wCols + nx);
-
 				if (nx >= this->wCols || ny >= this->wRows)
 					continue;
 
-				if (pScoreSquare->eState == ok)
+				const UINT wNeighborI = GetSquareIndex(nx, ny);
+				if (this->CalcLayers[wNeighborI] & bytLayer)
 				{
-					wScore = pScoreSquare->wTargetDist * 2 + (perp ? 0 : 1);
+					const UINT wScore = pDistances[wNeighborI] * 2 + (perp ? 0 : 1);
 					if (wScore < wLowestScore) 
 					{
 						wLowestScore = wScore; 
-						pSquare->eDirection = dir;
+						bytDirection = dir;
 					}
 				}
 			}
@@ -227,35 +238,84 @@ bool CPathMap::CalcPaths(
 			//Set direction and target distance from adjacent square with lowest score.
 			if (wLowestScore == 10000) //Surrounded by obstacles and/or uncalculated squares.
 			{
-				pSquare->eDirection = none;		//Nowhere to go!
-				pSquare->wTargetDist = 10000;   //Ensures no other squares will point to this one.
+				bytDirection = none;		//Nowhere to go!
+				this->Distances[wLayer*wArea + wSquareI] = 10000;   //Ensures no other squares will point to this one.
 			} else {
-				pSquare->wTargetDist = wDistance + 1;  //Distance counter that increments 1 per loop.
+				this->Distances[wLayer*wArea + wSquareI] = this->wWaveDistance + 1;  //Distance counter that increments 1 per loop.
 			}
-					
-			//Square doesn't need recalculation anymore.
-			pSquare->eState = ok;
 		}
 
-		++wDistance;
-			
-		//Continue main loop?
-		if (wMaxDistance && wDistance>=wMaxDistance)
-			break;
-	} //...while (true)
-
-IncompletePathMap:
-  	//Exit without completing.
-#ifdef DEBUG_PATHMAP
-	{
-		string strOutput = "---Incomplete Pathmap---\r\n";
-		GetDebugOutput(true,false,false,strOutput);
-		strOutput += "\r\n";
-		GetDebugOutput(false,true,false,strOutput);
-		DEBUGPRINT(strOutput.begin());
+		//Square doesn't need recalculation anymore.
+		this->CalcLayers[wSquareI] |= bytLayers;
 	}
-#endif //DEBUG_PATHMAP
-  	return false;
+
+	//The next wave becomes the current one.
+	this->Wave.swap(this->NextWave);
+	this->WaveLayers.swap(this->NextWaveLayers);
+	++this->wWaveDistance;
+
+	return true;
+}
+
+//**********************************************************************************
+bool CPathMap::AreSquaresCalculated(
+//Determines whether the squares around a square have had their paths calculated in
+//a layer.  Obstacles count as calculated, since they never get paths.
+//
+//Accepts:
+	const BYTE bytLayer,				//Bit of layer to check.
+	const UINT wX, const UINT wY,	//Square at center.
+	const UINT wRadius)				//Squares this far from it are checked too.
+//
+//Returns:
+//true if they all have, false if not.
+const
+{
+	const UINT wEndX = wX + wRadius < this->wCols ? wX + wRadius : this->wCols - 1;
+	const UINT wEndY = wY + wRadius < this->wRows ? wY + wRadius : this->wRows - 1;
+	for (UINT y = wY >= wRadius ? wY - wRadius : 0; y <= wEndY; ++y)
+		for (UINT x = wX >= wRadius ? wX - wRadius : 0; x <= wEndX; ++x)
+		{
+			const UINT wSquareI = GetSquareIndex(x, y);
+			if (!((this->CalcLayers[wSquareI] | this->ObstacleLayers[wSquareI]) & bytLayer))
+				return false;
+		}
+	return true;
+}
+
+//**********************************************************************************
+void CPathMap::CalcSquares(
+//If paths have been requested for a layer, calculates them out as far as the squares
+//around a square.  Work done is kept for later queries until the map is reset.
+//
+//Accepts:
+	const UINT wLayer,
+	const UINT wX, const UINT wY,	//Square at center.
+	const UINT wRadius)				//Squares this far from it are needed too.
+{
+	const BYTE bytLayer = 1 << wLayer;
+	if (!(this->bytRequestedLayers & bytLayer))
+		return;	//paths would not be calculated yet
+
+	while (!this->Wave.empty() && !AreSquaresCalculated(bytLayer, wX, wY, wRadius))
+		CalcNextWave();
+}
+
+//**********************************************************************************
+void CPathMap::EnableLayer(
+//Starts calculating paths for a layer.  Until its squares are set, the layer has
+//no obstacles.
+//
+//Accepts:
+	const UINT wLayer)
+{
+	ASSERT(wLayer < this->wLayers);
+	const BYTE bytLayer = 1 << wLayer;
+	if (this->bytEnabledLayers & bytLayer)
+		return;
+
+	this->bytEnabledLayers |= bytLayer;
+	ResetLayers(bytLayer);
 }
 
 //**********************************************************************************
@@ -263,6 +323,7 @@ void CPathMap::GetRecPaths(
 //Gets recommended paths to take from a specified square in order to get to the target.
 //
 //Accepts:
+	const UINT wLayer,				//Layer of obstacles to move through.
 	const UINT wX, const UINT wY, //Square to request paths from.
 //
 //Returns by parameter:
@@ -270,8 +331,12 @@ void CPathMap::GetRecPaths(
 	//Should pass a pointer to memory allocated as an array of POINT[9].  9 is number
 	//of possible directions.
 	UINT &wNumPaths)			//Number of recommended paths returned.
-const
 {
+	ASSERT(IsLayerEnabled(wLayer));
+	CalcSquares(wLayer, wX, wY, 1);
+
+	const BYTE bytLayer = 1 << wLayer;
+	const USHORT *const pDistances = &this->Distances[wLayer*this->wCols*this->wRows];
 	int dx, dy;
 	UINT wSquareI;
 	UINT diagonalScore;
@@ -290,15 +355,14 @@ const
 				if (xTo<this->wCols)
 				{
 					wSquareI=GetSquareIndex(xTo,yTo);
-					if (!(this->lpSquares[wSquareI].eState==obstacle || 
-						  this->lpSquares[wSquareI].eState==recalc) )
+					if (this->CalcLayers[wSquareI] & bytLayer)
 					{
 						//Add the square to array.
 						diagonalScore = (dx && dy) ? 2 : !dx && !dy ? 1 : 0;	//discourage diagonal moves and sitting still
 						sortPoints[wNumPaths].xy.x=xTo;
 						sortPoints[wNumPaths].xy.y=yTo;
 						sortPoints[wNumPaths].wScore =
-								this->lpSquares[wSquareI].wTargetDist*3 + diagonalScore;
+								pDistances[wSquareI]*3 + diagonalScore;
 						++wNumPaths;
 					}
 				} //...if (xTo<=this->wCols)
@@ -318,47 +382,107 @@ const
 
 //**********************************************************************************
 void CPathMap::GetSquare(
-//Gets a specified map square.  Object functions access square array directly.
+//Gets a specified map square in one layer.
 //
 //Accepts:
+	const UINT wLayer,
 	const UINT wX, const UINT wY,
-//this->lpSquares
+//
+//Returns by parameter:
+	SQUARE &lpSquare)
+{	
+	ASSERT(IsLayerEnabled(wLayer));
+	CalcSquares(wLayer, wX, wY, 0);
+	ReadSquare(wLayer, GetSquareIndex(wX,wY), lpSquare);
+}
+
+//**********************************************************************************
+void CPathMap::ReadSquare(
+//Gets a map square in one layer as it is, without calculating anything.
+//
+//Accepts:
+	const UINT wLayer,
+	const UINT wSquareI,
 //
 //Returns by parameter:
 	SQUARE &lpSquare)
 const
 {	
-	lpSquare=this->lpSquares[GetSquareIndex(wX,wY)];
+	const BYTE bytLayer = 1 << wLayer;
+	const UINT wLayerSquareI = wLayer*this->wCols*this->wRows + wSquareI;
+
+	lpSquare.eState = (this->CalcLayers[wSquareI] & bytLayer) ? ok :
+			(this->ObstacleLayers[wSquareI] & bytLayer) ? obstacle : recalc;
+	lpSquare.wTargetDist = this->Distances[wLayerSquareI];
+	lpSquare.eDirection = (DIRECTION)this->Directions[wLayerSquareI];
+}
+
+//***************************************************************************
+void CPathMap::RequestPaths(void)
+//Requests paths for all enabled layers.  Rather than calculating them now, squares
+//are calculated as queries need them, with the same results.  Resetting a layer
+//drops its request.
+{
+	this->bytRequestedLayers = this->bytEnabledLayers;
+	if (this->bytHeldLayers)
+		ResetLayers(0);	//start the wave for held layers
 }
 
 //***************************************************************************
 void CPathMap::Reset(void)
-//Sets all the map squares so that they need recalculation.
+//Sets all the map squares so that they need recalculation, in every layer.
+{
+	ResetLayers(this->bytEnabledLayers);
+}
+
+//***************************************************************************
+void CPathMap::ResetLayers(
+//Sets the map squares of some layers so that they need recalculation, and drops
+//any request for their paths.  Paths still being calculated for other layers are
+//restarted along with them, since they share a wave.  Only requested layers join
+//the wave; the rest are held until they are requested.
 //
 //Accepts:
-//this->wCols
-//this->wRows
+	const BYTE bytLayers)	//(in) Bit for each layer to reset.
 //
 //Changes:
-//this->lpSquares
+//this->CalcLayers, this->Wave, this->bytRequestedLayers, this->bytHeldLayers
 {
-	const UINT wLastSquareI=this->wRows*this->wCols;
-	
-	//Initialize all of the map squares.
-	for (UINT wSquareI=0; wSquareI<wLastSquareI; wSquareI++) 
-	{//Every square's state is either obstacle or recalc.
-		if (this->lpSquares[wSquareI].eState!=obstacle)
-			this->lpSquares[wSquareI].eState=recalc;
+	vector<UINT>::const_iterator iSquare;
+	BYTE bytRestart = bytLayers | this->bytHeldLayers;
+	for (iSquare = this->Wave.begin(); iSquare != this->Wave.end(); ++iSquare)
+	{
+		bytRestart |= this->WaveLayers[*iSquare];
+		this->WaveLayers[*iSquare] = 0;
 	}
-	
-	//Get squares ready for recalc.
-	SQUARE *const pSquare = this->lpSquares + GetSquareIndex(this->xyTarget);
-	pSquare->eDirection=none;
-	pSquare->eState=ok;
-	pSquare->wTargetDist=0;
-	this->wNumImmRecalcs=1;
-	this->lpxyImmRecalc[0]=this->xyTarget;
-	this->wImmRecalcI=0;
+	bytRestart &= this->bytEnabledLayers;
+	this->bytRequestedLayers &= ~bytLayers;
+
+	//Every square's state is either obstacle or recalc.
+	const UINT wArea=this->wRows*this->wCols;
+	const BYTE bytKeep = ~bytRestart;
+	for (UINT wSquareI=0; wSquareI<wArea; wSquareI++) 
+		this->CalcLayers[wSquareI] &= bytKeep;
+
+	//Get squares ready for recalc.  The target is never an obstacle.
+	const UINT wTargetI = GetSquareIndex(this->xyTarget);
+	for (UINT wLayer = 0; wLayer < this->wLayers; ++wLayer)
+		if (bytRestart & (1 << wLayer))
+		{
+			this->Distances[wLayer*wArea + wTargetI] = 0;
+			this->Directions[wLayer*wArea + wTargetI] = none;
+		}
+	this->ObstacleLayers[wTargetI] &= bytKeep;
+	this->CalcLayers[wTargetI] |= bytRestart;
+
+	this->Wave.clear();
+	this->bytHeldLayers = bytRestart & ~this->bytRequestedLayers;
+	if (bytRestart & this->bytRequestedLayers)
+	{
+		this->Wave.push_back(wTargetI);
+		this->WaveLayers[wTargetI] = bytRestart & this->bytRequestedLayers;
+	}
+	this->wWaveDistance=0;
 }
 
 //**********************************************************************************
@@ -380,40 +504,55 @@ void CPathMap::SetTarget(
 
 //*****************************************************************************
 void CPathMap::SetSquare(
-//Intended for calls outside object.  Sets the state of a specified square to obstacle or not an 
-//obstacle.  Other states are not allowed.
+//Intended for calls outside object.  Sets a specified square in one layer to
+//obstacle or not an obstacle.
 //
 //Accepts:
+	const UINT wLayer,
 	const UINT wX, const UINT wY, 
 	const bool bIsObstacle)	
 //
 //Changes:
-//this->lpSquares
+//this->ObstacleLayers
 {
-	SQUARE *const pSquare = this->lpSquares + GetSquareIndex(wX,wY);
-		
-	switch (pSquare->eState)
+	ASSERT(IsLayerEnabled(wLayer));
+	const BYTE bytLayer = 1 << wLayer;
+	BYTE &bytObstacle = this->ObstacleLayers[GetSquareIndex(wX,wY)];
+	if (!(bytObstacle & bytLayer) != !bIsObstacle)
 	{
-	case ok:
-	case recalc:
-	case immediate:
-		if (bIsObstacle)
-		{
-			pSquare->eState=obstacle;
-			Reset();
-		}
-		break;
+		bytObstacle ^= bytLayer;
+		ResetLayers(bytLayer);
+	}
+}
 
-	case obstacle:
-		if (!bIsObstacle)
+//*****************************************************************************
+void CPathMap::SetSquares(
+//Like SetSquare(), but for many squares at once.  The layer is only reset once,
+//after all of them have been set.
+//
+//Accepts:
+	const UINT wLayer,
+	const vector<UINT> &SquareIndices,	//(in) Squares, as y * wCols + x.
+	const bool bIsObstacle)
+//
+//Changes:
+//this->ObstacleLayers
+{
+	ASSERT(IsLayerEnabled(wLayer));
+	const BYTE bytLayer = 1 << wLayer;
+	bool bChanged = false;
+	for (vector<UINT>::const_iterator iSquare = SquareIndices.begin();
+			iSquare != SquareIndices.end(); ++iSquare)
+	{
+		ASSERT(*iSquare < this->wCols * this->wRows);
+		BYTE &bytObstacle = this->ObstacleLayers[*iSquare];
+		if (!(bytObstacle & bytLayer) != !bIsObstacle)
 		{
-			pSquare->eState=recalc;
-			Reset();
+			bytObstacle ^= bytLayer;
+			bChanged = true;
 		}
-		break;
-
-	default: ASSERTP(false, "Bad square state.");
 	}
+	if (bChanged) ResetLayers(bytLayer);
 }
 
 //*****************************************************************************
@@ -429,7 +568,13 @@ int CPathMap::GetDYFromDir(const DIRECTION eDir) {return m_dyDir[eDir];}
 //*****************************************************************************
 bool CPathMap::IsCalcDone(void) const
 {
-	return (!this->wNumImmRecalcs);
+	return this->Wave.empty() && !this->bytHeldLayers;
+}
+
+//*****************************************************************************
+bool CPathMap::IsLayerEnabled(const UINT wLayer) const
+{
+	return wLayer < this->wLayers && (this->bytEnabledLayers & (1 << wLayer)) != 0;
 }
 
 //*****************************************************************************
@@ -494,6 +639,7 @@ void CPathMap::GetDebugOutput(
 //Gets output-formatted representation of pathmap for debugging purposes.
 //
 //Params:
+	const UINT wLayer,		//(in)		Layer to show.
 	bool bShowDirection,	//(in)		Show direction attribute of squares?
 	bool bShowState,		//(in)		Show state attribute of squares?
 	bool bShowDistance,		//(in)		Show distance attribute of squares?
@@ -511,7 +657,7 @@ const
 	//Distance
 	//00 to 99, and -- for larger than 99.
 
-	if (!this->lpSquares)
+	if (!IsLayerEnabled(wLayer))
 	{
 		strOutput += "Pathmap not initialized.\r\n";
 		return;
@@ -521,7 +667,7 @@ const
 	szChar[1] = '\0';
 	char szDistance[3];
 
-	SQUARE *pSquare = this->lpSquares;
+	SQUARE square;
 
 	//Each iteration concats output for one row of squares.
 	for (UINT wRowI = 0; wRowI < this->wRows; ++wRowI)
@@ -529,32 +675,33 @@ const
 		//Each iteration concats output for one square.
 		for (UINT wColI = 0; wColI < this->wCols; ++wColI)
 		{
+			ReadSquare(wLayer, GetSquareIndex(wColI, wRowI), square);
+
 			//Append direction for square.
 			if (bShowDirection)
 			{
-				szChar[0] = szarrDirection[pSquare->eDirection];
+				szChar[0] = szarrDirection[square.eDirection];
 				strOutput += szChar;
 			}
 
 			//Append state for square.
 			if (bShowState)
 			{
-				szChar[0] = szarrState[pSquare->eState];
+				szChar[0] = szarrState[square.eState];
 				strOutput += szChar;
 			}
 			
 			//Append distance for square.
 			if (bShowDistance)
 			{
-				if (pSquare->wTargetDist < 100)
+				if (square.wTargetDist < 100)
 				{
-					_itoa(pSquare->wTargetDist, szDistance, 10);
+					_itoa(square.wTargetDist, szDistance, 10);
 					strOutput += szDistance;
 				}
 				else
 					strOutput += "--";
 			}
-			++pSquare;
 		}
 
 		//Append end of row CR/LF.
@@ -44,7 +44,9 @@
 #include <BackEndLib/Assert.h>
 
 #include <string>
+#include <vector>
 using std::string;
+using std::vector;
 
 //Path map square that contains only information needed for determining paths.
 enum DIRECTION {nw, n, ne, w, none, e, sw, s, se, DIR_COUNT};
@@ -69,46 +71,84 @@ typedef struct tagSortPoint
 	UINT wScore;
 } SORTPOINT;
 
+//Most layers (obstacle rules, e.g. one per movement type) a path map can hold.
+const UINT MAX_PATHMAP_LAYERS = 8;
+
+//Paths to one target for several layers of obstacles at once.  Each square
+//keeps a bit per layer for its obstacle and calculated states, and a compact
+//distance and direction per layer.  Paths for all enabled layers are found by
+//the same wavefront.
 class CPathMap
 {
 	public:
 	//Public functions.
-	CPathMap(const UINT wCols, const UINT wRows, POINT xyTarget);
+	CPathMap(const UINT wCols, const UINT wRows, POINT xyTarget,
+			const UINT wLayers=1);
 	~CPathMap(void);
 	bool CalcPaths(const UINT wMaxDistance=0);
-	void GetDebugOutput(bool bShowDirection, bool bShowState, bool bShowDistance, 
-			string &strOutput) const;
+	void EnableLayer(const UINT wLayer);
+	void GetDebugOutput(const UINT wLayer, bool bShowDirection, bool bShowState,
+			bool bShowDistance, string &strOutput) const;
 	static int GetDXFromDir(const DIRECTION eDir);
 	static int GetDYFromDir(const DIRECTION eDir);
-	void GetRecPaths(const UINT wX, const UINT wY, POINT *lpxyPath,
-			UINT &wNumPaths) const;
-	void GetSquare(const UINT wX, const UINT wY, SQUARE &lpSquare) const;
+	void GetRecPaths(const UINT wLayer, const UINT wX, const UINT wY,
+			POINT *lpxyPath, UINT &wNumPaths);
+	void GetSquare(const UINT wLayer, const UINT wX, const UINT wY,
+			SQUARE &lpSquare);
 	bool IsCalcDone(void) const;
+	bool IsLayerEnabled(const UINT wLayer) const;
+	void RequestPaths(void);
 	void Reset(void);
-	void SetSquare(const UINT wX, const UINT wY, const bool bIsObstacle);	
+	void SetSquare(const UINT wLayer, const UINT wX, const UINT wY,
+			const bool bIsObstacle);
+	void SetSquares(const UINT wLayer, const vector<UINT> &SquareIndices,
+			const bool bIsObstacle);
 	void SetTarget(const POINT xyTarget);
 
 	//Public data.
 	bool bConstructorSuccess;
 	UINT wCols;
 	UINT wRows;
-	SQUARE *lpSquares;
 
 private:
 	//Private functions.
+	bool					AreSquaresCalculated(const BYTE bytLayer, const UINT wX,
+			const UINT wY, const UINT wRadius) const;
+	bool					CalcNextWave(void);
+	void					CalcSquares(const UINT wLayer, const UINT wX,
+			const UINT wY, const UINT wRadius);
 	inline UINT			GetCol(const UINT wSquareIndex) const;
 	static inline DIRECTION	GetDirFromDxDy(const UINT dx, const UINT dy);
 	inline UINT			GetRow(const UINT wSquareIndex) const;
 	inline UINT			GetSquareIndex(const POINT xy) const;
 	inline UINT			GetSquareIndex(const UINT x, const UINT y) const;
+	void					ReadSquare(const UINT wLayer, const UINT wSquareI,
+			SQUARE &lpSquare) const;
+	void					ResetLayers(const BYTE bytLayers);
 	static void				StableSortPoints(const UINT nElements,
 			SORTPOINT *lpSortPoints);
 
 	//Private data.
 	POINT xyTarget;
-	UINT wNumImmRecalcs;
-	UINT wImmRecalcI;
-	POINT *lpxyImmRecalc;	
+	UINT wLayers;
+	BYTE bytEnabledLayers;			//bit for each layer that paths are found for
+	BYTE bytRequestedLayers;		//bit for each layer whose paths are calculated
+											//as far as queries need them
+	BYTE bytHeldLayers;				//bit for each reset layer waiting for a request
+											//to join the wave
+	vector<BYTE> ObstacleLayers;	//for each square, bit for each layer where
+											//it's an obstacle
+	vector<BYTE> CalcLayers;		//for each square, bit for each layer where
+											//its path has been calculated
+	vector<USHORT> Distances;		//distance from target, by layer then square
+	vector<BYTE> Directions;		//DIRECTION to move, by layer then square
+
+	UINT wWaveDistance;				//distance of squares in Wave from target
+	vector<UINT> Wave;				//squares calculated last, whose neighbors
+											//are calculated next
+	vector<BYTE> WaveLayers;		//for each square, bits for layers it's in Wave for
+	vector<UINT> NextWave;			//scratch for CalcNextWave()
+	vector<BYTE> NextWaveLayers;
 
 	PREVENT_DEFAULT_COPY(CPathMap);
 };
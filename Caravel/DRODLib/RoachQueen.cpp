@@ -125,8 +125,8 @@ void CRoachQueen::GetBrainDirectedMovement(
 const
 {
 	SQUARE square;
-	this->pCurrentGame->pRoom->pPathMap[this->eMovement]->GetSquare(this->wX,
-			this->wY, square);
+	this->pCurrentGame->pRoom->pPathMap->GetSquare(this->eMovement,
+			this->wX, this->wY, square);
 	if (square.eState == ok && square.eDirection != none)
 	{
 		//Run away from swordsman, based on the direction of the pathmap.
@@ -35,6 +35,7 @@
 //*****************************************************************************************
 CSerpent::CSerpent(const MONSTERTYPE eSerpentType, CCurrentGame *pSetCurrentGame)
 	: CMonster(eSerpentType, pSetCurrentGame)
+	, bodyStart(0), bodyLength(0)
 	, foundTail(false)
 {
 }
@@ -108,6 +109,8 @@ bool CSerpent::LengthenHead(
 		Move(this->wX + dx, this->wY + dy);
 		//add segment to the old spot (wX and wY were just updated)
 		this->pCurrentGame->pRoom->Plot(this->wX - dx, this->wY - dy, tile, this);
+		if (this->foundTail)
+			AddSegmentBehindHead(this->wX - dx, this->wY - dy);
 
 		wO = nGetO(dx, dy);
 		return true;
@@ -126,38 +129,43 @@ bool CSerpent::ShortenTail(
 //Params:
 	CCueEvents &CueEvents)	//(in/out)
 {
-	int dx = nGetOX(this->tailO);
-	int dy = nGetOY(this->tailO);
-	ASSERT((dx==0) != (dy==0));	//always moving, no diagonals
-	
-	this->pCurrentGame->pRoom->Plot(this->tailX, this->tailY, T_EMPTY);
-	this->tailX += dx;
-	this->tailY += dy;
-	if (this->tailX == this->wX && this->tailY == this->wY) 
+	ASSERT(this->foundTail && this->bodyLength);
+	CDbRoom *pRoom = this->pCurrentGame->pRoom;
+
+	const POINT &oldTail = GetSegment(this->bodyLength - 1);
+	pRoom->Plot(oldTail.x, oldTail.y, T_EMPTY);
+	if (--this->bodyLength == 0)
 	{
+		//Tail has reached the head.
 		CueEvents.Add(CID_SnakeDiedFromTruncation, this);
 		return true;
 	}
 
-	UINT tile = this->pCurrentGame->pRoom->GetTSquare(
-			this->tailX, this->tailY);
-	int t;
-	switch (tile)
+	//New tail points toward the next segment, or the head.
+	const POINT &tail = GetSegment(this->bodyLength - 1);
+	int dx, dy;
+	if (this->bodyLength > 1)
 	{
-		case T_SNK_NS: case T_SNK_EW: break;
-		case T_SNK_NW: case T_SNK_SE: t = dx; dx = -dy; dy = -t; break;
-		case T_SNK_NE: case T_SNK_SW: t = dx; dx = dy; dy = t; break;
-		default: ASSERTP(false, "Bad tile.");
+		const POINT &next = GetSegment(this->bodyLength - 2);
+		dx = next.x - tail.x;
+		dy = next.y - tail.y;
+	} else {
+		dx = this->wX - tail.x;
+		dy = this->wY - tail.y;
 	}
+	ASSERT((dx==0) != (dy==0));	//always moving, no diagonals
+	ASSERT(bIsSerpent(pRoom->GetTSquare(tail.x, tail.y)));
+
+	UINT tile;
 	switch (nGetO(dx, dy))
 	{
-		case N: tile = T_SNKT_S; this->tailO = N; break;
-		case S: tile = T_SNKT_N; this->tailO = S; break;
-		case E: tile = T_SNKT_W; this->tailO = E; break;
-		case W: tile = T_SNKT_E; this->tailO = W; break;
-		default: ASSERTP(false, "Bad orientation.(2)");
+		case N: tile = T_SNKT_S; break;
+		case S: tile = T_SNKT_N; break;
+		case E: tile = T_SNKT_W; break;
+		case W: tile = T_SNKT_E; break;
+		default: ASSERTP(false, "Bad orientation.(2)"); return false;
 	}
-	this->pCurrentGame->pRoom->Plot(this->tailX, this->tailY, tile, this);
+	pRoom->Plot(tail.x, tail.y, tile, this);
 
 	return false;
 }
@@ -199,8 +207,8 @@ const
 {
 	POINT paths[9];
 	UINT num_paths;
-	this->pCurrentGame->pRoom->pPathMap[this->eMovement]->GetRecPaths(this->wX,
-			this->wY, paths, num_paths);
+	this->pCurrentGame->pRoom->pPathMap->GetRecPaths(this->eMovement,
+			this->wX, this->wY, paths, num_paths);
 	
 	for (UINT i = 0; i < num_paths; i++)
 	{
@@ -259,9 +267,13 @@ void CSerpent::GetTail(
 //Params:
 	UINT &wTailX, UINT &wTailY)	//(out) Coords of tail
 {
-	FindTail();	//always look for the tail
-	wTailX = this->tailX;
-	wTailY = this->tailY;
+	//The editor plots and erases serpent tiles directly, without going through
+	//LengthenHead() and ShortenTail(), so the body is rebuilt from the tiles.
+	FindTail();
+	ASSERT(this->bodyLength);
+	const POINT &tail = GetSegment(this->bodyLength - 1);
+	wTailX = tail.x;
+	wTailY = tail.y;
 }
 
 //
@@ -365,7 +377,8 @@ bool CSerpent::CanMoveTo(
 
 //*****************************************************************************************
 void CSerpent::FindTail(void)
-// Starting from head, traverse room tiles to find position of its tail.
+// Starting from head, traverse room tiles to find the segments of the body,
+// through to its tail.
 // Assumes a valid serpent.
 {
 	int dx = -(int)nGetOX(this->wO);
@@ -374,11 +387,17 @@ void CSerpent::FindTail(void)
 	int x = this->wX, y = this->wY;
 	bool done = false;
 	UINT tile;
+	this->body.clear();
+	this->bodyStart = 0;
 	while (!done)
 	{
 		int t;
 		x += dx;
 		y += dy;
+		POINT segment;
+		segment.x = x;
+		segment.y = y;
+		this->body.push_back(segment);
 		tile = pCurrentGame->pRoom->GetTSquare(x, y);
 		ASSERT(bIsSerpent(tile));
 		switch (tile) 
@@ -393,12 +412,34 @@ void CSerpent::FindTail(void)
 		default: ASSERTP(false, "Bad serpent tile.(2)");
 		}
 	}
-	this->tailX = x;
-	this->tailY = y;
-	this->tailO = nGetO(-dx, -dy);
+	this->bodyLength = this->body.size();
 	this->foundTail = true;
 }
 
+//*****************************************************************************************
+void CSerpent::AddSegmentBehindHead(
+//Adds a segment to the front of the body, where the head just left.
+//
+//Params:
+	const UINT x, const UINT y)	//(in) Square of the new segment
+{
+	if (this->bodyLength == this->body.size())
+	{
+		//Ring buffer is full -- unroll it into a larger one.
+		vector<POINT> grown(this->body.size() ? this->body.size() * 2 : 8);
+		for (UINT i = 0; i < this->bodyLength; ++i)
+			grown[i] = GetSegment(i);
+		this->body.swap(grown);
+		this->bodyStart = 0;
+	}
+
+	this->bodyStart = (this->bodyStart + this->body.size() - 1) % this->body.size();
+	POINT &segment = this->body[this->bodyStart];
+	segment.x = x;
+	segment.y = y;
+	++this->bodyLength;
+}
+
 // $Log: Serpent.cpp,v $
 // Revision 1.28  2003/10/06 02:41:20  erikh2000
 // Added descriptions to assertions.
@@ -42,6 +42,9 @@
 #include "Monster.h"
 #include "MonsterFactory.h"
 
+#include <vector>
+using std::vector;
+
 class CSerpent : public CMonster
 {
 public:
@@ -65,7 +68,14 @@ protected:
 	void GetNormalMovement(int&, int&) const;
 	bool CanMoveTo(const int x, const int y) const;
 
-	UINT tailX, tailY, tailO;
+	const POINT& GetSegment(const UINT i) const
+		{return this->body[(this->bodyStart + i) % this->body.size()];}
+	void AddSegmentBehindHead(const UINT x, const UINT y);
+
+	//Body segments from the one behind the head to the tail, kept in a ring
+	//buffer matching the room's serpent tiles once foundTail is set.
+	vector<POINT> body;
+	UINT bodyStart, bodyLength;
 	bool foundTail;
 };
 
@@ -80,6 +80,8 @@
 
 #define bIsSerpent(t)   ( (t) >= T_SNK_EW && (t) <= T_SNKT_E )
 
+#define bIsYellowDoor(t)   ( (t) == T_DOOR_Y || (t) == T_DOOR_YO )
+
 
 //Add to monster values so they don't overlap o- and t-layer values on a tile.
 //NOTE: Make sure list matches that in MonsterFactory.h.
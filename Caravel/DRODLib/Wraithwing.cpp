@@ -57,11 +57,10 @@ void CWraithWing::Process(
 	{
 		// Let's look for another wraith-wing, ready to pounce.
 		bool runaway = true;
-		for (CMonster *pSeek = this->pCurrentGame->pRoom->pFirstMonster;
-		     pSeek != NULL; pSeek = pSeek->pNext)
+		for (CMonster *pSeek = this->pCurrentGame->pRoom->pFirstMonsterOfType[M_WWING];
+		     pSeek != NULL; pSeek = pSeek->pNextOfType)
 		{
-			if (pSeek->wType != M_WWING ||
-			    (pSeek->wX == this->wX && pSeek->wY == this->wY))
+			if (pSeek->wX == this->wX && pSeek->wY == this->wY)
 				continue;
 			const int dist2 = nDist(pSeek->wX, pSeek->wY, 
 					this->pCurrentGame->swordsman.wX, this->pCurrentGame->swordsman.wY);
@@ -0,0 +1,264 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is Deadly Rooms of Death.
+ *
+ * The Initial Developer of the Original Code is
+ * Caravel Software.
+ * Portions created by the Initial Developer are Copyright (C) 2005
+ * Caravel Software. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+
+//AudioBackend.cpp
+//Implementation of the simulated audio backends and CreateAudioBackend().
+
+#include "AudioBackend.h"
+#include "FmodAudioBackend.h"
+#include "SDLMixerAudioBackend.h"
+#include "Widget.h"
+#include <BackEndLib/Files.h>
+
+//
+//CNullAudioBackend public methods.
+//
+
+//**********************************************************************************
+bool CNullAudioBackend::Init(
+//Nothing to initialize.  Music is always available.
+//
+//Returns:
+//True.
+	const UINT /*wModuleChannelCount*/, const UINT /*wSampleChannelCount*/,
+	string &/*strInitLog*/)
+{
+	this->bMusicAvailable = true;
+	return true;
+}
+
+//**********************************************************************************
+SAMPLEHANDLE CNullAudioBackend::LoadSample(
+//Keeps a sample's name.  The data isn't looked at.
+//
+//Params:
+	const BYTE * /*pData*/, const UINT /*dwSize*/,
+	const WCHAR *pwszFilepath)	//(in)	File the sample came from.
+{
+	return NewSimulatedSound(pwszFilepath);
+}
+
+//**********************************************************************************
+void CNullAudioBackend::FreeSample(SAMPLEHANDLE hSample)
+{
+	delete static_cast<SIMULATEDSOUND *>(hSample);
+}
+
+//**********************************************************************************
+SONGHANDLE CNullAudioBackend::LoadSong(
+//Keeps a song's name.  The data isn't looked at.
+//
+//Params:
+	const BYTE * /*pData*/, const UINT /*dwSize*/,
+	const WCHAR *pwszFilepath)	//(in)	File the song came from.
+{
+	return NewSimulatedSound(pwszFilepath);
+}
+
+//**********************************************************************************
+void CNullAudioBackend::FreeSong(SONGHANDLE hSong)
+{
+	delete static_cast<SIMULATEDSOUND *>(hSong);
+}
+
+//**********************************************************************************
+int CNullAudioBackend::GetSongVolume(SONGHANDLE hSong)
+{
+	return static_cast<SIMULATEDSOUND *>(hSong)->nVolume;
+}
+
+//**********************************************************************************
+void CNullAudioBackend::SetSongVolume(SONGHANDLE hSong, const int nVolume)
+{
+	static_cast<SIMULATEDSOUND *>(hSong)->nVolume = nVolume;
+}
+
+//
+//CNullAudioBackend protected methods.
+//
+
+//**********************************************************************************
+SIMULATEDSOUND * CNullAudioBackend::NewSimulatedSound(
+//Makes a simulated sample or song named after the file it came from.
+//
+//Params:
+	const WCHAR *pwszFilepath)	//(in)	Full path to the file.
+{
+	SIMULATEDSOUND *pSound = new SIMULATEDSOUND;
+	UnicodeToAscii(pwszFilepath, pSound->strName);
+	const string::size_type nSlash = pSound->strName.find_last_of(SLASH);
+	if (nSlash != string::npos)
+		pSound->strName.erase(0, nSlash + 1);
+	pSound->nVolume = 255;
+	return pSound;
+}
+
+//
+//CRecordingAudioBackend public methods.
+//
+
+//**********************************************************************************
+CRecordingAudioBackend::CRecordingAudioBackend(
+//Constructor.
+//
+//Params:
+	const char *pszLogFilepath)	//(in)	File to write the log to, or "-" or NULL
+								//		for stdout.
+	: pLogFile(stdout), bCloseLogFile(false), dwStartTime(0)
+{
+	if (pszLogFilepath && strcmp(pszLogFilepath, "-") != 0)
+	{
+		this->pLogFile = fopen(pszLogFilepath, "w");
+		this->bCloseLogFile = (this->pLogFile != NULL);
+	}
+}
+
+//**********************************************************************************
+CRecordingAudioBackend::~CRecordingAudioBackend(void)
+//Destructor.
+{
+	if (this->bCloseLogFile) fclose(this->pLogFile);
+}
+
+//**********************************************************************************
+bool CRecordingAudioBackend::Init(
+//Starts the log.  Logged times are msecs from here.
+//
+//Params:
+	const UINT wModuleChannelCount,	//(in)	Channels set aside for songs.
+	const UINT wSampleChannelCount,	//(in)	Channels for samples.
+	string &strInitLog)				//(in/out)	Appended to if the log can't be written.
+//
+//Returns:
+//True if the log file could be opened, false if not.
+{
+	if (!this->pLogFile)
+	{
+		strInitLog += "  The audio log file couldn't be created.\r\n";
+		return false;
+	}
+
+	CNullAudioBackend::Init(wModuleChannelCount, wSampleChannelCount, strInitLog);
+	this->dwStartTime = GetAnimationTicks();
+	fprintf(this->pLogFile, "#msecs event args (sample channels %u-%u)\n",
+			wModuleChannelCount, wModuleChannelCount + wSampleChannelCount - 1);
+	return true;
+}
+
+//**********************************************************************************
+void CRecordingAudioBackend::Deinit(void)
+{
+	if (this->pLogFile) fflush(this->pLogFile);
+}
+
+//**********************************************************************************
+bool CRecordingAudioBackend::PlaySample(const int nChannel, SAMPLEHANDLE hSample)
+{
+	char szArgs[300];
+	sprintf(szArgs, "%d %.256s", nChannel,
+			static_cast<SIMULATEDSOUND *>(hSample)->strName.c_str());
+	LogEvent("play-sample", szArgs);
+	return true;
+}
+
+//**********************************************************************************
+bool CRecordingAudioBackend::StopChannel(const int nChannel)
+{
+	char szArgs[16];
+	sprintf(szArgs, "%d", nChannel);
+	LogEvent("stop-channel", szArgs);
+	return true;
+}
+
+//**********************************************************************************
+bool CRecordingAudioBackend::PlaySong(SONGHANDLE hSong)
+{
+	LogEvent("play-song", static_cast<SIMULATEDSOUND *>(hSong)->strName.c_str());
+	return true;
+}
+
+//**********************************************************************************
+bool CRecordingAudioBackend::StopSong(SONGHANDLE hSong)
+{
+	LogEvent("stop-song", static_cast<SIMULATEDSOUND *>(hSong)->strName.c_str());
+	return true;
+}
+
+//
+//CRecordingAudioBackend private methods.
+//
+
+//**********************************************************************************
+void CRecordingAudioBackend::LogEvent(
+//Writes one line to the log.
+//
+//Params:
+	const char *pszEvent,	//(in)	What happened.
+	const char *pszArgs)	//(in)	What it happened to.
+{
+	if (!this->pLogFile) return;
+	fprintf(this->pLogFile, "%8lu %s %s\n",
+			(unsigned long)(GetAnimationTicks() - this->dwStartTime), pszEvent, pszArgs);
+}
+
+//**********************************************************************************
+CAudioBackend * CreateAudioBackend(
+//Makes an audio backend.
+//
+//Params:
+	const AUDIOBACKENDTYPE eType,	//(in)	Which backend.
+	const char *pszLogFilepath)		//(in)	Log file for ABT_Recording (default = NULL,
+									//		meaning stdout).
+//
+//Returns:
+//The new backend, or NULL if that backend isn't in this build.
+{
+	switch (eType)
+	{
+		case ABT_Default:
+#ifdef USE_FMOD
+			return new CFmodAudioBackend;
+#elif defined(USE_SDL_MIXER)
+			return new CSDLMixerAudioBackend;
+#else
+			return new CNullAudioBackend;
+#endif
+		case ABT_FMOD:
+#ifdef USE_FMOD
+			return new CFmodAudioBackend;
+#else
+			return NULL;
+#endif
+		case ABT_SDLMixer:
+#ifdef USE_SDL_MIXER
+			return new CSDLMixerAudioBackend;
+#else
+			return NULL;
+#endif
+		case ABT_Null: return new CNullAudioBackend;
+		case ABT_Recording: return new CRecordingAudioBackend(pszLogFilepath);
+		default: ASSERTP(false, "Bad audio backend type."); return NULL;
+	}
+}
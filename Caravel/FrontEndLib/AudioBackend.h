@@ -0,0 +1,199 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is Deadly Rooms of Death.
+ *
+ * The Initial Developer of the Original Code is
+ * Caravel Software.
+ * Portions created by the Initial Developer are Copyright (C) 2005
+ * Caravel Software. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+
+//AudioBackend.h
+//Declarations for CAudioBackend and the simulated backends.
+//Interface CSound uses to load and play samples and songs.
+
+#ifndef AUDIOBACKEND_H
+#define AUDIOBACKEND_H
+
+#ifdef WIN32
+#pragma warning(disable:4786)
+#endif
+
+#include <BackEndLib/Assert.h>
+#include <BackEndLib/Types.h>
+#include <BackEndLib/Wchar.h>
+
+#include <stdio.h>
+#include <string>
+
+using namespace std;
+
+//Backends compiled in.  FMOD is built everywhere but IRIX unless NO_FMOD is
+//defined.  SDL_mixer is built when USE_SDL_MIXER is defined.
+#if !defined(__sgi) && !defined(NO_FMOD)
+#	define USE_FMOD
+#endif
+
+//Opaque handles to loaded samples and songs.  What they point to is up to the
+//backend.
+typedef void *	SAMPLEHANDLE;
+typedef void *	SONGHANDLE;
+
+//Called when a note plays for a song's lyric instrument.  May be called from
+//the backend's mixer thread, so it has to be quick.
+typedef void (*LYRICCALLBACK)(void);
+
+//Backends that CreateAudioBackend() can make.
+enum AUDIOBACKENDTYPE
+{
+	ABT_Default,	//FMOD, or SDL_mixer in builds without FMOD
+	ABT_FMOD,
+	ABT_SDLMixer,
+	ABT_Null,		//plays nothing
+	ABT_Recording	//plays nothing, but logs what would have played and when
+};
+
+//Interface to a sound library.  Channels are numbered from zero.  Sample
+//channels come after the channels set aside for songs.  Volumes range from
+//0 (silent) to 255 (full).
+class CAudioBackend
+{
+public:
+	CAudioBackend(void) : bMusicAvailable(false), bCrossfadeAvailable(false) {}
+	virtual ~CAudioBackend(void) {}
+
+	bool			IsCrossfadeAvailable(void) const {return this->bCrossfadeAvailable;}
+	bool			IsMusicAvailable(void) const {return this->bMusicAvailable;}
+
+	//A simulated backend doesn't play anything, so CSound neither reads sound
+	//files for it nor starts its audio thread.
+	virtual bool	IsSimulated(void) const {return false;}
+
+	virtual bool	Init(const UINT wModuleChannelCount, const UINT wSampleChannelCount,
+			string &strInitLog)=0;
+	virtual void	Deinit(void)=0;
+
+	virtual SAMPLEHANDLE LoadSample(const BYTE *pData, const UINT dwSize,
+			const WCHAR *pwszFilepath)=0;
+	virtual void	FreeSample(SAMPLEHANDLE hSample)=0;
+	virtual DWORD	GetChannelMSecsLeft(const int nChannel)=0;
+	virtual bool	IsChannelPlaying(const int nChannel)=0;
+	virtual bool	PlaySample(const int nChannel, SAMPLEHANDLE hSample)=0;
+	virtual bool	ReserveChannel(const int nChannel)=0;
+	virtual void	SetSampleVolume(const int nVolume)=0;
+	virtual bool	StopChannel(const int nChannel)=0;
+
+	virtual SONGHANDLE LoadSong(const BYTE *pData, const UINT dwSize,
+			const WCHAR *pwszFilepath)=0;
+	virtual void	FreeSong(SONGHANDLE hSong)=0;
+	virtual int		GetSongVolume(SONGHANDLE hSong)=0;
+	virtual bool	IsSongFinished(SONGHANDLE hSong)=0;
+	virtual bool	PlaySong(SONGHANDLE hSong)=0;
+	virtual bool	SetLyricCallback(SONGHANDLE hSong, const int nInstrumentNo,
+			LYRICCALLBACK pfnCallback)=0;
+	virtual void	SetSongVolume(SONGHANDLE hSong, const int nVolume)=0;
+	virtual bool	StopSong(SONGHANDLE hSong)=0;
+
+	//Restarts a song that has played through once, for backends that can't
+	//loop a song and still tell when it finishes.  CSound's audio thread calls
+	//this whenever it wakes.  Returns true if it should be called again soon.
+	virtual bool	ContinueSongs(void) {return false;}
+
+protected:
+	bool			bMusicAvailable;
+	bool			bCrossfadeAvailable;
+
+	PREVENT_DEFAULT_COPY(CAudioBackend);
+};
+
+//A sample or song loaded by a simulated backend.
+typedef struct tagSimulatedSound
+{
+	string			strName;	//filename, without path
+	int				nVolume;	//songs only
+} SIMULATEDSOUND;
+
+//Backend that plays nothing.  Every channel is always free and every song
+//has always finished.
+class CNullAudioBackend : public CAudioBackend
+{
+public:
+	CNullAudioBackend(void) {}
+
+	virtual bool	IsSimulated(void) const {return true;}
+
+	virtual bool	Init(const UINT wModuleChannelCount, const UINT wSampleChannelCount,
+			string &strInitLog);
+	virtual void	Deinit(void) {}
+
+	virtual SAMPLEHANDLE LoadSample(const BYTE *pData, const UINT dwSize,
+			const WCHAR *pwszFilepath);
+	virtual void	FreeSample(SAMPLEHANDLE hSample);
+	virtual DWORD	GetChannelMSecsLeft(const int /*nChannel*/) {return 0L;}
+	virtual bool	IsChannelPlaying(const int /*nChannel*/) {return false;}
+	virtual bool	PlaySample(const int /*nChannel*/, SAMPLEHANDLE /*hSample*/) {return true;}
+	virtual bool	ReserveChannel(const int /*nChannel*/) {return true;}
+	virtual void	SetSampleVolume(const int /*nVolume*/) {}
+	virtual bool	StopChannel(const int /*nChannel*/) {return true;}
+
+	virtual SONGHANDLE LoadSong(const BYTE *pData, const UINT dwSize,
+			const WCHAR *pwszFilepath);
+	virtual void	FreeSong(SONGHANDLE hSong);
+	virtual int		GetSongVolume(SONGHANDLE hSong);
+	virtual bool	IsSongFinished(SONGHANDLE /*hSong*/) {return true;}
+	virtual bool	PlaySong(SONGHANDLE /*hSong*/) {return true;}
+	virtual bool	SetLyricCallback(SONGHANDLE /*hSong*/, const int /*nInstrumentNo*/,
+			LYRICCALLBACK /*pfnCallback*/) {return false;}
+	virtual void	SetSongVolume(SONGHANDLE hSong, const int nVolume);
+	virtual bool	StopSong(SONGHANDLE /*hSong*/) {return true;}
+
+protected:
+	static SIMULATEDSOUND * NewSimulatedSound(const WCHAR *pwszFilepath);
+};
+
+//Backend that plays nothing, but writes a line for each sample and song that
+//would have started or stopped.  Times are from the animation clock, so runs
+//on a simulated clock log simulated times.
+class CRecordingAudioBackend : public CNullAudioBackend
+{
+public:
+	CRecordingAudioBackend(const char *pszLogFilepath);
+	virtual ~CRecordingAudioBackend(void);
+
+	virtual bool	Init(const UINT wModuleChannelCount, const UINT wSampleChannelCount,
+			string &strInitLog);
+	virtual void	Deinit(void);
+
+	virtual bool	PlaySample(const int nChannel, SAMPLEHANDLE hSample);
+	virtual bool	StopChannel(const int nChannel);
+
+	virtual bool	PlaySong(SONGHANDLE hSong);
+	virtual bool	StopSong(SONGHANDLE hSong);
+
+private:
+	void			LogEvent(const char *pszEvent, const char *pszArgs);
+
+	FILE *			pLogFile;
+	bool			bCloseLogFile;
+	DWORD			dwStartTime;
+};
+
+CAudioBackend *	CreateAudioBackend(const AUDIOBACKENDTYPE eType,
+		const char *pszLogFilepath=NULL);
+
+#endif //...#ifndef AUDIOBACKEND_H
@@ -46,6 +46,10 @@ CBitmapManager *g_pTheBM = NULL;
 int CBitmapManager::CX_TILE = 0;
 int CBitmapManager::CY_TILE = 0;
 
+//Resident tile sets and decoded bitmaps are freed, least recently used first,
+//to stay under this many bytes.  The active set is never evicted.
+static const DWORD DEFAULT_TILESET_MEMORY_CAP = 4096L * 1024L;
+
 //
 //Public methods.
 //
@@ -56,8 +60,14 @@ CBitmapManager::CBitmapManager()
 	, TileImageTypes(NULL)
 	, bIsColorKeySet(false)
 	, wTileCount(0)
+	, pLoaderThread(NULL)
+	, bStopLoader(false)
+	, dwTileSetMemoryCap(DEFAULT_TILESET_MEMORY_CAP)
 //Constructor.
 {
+	this->pLoaderLock = SDL_CreateMutex();
+	this->pLoaderWake = SDL_CreateCond();
+	this->pLoaderDone = SDL_CreateCond();
 }
 
 //**********************************************************************************
@@ -68,10 +78,18 @@ CBitmapManager::~CBitmapManager()
 	//a matching ReleaseBitmapSurface().
 	ASSERT(this->LoadedBitmaps.size()==0);
 
-	if (this->pTileImagesSurface) 
-		SDL_FreeSurface(this->pTileImagesSurface);
-
-	delete[] this->TileImageTypes;
+	StopLoader();
+	FreeDecodedBitmaps();
+	SDL_DestroyCond(this->pLoaderDone);
+	SDL_DestroyCond(this->pLoaderWake);
+	SDL_DestroyMutex(this->pLoaderLock);
+
+	for (list<TILESET *>::iterator iSet = this->TileSets.begin();
+			iSet != this->TileSets.end(); ++iSet)
+		FreeTileSet(*iSet);
+	this->TileSets.clear();
+	this->pTileImagesSurface = NULL;
+	this->TileImageTypes = NULL;
 	this->wTileCount = 0;
 }
 
@@ -528,6 +546,62 @@ SDL_Surface * CBitmapManager::GetBitmapSurface(
 	return pBitmap->pSurface;
 }
 
+//**********************************************************************************
+void CBitmapManager::PrefetchBitmap(
+//Starts decoding a bitmap on the loader thread, so that a later call to
+//GetBitmapSurface() for it doesn't have to wait for the disk.
+//
+//Params:
+	const char *pszName) //(in)	Name of the bitmap, not including extension.
+{
+	ASSERT(strlen(pszName) <= MAXLEN_BITMAPNAME);
+
+	WSTRING wstr;
+	AsciiToUnicode(pszName, wstr);
+	PrefetchBitmap(wstr.c_str());
+}
+
+//**********************************************************************************
+void CBitmapManager::PrefetchBitmap(
+//Starts decoding a bitmap on the loader thread.  Nothing happens if the bitmap
+//is already loaded, decoded or queued, or if decoding it would go over the
+//memory cap.
+//
+//Params:
+	const WCHAR *wszName,	//(in)	Name of the bitmap, not including extension.
+	const bool bHasMap)		//(in)	Also read the bitmap's tile image map
+									//		(default = false).
+{
+	ASSERT(WCSlen(wszName) <= MAXLEN_BITMAPNAME);
+
+	SDL_mutexP(this->pLoaderLock);
+	if (!FindDecodedBitmap(wszName) && !FindLoadedBitmap(wszName) &&
+			(this->TileSets.size() + 1) * GetTileSetSize() +
+			GetDecodedBitmapsSize() <= this->dwTileSetMemoryCap)
+	{
+		QueueBitmap(wszName, bHasMap);
+
+		//If the thread can't be started, queued bitmaps are decoded when asked for.
+		if (!this->pLoaderThread)
+			this->pLoaderThread = SDL_CreateThread(LoaderThread, this);
+		SDL_CondSignal(this->pLoaderWake);
+	}
+	SDL_mutexV(this->pLoaderLock);
+}
+
+//**********************************************************************************
+void CBitmapManager::SetTileSetMemoryCap(
+//Sets how much memory resident tile sets and decoded bitmaps may use.  Past
+//the cap, decoded bitmaps and then tile sets are freed, least recently used
+//first.
+//
+//Params:
+	const DWORD dwBytes)	//(in)	Cap in bytes.  The active set is always kept.
+{
+	this->dwTileSetMemoryCap = dwBytes;
+	EvictTileSets();
+}
+
 //**********************************************************************************
 void CBitmapManager::ReleaseBitmapSurface(
 //Releases one reference count of a bitmap, and unloads the bitmap if nobody is
@@ -559,6 +633,188 @@ void CBitmapManager::ReleaseBitmapSurface(
 //Private methods.
 //
 
+//**********************************************************************************
+bool CBitmapManager::AddTileSet(
+//Creates a new, empty tile set and makes it the active one.  Tile images must
+//then be loaded into it.
+//
+//Params:
+	const UINT wKey)	//(in)	Key to select the set by later.
+//
+//Returns:
+//True if successful, false if out of memory.
+{
+	ASSERT(this->wTileCount);
+
+	TILESET *pTileSet = new TILESET;
+	pTileSet->wKey = wKey;
+	pTileSet->pSurface = SDL_CreateRGBSurface(SDL_SWSURFACE, 
+			CX_TILE * this->wTileCount, CY_TILE, 24, 0, 0, 0, 0);
+	if (!pTileSet->pSurface)
+	{
+		delete pTileSet;
+		return false;
+	}
+	pTileSet->pTypes = new TILEIMAGETYPE[this->wTileCount];
+	for (UINT wI = this->wTileCount; wI--; )
+		pTileSet->pTypes[wI] = TIT_Unspecified;
+
+	this->TileSets.push_front(pTileSet);
+	ActivateTileSet(pTileSet);
+	EvictTileSets();
+	return true;
+}
+
+//**********************************************************************************
+void CBitmapManager::DiscardTileSet()
+//Frees the active tile set, i.e. after loading tile images into it failed.  The
+//most recently used remaining set becomes active.
+{
+	ASSERT(!this->TileSets.empty());
+	FreeTileSet(this->TileSets.front());
+	this->TileSets.pop_front();
+	if (this->TileSets.empty())
+	{
+		this->pTileImagesSurface = NULL;
+		this->TileImageTypes = NULL;
+	}
+	else
+		ActivateTileSet(this->TileSets.front());
+}
+
+//**********************************************************************************
+bool CBitmapManager::SelectTileSet(
+//Makes a resident tile set the active one.
+//
+//Params:
+	const UINT wKey)	//(in)	Key the set was added with.
+//
+//Returns:
+//True if the set was resident, false if it needs to be added and loaded.
+{
+	for (list<TILESET *>::iterator iSet = this->TileSets.begin();
+			iSet != this->TileSets.end(); ++iSet)
+	{
+		if ((*iSet)->wKey == wKey)
+		{
+			this->TileSets.splice(this->TileSets.begin(), this->TileSets, iSet);
+			ActivateTileSet(this->TileSets.front());
+			return true;
+		}
+	}
+	return false;
+}
+
+//**********************************************************************************
+void CBitmapManager::ActivateTileSet(
+//Points blits at a tile set.
+//
+//Params:
+	TILESET *pTileSet)	//(in)
+{
+	this->pTileImagesSurface = pTileSet->pSurface;
+	this->TileImageTypes = pTileSet->pTypes;
+	this->bIsColorKeySet = (pTileSet->pSurface->flags & SDL_SRCCOLORKEY) != 0;
+}
+
+//**********************************************************************************
+void CBitmapManager::EvictTileSets(
+//Frees least recently used decoded bitmaps, then least recently used tile
+//sets, until the rest fit under the memory cap.  A decoded bitmap can be made
+//again from its file, so it goes before any tile set.
+//
+//Params:
+	const DECODEDBITMAP *pKeep)	//(in)	Decoded bitmap in use, which isn't freed
+										//		(default = NULL).
+{
+	const DWORD dwSetSize = GetTileSetSize();
+
+	SDL_mutexP(this->pLoaderLock);
+	DWORD dwDecodedSize = GetDecodedBitmapsSize();
+	list<DECODEDBITMAP *>::iterator iSeek = this->DecodedBitmaps.begin();
+	while (iSeek != this->DecodedBitmaps.end() &&
+			this->TileSets.size() * dwSetSize + dwDecodedSize > this->dwTileSetMemoryCap)
+	{
+		//Can't free one the loader thread is still working on.
+		DECODEDBITMAP *pBitmap = *iSeek;
+		if (pBitmap == pKeep || pBitmap->eState == DS_Decoding)
+		{
+			++iSeek;
+			continue;
+		}
+		dwDecodedSize -= GetDecodedBitmapSize(pBitmap);
+		if (pBitmap->eState == DS_Queued)
+			this->LoaderQueue.remove(pBitmap);
+		else if (pBitmap->pSurface)
+			SDL_FreeSurface(pBitmap->pSurface);
+		iSeek = this->DecodedBitmaps.erase(iSeek);
+		delete pBitmap;
+	}
+	SDL_mutexV(this->pLoaderLock);
+
+	while (this->TileSets.size() > 1 &&
+			this->TileSets.size() * dwSetSize + dwDecodedSize > this->dwTileSetMemoryCap)
+	{
+		FreeTileSet(this->TileSets.back());
+		this->TileSets.pop_back();
+	}
+}
+
+//**********************************************************************************
+void CBitmapManager::FreeTileSet(
+//Frees a tile set's surface and types.  Doesn't remove it from TileSets.
+//
+//Params:
+	TILESET *pTileSet)	//(in)
+{
+	SDL_FreeSurface(pTileSet->pSurface);
+	delete[] pTileSet->pTypes;
+	delete pTileSet;
+}
+
+//**********************************************************************************
+DWORD CBitmapManager::GetDecodedBitmapSize(
+//Params:
+	const DECODEDBITMAP *pBitmap)	//(in)
+//
+//Returns:
+//Approximate bytes used by a decoded bitmap.  One not decoded yet is counted as
+//a tile set's worth, which is about what a tile images bitmap takes.
+const
+{
+	if (pBitmap->eState != DS_Ready)
+		return GetTileSetSize();
+	if (!pBitmap->pSurface)
+		return 0;
+	return pBitmap->pSurface->h * pBitmap->pSurface->pitch +
+			pBitmap->MappingIndex.size() * sizeof(UINT);
+}
+
+//**********************************************************************************
+DWORD CBitmapManager::GetDecodedBitmapsSize()
+//Caller must hold pLoaderLock.
+//
+//Returns:
+//Approximate bytes used by all decoded and queued bitmaps.
+const
+{
+	DWORD dwSize = 0;
+	for (list<DECODEDBITMAP *>::const_iterator iSeek = this->DecodedBitmaps.begin();
+			iSeek != this->DecodedBitmaps.end(); ++iSeek)
+		dwSize += GetDecodedBitmapSize(*iSeek);
+	return dwSize;
+}
+
+//**********************************************************************************
+DWORD CBitmapManager::GetTileSetSize()
+//Returns:
+//Approximate bytes used by one tile set.
+const
+{
+	return (CX_TILE * this->wTileCount * 3 + 3) * CY_TILE +
+			this->wTileCount * sizeof(TILEIMAGETYPE);
+}
+
 //**********************************************************************************
 bool CBitmapManager::DoesTileImageContainTransparentPixels(
 //Scans pixels of a tile image for reserved transparent color.
@@ -666,6 +922,27 @@ void CBitmapManager::ReplaceAntiAliasingColors(
 	UnlockTileImagesSurface();
 }
 
+//**********************************************************************************
+DECODEDBITMAP * CBitmapManager::FindDecodedBitmap(
+//Find a decoded or queued bitmap by name.  Caller must hold pLoaderLock.
+//
+//Params:
+	const WCHAR *wszName) //(in)	Name of the bitmap, not including extension.
+//
+//Returns:
+//Pointer to decoded bitmap structure or NULL if not found.
+const
+{
+	for(list<DECODEDBITMAP *>::const_iterator iSeek = this->DecodedBitmaps.begin();
+		iSeek != this->DecodedBitmaps.end(); ++iSeek)
+	{
+		if (WCScmp(wszName, (*iSeek)->wszName)==0) return *iSeek; //Found it.
+	}
+
+	//No match.
+	return NULL;
+}
+
 //**********************************************************************************
 LOADEDBITMAP * CBitmapManager::FindLoadedBitmap(
 //Find a loaded bitmap by name.
@@ -689,7 +966,8 @@ const
 
 //**********************************************************************************
 SDL_Surface * CBitmapManager::LoadBitmapSurface(
-//Loads a bitmap from the appropriate location into a new surface.
+//Loads a bitmap from the appropriate location into a new surface.  If the loader
+//thread has decoded the bitmap, that surface is handed over instead.
 //
 //Params:
 	const WCHAR *wszName)	//(in)	Name of the bitmap, not including extension.
@@ -700,10 +978,50 @@ SDL_Surface * CBitmapManager::LoadBitmapSurface(
 	ASSERT(wszName);
 	ASSERT(WCSlen(wszName) > 1);
 
+	SDL_mutexP(this->pLoaderLock);
+	DECODEDBITMAP *pBitmap = FindDecodedBitmap(wszName);
+	if (pBitmap)
+	{
+		WaitForDecodedBitmap(pBitmap);
+		this->DecodedBitmaps.remove(pBitmap);
+	}
+	SDL_mutexV(this->pLoaderLock);
+	if (pBitmap)
+	{
+		SDL_Surface *pSurface = pBitmap->pSurface;
+		delete pBitmap;
+		if (pSurface) return pSurface;
+	}
+
 	WSTRING wstrFilepath;
 	GetBitmapFilepath(wszName, wstrFilepath);
+	SDL_Surface *pSurface = DecodeBitmapFile(wstrFilepath.c_str());
+	if (!pSurface)
+	{
+		char szErrMsg[1024];
+		char szFilename[MAX_PATH+1];
+		UnicodeToAscii(wstrFilepath.c_str(), szFilename);
+		sprintf(szErrMsg, "SDL_LoadBmp(\"%s\", ...) failed: %s",
+				szFilename, SDL_GetError());
+		LOGERR(szErrMsg);
+		return NULL;
+	}
+
+	return pSurface;
+}
+
+//**********************************************************************************
+SDL_Surface * CBitmapManager::DecodeBitmapFile(
+//Reads and decodes a bitmap file.  Safe to call from the loader thread.
+//
+//Params:
+	const WCHAR *wszFilepath)	//(in)	Full path of the bitmap.
+//
+//Returns:
+//New surface if successful, or NULL if not.
+{
+	WSTRING wstrFilepath = wszFilepath;
 	CFiles::GetTrueDatafileName(&*wstrFilepath.begin());
-	SDL_Surface *pSurface;
 	CStretchyBuffer buffer;
 	CFiles::ReadFileIntoBuffer(&*wstrFilepath.begin(),buffer);
 	if (CFiles::FileIsEncrypted(wstrFilepath.c_str()))
@@ -711,19 +1029,191 @@ SDL_Surface * CBitmapManager::LoadBitmapSurface(
 		//Unprotect encrypted bitmap file.
 		buffer.Decode();
 	} 
-	pSurface = SDL_LoadBMP_RW(SDL_RWFromMem((BYTE*)buffer,buffer.Size()), 0);
-	if (!pSurface)
+	return SDL_LoadBMP_RW(SDL_RWFromMem((BYTE*)buffer,buffer.Size()), 0);
+}
+
+//**********************************************************************************
+const DECODEDBITMAP * CBitmapManager::GetDecodedBitmap(
+//Gets a decoded bitmap, decoding it now unless the loader thread already has.
+//The bitmap stays decoded while it fits under the memory cap, so loading it
+//again soon after is free.  The returned bitmap is only good until the next
+//call.
+//
+//Params:
+	const WCHAR *wszName,	//(in)	Name of the bitmap, not including extension.
+	const bool bHasMap)		//(in)	Also get the bitmap's tile image map.
+//
+//Returns:
+//The decoded bitmap, or NULL if it couldn't be loaded.
+{
+	SDL_mutexP(this->pLoaderLock);
+	DECODEDBITMAP *pBitmap = FindDecodedBitmap(wszName);
+	if (!pBitmap)
+		pBitmap = QueueBitmap(wszName, bHasMap);
+	WaitForDecodedBitmap(pBitmap);
+
+	//Most recently used bitmaps are at the back.
+	this->DecodedBitmaps.remove(pBitmap);
+	if (pBitmap->pSurface)
+		this->DecodedBitmaps.push_back(pBitmap);
+	SDL_mutexV(this->pLoaderLock);
+
+	if (!pBitmap->pSurface)
 	{
 		char szErrMsg[1024];
 		char szFilename[MAX_PATH+1];
-		UnicodeToAscii(wstrFilepath.c_str(), szFilename);
-		sprintf(szErrMsg, "SDL_LoadBmp(\"%s\", ...) failed: %s",
-				szFilename, SDL_GetError());
+		UnicodeToAscii(pBitmap->wstrFilepath.c_str(), szFilename);
+		sprintf(szErrMsg, "SDL_LoadBmp(\"%s\", ...) failed.", szFilename);
 		LOGERR(szErrMsg);
+		delete pBitmap;
 		return NULL;
 	}
 
-	return pSurface;
+	//Bitmap was prefetched without its map.
+	if (bHasMap && !pBitmap->bHasMap)
+	{
+		GetTileImageMapFilepath(wszName, pBitmap->wstrMapFilepath);
+		if (!ReadTileImageMap(pBitmap->wstrMapFilepath.c_str(), pBitmap->MappingIndex))
+			pBitmap->MappingIndex.clear();
+		pBitmap->bHasMap = true;
+	}
+
+	EvictTileSets(pBitmap);
+	return pBitmap;
+}
+
+//**********************************************************************************
+void CBitmapManager::FreeDecodedBitmaps()
+//Frees all decoded bitmaps, and forgets bitmaps queued for decoding.
+{
+	SDL_mutexP(this->pLoaderLock);
+	this->LoaderQueue.clear();
+	list<DECODEDBITMAP *>::iterator iSeek;
+	for (iSeek = this->DecodedBitmaps.begin(); iSeek != this->DecodedBitmaps.end(); ++iSeek)
+	{
+		//Can't free one the loader thread is still working on.
+		while ((*iSeek)->eState == DS_Decoding)
+			SDL_CondWait(this->pLoaderDone, this->pLoaderLock);
+		if ((*iSeek)->pSurface) SDL_FreeSurface((*iSeek)->pSurface);
+		delete *iSeek;
+	}
+	this->DecodedBitmaps.clear();
+	SDL_mutexV(this->pLoaderLock);
+}
+
+//**********************************************************************************
+DECODEDBITMAP * CBitmapManager::QueueBitmap(
+//Adds a bitmap to the loader thread's queue.  Caller must hold pLoaderLock.
+//
+//Params:
+	const WCHAR *wszName,	//(in)	Name of the bitmap, not including extension.
+	const bool bHasMap)		//(in)	Also read the bitmap's tile image map.
+//
+//Returns:
+//The new queued bitmap.
+{
+	ASSERT(!FindDecodedBitmap(wszName));
+
+	DECODEDBITMAP *pBitmap = new DECODEDBITMAP;
+	WCScpy(pBitmap->wszName, wszName);
+	GetBitmapFilepath(wszName, pBitmap->wstrFilepath);
+	if (bHasMap)
+		GetTileImageMapFilepath(wszName, pBitmap->wstrMapFilepath);
+	pBitmap->bHasMap = bHasMap;
+	pBitmap->eState = DS_Queued;
+	pBitmap->pSurface = NULL;
+
+	this->DecodedBitmaps.push_back(pBitmap);
+	this->LoaderQueue.push_back(pBitmap);
+	return pBitmap;
+}
+
+//**********************************************************************************
+void CBitmapManager::DecodeQueuedBitmap(
+//Decodes a queued bitmap and its tile image map.  Safe to call from the loader
+//thread, without holding pLoaderLock, once the bitmap is marked DS_Decoding.
+//
+//Params:
+	DECODEDBITMAP *pBitmap)	//(in/out)
+const
+{
+	ASSERT(pBitmap->eState == DS_Decoding);
+	pBitmap->pSurface = DecodeBitmapFile(pBitmap->wstrFilepath.c_str());
+	if (pBitmap->pSurface && pBitmap->bHasMap &&
+			!ReadTileImageMap(pBitmap->wstrMapFilepath.c_str(), pBitmap->MappingIndex))
+		pBitmap->MappingIndex.clear();
+}
+
+//**********************************************************************************
+void CBitmapManager::WaitForDecodedBitmap(
+//Returns once a bitmap is decoded.  If the loader thread hasn't started on it
+//yet, it is decoded right away on this thread instead of waiting its turn.
+//Caller must hold pLoaderLock.
+//
+//Params:
+	DECODEDBITMAP *pBitmap)	//(in/out)
+{
+	if (pBitmap->eState == DS_Queued)
+	{
+		this->LoaderQueue.remove(pBitmap);
+		pBitmap->eState = DS_Decoding;
+		SDL_mutexV(this->pLoaderLock);
+		DecodeQueuedBitmap(pBitmap);
+		SDL_mutexP(this->pLoaderLock);
+		pBitmap->eState = DS_Ready;
+		SDL_CondBroadcast(this->pLoaderDone);
+	}
+	while (pBitmap->eState != DS_Ready)
+		SDL_CondWait(this->pLoaderDone, this->pLoaderLock);
+}
+
+//**********************************************************************************
+int CBitmapManager::LoaderThread(
+//Decodes queued bitmaps in the background until StopLoader() is called.
+//
+//Params:
+	void *pBitmapManager)	//(in)	The CBitmapManager that started the thread.
+{
+	CBitmapManager *pBM = static_cast<CBitmapManager *>(pBitmapManager);
+
+	SDL_mutexP(pBM->pLoaderLock);
+	while (!pBM->bStopLoader)
+	{
+		if (pBM->LoaderQueue.empty())
+		{
+			SDL_CondWait(pBM->pLoaderWake, pBM->pLoaderLock);
+			continue;
+		}
+
+		DECODEDBITMAP *pBitmap = pBM->LoaderQueue.front();
+		pBM->LoaderQueue.pop_front();
+		pBitmap->eState = DS_Decoding;
+		SDL_mutexV(pBM->pLoaderLock);
+
+		pBM->DecodeQueuedBitmap(pBitmap);
+
+		SDL_mutexP(pBM->pLoaderLock);
+		pBitmap->eState = DS_Ready;
+		SDL_CondBroadcast(pBM->pLoaderDone);
+	}
+	SDL_mutexV(pBM->pLoaderLock);
+
+	return 0;
+}
+
+//**********************************************************************************
+void CBitmapManager::StopLoader()
+//Stops the loader thread after it finishes the bitmap it is working on.
+{
+	if (!this->pLoaderThread) return;
+
+	SDL_mutexP(this->pLoaderLock);
+	this->bStopLoader = true;
+	SDL_CondSignal(this->pLoaderWake);
+	SDL_mutexV(this->pLoaderLock);
+
+	SDL_WaitThread(this->pLoaderThread, NULL);
+	this->pLoaderThread = NULL;
 }
 
 //**********************************************************************************
@@ -794,7 +1284,7 @@ bool CBitmapManager::GetMappingIndexFromTileImageMap(
 //
 //Params:
 	const WCHAR *wszName,		//(in)	Name of the bitmap with no file extension.
-	list<UINT> &MappingIndex)	//(out)	List of TI_* constants.  First one is for
+	vector<UINT> &MappingIndex)	//(out)	List of TI_* constants.  First one is for
 								//		topleft square in the bitmap, and then
 								//		progresses by column and row.
 //
@@ -802,13 +1292,71 @@ bool CBitmapManager::GetMappingIndexFromTileImageMap(
 //True if successful, false if not.
 const
 {
-	//Load the .tim file into a buffer.
 	WSTRING wstrFilepath;
-	CStretchyBuffer Buffer;
 	GetTileImageMapFilepath(wszName, wstrFilepath);
-	if (!CFiles::ReadFileIntoBuffer(wstrFilepath.c_str(), Buffer))
+	return ReadTileImageMap(wstrFilepath.c_str(), MappingIndex);
+}
+
+//**********************************************************************************
+bool CBitmapManager::ReadTileImageMap(
+//Loads a .tim file into a list of TI_* constants.  The parsed list is kept in a
+//compiled .tib file next to the .tim, and later loads read that instead of 
+//parsing again, as long as the .tim text hasn't changed.  Safe to call from the
+//loader thread.
+//
+//Params:
+	const WCHAR *wszFilepath,	//(in)	Full path of the .tim file.
+	vector<UINT> &MappingIndex)	//(out)	List of TI_* constants.
+//
+//Returns:
+//True if successful, false if not.
+const
+{
+	//Load the .tim file into a buffer.
+	CStretchyBuffer Buffer;
+	if (!CFiles::ReadFileIntoBuffer(wszFilepath, Buffer))
 		return false;
 
+	//Identify the text by its size and an FNV-1a hash.  The buffer ends with a
+	//null WCHAR that isn't part of the file.
+	const Uint32 dwTextSize = Buffer.Size() - sizeof(WCHAR);
+	Uint32 dwTextHash = 2166136261U;
+	const BYTE *pText = (BYTE *)Buffer;
+	for (Uint32 dwI = 0; dwI < dwTextSize; ++dwI)
+		dwTextHash = (dwTextHash ^ pText[dwI]) * 16777619U;
+
+	//foo.tim -> foo.tib
+	WSTRING wstrCompiledFilepath = wszFilepath;
+	ASSERT(wstrCompiledFilepath.size());
+	WCv(wstrCompiledFilepath[wstrCompiledFilepath.size() - 1]) = 'b';
+
+	MappingIndex.clear();
+	if (ReadCompiledTileImageMap(wstrCompiledFilepath.c_str(), dwTextSize, dwTextHash,
+			MappingIndex))
+		return true;
+
+	if (!ParseTileImageMap((const char *)pText, MappingIndex))
+		return false;
+
+	//Not being able to write it (i.e. read-only install) just means parsing
+	//again next time.
+	WriteCompiledTileImageMap(wstrCompiledFilepath.c_str(), dwTextSize, dwTextHash,
+			MappingIndex);
+	return true;
+}
+
+//**********************************************************************************
+bool CBitmapManager::ParseTileImageMap(
+//Parses the text of a .tim file into a list of TI_* constants.
+//
+//Params:
+	const char *pszText,			//(in)	Null-terminated .tim text.
+	vector<UINT> &MappingIndex)	//(out)	List of TI_* constants.
+//
+//Returns:
+//True if successful, false if not.
+const
+{
 	//Parse the buffer for indices.  Here are the rules:
 	//
 	//Each TOKEN is delimited by any combination of ',', SPACE, CR, or LF.
@@ -821,7 +1369,7 @@ const
 	UINT wBeginTINo, wEndTINo, wExcludeCount;
 	
 	//Seek past delimeter chars.
-	const char *pszSeek = (const char *)(BYTE *)Buffer;
+	const char *pszSeek = pszText;
 	pszSeek = GetMappingIndexFromTileImageMap_SeekPastDelimiters(pszSeek);
 	if (*pszSeek == '\0') return false; //No tokens in file, so the format is wrong.
 	do
@@ -835,8 +1383,7 @@ const
 		if (wExcludeCount)
 		{
 			//Yes--add that number of TI_UNSPECIFIED indices to the index.
-			for (UINT wExcludeI = 0; wExcludeI < wExcludeCount; ++wExcludeI)
-				MappingIndex.push_back((UINT)-1);	//TI_UNSPECIFIED
+			MappingIndex.insert(MappingIndex.end(), wExcludeCount, (UINT)-1); //TI_UNSPECIFIED
 		}
 		else
 		{
@@ -854,6 +1401,86 @@ const
 	return true;
 }
 
+//Compiled tile image map (.tib) layout: this header, then dwCount Uint32 TI#s
+//in native byte order.  A file written on a machine with the other byte order
+//fails the magic number check and is rewritten.
+typedef struct tagCompiledTileImageMapHeader
+{
+	Uint32 dwMagic;
+	Uint32 dwVersion;
+	Uint32 dwTextSize;	//size of the .tim it was compiled from
+	Uint32 dwTextHash;	//FNV-1a hash of that .tim
+	Uint32 dwCount;
+} COMPILEDTIMHEADER;
+static const Uint32 COMPILEDTIM_MAGIC = 0x424d4954;	//"TIMB"
+static const Uint32 COMPILEDTIM_VERSION = 1;
+
+//**********************************************************************************
+bool CBitmapManager::ReadCompiledTileImageMap(
+//Reads a compiled tile image map, if it exists and matches the .tim text.
+//
+//Params:
+	const WCHAR *wszFilepath,	//(in)	Full path of the .tib file.
+	const Uint32 dwTextSize,	//(in)	Size of the .tim text.
+	const Uint32 dwTextHash,	//(in)	Hash of the .tim text.
+	vector<UINT> &MappingIndex)	//(out)	List of TI_* constants.
+//
+//Returns:
+//True if the list was read, false if the .tim needs to be parsed.
+{
+	CStretchyBuffer Buffer;
+	if (!CFiles::ReadFileIntoBuffer(wszFilepath, Buffer))
+		return false;
+
+	const Uint32 dwFileSize = Buffer.Size() - sizeof(WCHAR);
+	if (dwFileSize < sizeof(COMPILEDTIMHEADER)) return false;
+	COMPILEDTIMHEADER header;
+	memcpy(&header, (BYTE *)Buffer, sizeof(header));
+	if (header.dwMagic != COMPILEDTIM_MAGIC ||
+			header.dwVersion != COMPILEDTIM_VERSION ||
+			header.dwTextSize != dwTextSize || header.dwTextHash != dwTextHash ||
+			header.dwCount == 0 ||
+			dwFileSize != sizeof(header) + header.dwCount * sizeof(Uint32))
+		return false;
+
+	const Uint32 *pdwTINo = (const Uint32 *)((BYTE *)Buffer + sizeof(header));
+	MappingIndex.resize(header.dwCount);
+	for (Uint32 dwI = 0; dwI < header.dwCount; ++dwI)
+		MappingIndex[dwI] = pdwTINo[dwI] == 0xffffffff ? (UINT)-1 : pdwTINo[dwI];
+	return true;
+}
+
+//**********************************************************************************
+bool CBitmapManager::WriteCompiledTileImageMap(
+//Writes a compiled tile image map.
+//
+//Params:
+	const WCHAR *wszFilepath,	//(in)	Full path of the .tib file.
+	const Uint32 dwTextSize,	//(in)	Size of the .tim text.
+	const Uint32 dwTextHash,	//(in)	Hash of the .tim text.
+	const vector<UINT> &MappingIndex)	//(in)	List of TI_* constants.
+//
+//Returns:
+//True if successful, false if not.
+{
+	COMPILEDTIMHEADER header;
+	header.dwMagic = COMPILEDTIM_MAGIC;
+	header.dwVersion = COMPILEDTIM_VERSION;
+	header.dwTextSize = dwTextSize;
+	header.dwTextHash = dwTextHash;
+	header.dwCount = MappingIndex.size();
+
+	CStretchyBuffer Buffer;
+	Buffer.Append((const BYTE *)&header, sizeof(header));
+	for (vector<UINT>::const_iterator iTINo = MappingIndex.begin();
+			iTINo != MappingIndex.end(); ++iTINo)
+	{
+		const Uint32 dwTINo = *iTINo == (UINT)-1 ? 0xffffffff : *iTINo;
+		Buffer.Append((const BYTE *)&dwTINo, sizeof(dwTINo));
+	}
+	return CFiles::WriteBufferToFile(wszFilepath, Buffer);
+}
+
 //**********************************************************************************
 const char *CBitmapManager::GetMappingIndexFromTileImageMap_ParseToken(
 //Parse a token from current position in buffer.  Should only be called from
@@ -32,8 +32,11 @@
 #include <BackEndLib/Types.h>
 #include <BackEndLib/Wchar.h>
 
+#include <SDL_thread.h>
+
 #include <list>
 #include <string>
+#include <vector>
 using namespace std;
 
 const UINT MAXLEN_BITMAPNAME = 256;
@@ -44,6 +47,25 @@ typedef struct tagLoadedBitmap
 	SDL_Surface *	pSurface;
 } LOADEDBITMAP;
 
+//A bitmap decoded ahead of use by the loader thread, or kept after a
+//tile image load so the next load of the same bitmap doesn't touch the disk.
+enum DECODESTATE
+{
+	DS_Queued,		//waiting for the loader thread
+	DS_Decoding,	//being read and decoded
+	DS_Ready			//pSurface and MappingIndex are set
+};
+typedef struct tagDecodedBitmap
+{
+	WCHAR			wszName[MAXLEN_BITMAPNAME + 1];
+	WSTRING		wstrFilepath;		//set when queued, so the loader thread
+	WSTRING		wstrMapFilepath;	//doesn't need CFiles
+	bool			bHasMap;				//whether a tile image map was wanted
+	DECODESTATE	eState;
+	SDL_Surface *	pSurface;		//NULL if decoding failed
+	vector<UINT>	MappingIndex;
+} DECODEDBITMAP;
+
 enum TILEIMAGETYPE
 {
 	TIT_Unspecified = -1,
@@ -51,6 +73,15 @@ enum TILEIMAGETYPE
 	TIT_Transparent
 };
 
+//A tile images surface with its tile image types.  Several are kept resident
+//so that switching back to one doesn't reload it.
+typedef struct tagTileSet
+{
+	UINT				wKey;			//i.e. style#
+	SDL_Surface *	pSurface;
+	TILEIMAGETYPE *	pTypes;
+} TILESET;
+
 //****************************************************************************
 class CBitmapManager
 {
@@ -80,7 +111,10 @@ public:
 	SDL_Surface *	GetBitmapSurface(const char *wszName);
 	virtual UINT	Init() {return 0;}
 	void			LockTileImagesSurface(void);
+	void			PrefetchBitmap(const char *pszName);
+	void			PrefetchBitmap(const WCHAR *wszName, const bool bHasMap=false);
 	void			ReleaseBitmapSurface(const char *pszName);
+	void			SetTileSetMemoryCap(const DWORD dwBytes);
 	void			ShadeRect(const UINT x, const UINT y, const UINT w, const UINT h,
 			const SURFACECOLOR &Color, SDL_Surface *pDestSurface);
 	void			ShadeTile(const UINT x, const UINT y,
@@ -92,13 +126,17 @@ public:
 
 
 protected:
+	bool			AddTileSet(const UINT wKey);
+	void			DiscardTileSet();
 	bool			DoesTileImageContainTransparentPixels(UINT wTileImageNo);
 	LOADEDBITMAP *	FindLoadedBitmap(const WCHAR *pszName) const;
+	void			FreeDecodedBitmaps();
+	const DECODEDBITMAP *	GetDecodedBitmap(const WCHAR *wszName, const bool bHasMap);
 	void			GetBitmapPath(WSTRING &wstrPath) const;
 	void			GetBitmapFilepath(const WCHAR *pszName, 
 			WSTRING &wstrFilepath) const;
 	bool			GetMappingIndexFromTileImageMap(const WCHAR *pszName, 
-			list<UINT> &MappingIndex) const;
+			vector<UINT> &MappingIndex) const;
 	const char *	GetMappingIndexFromTileImageMap_ParseToken(
 			const char *pszSeek, UINT &wBeginTINo, UINT &wEndTINo, 
 			UINT &wExcludeCount) const;
@@ -106,14 +144,19 @@ protected:
 			const char *pszSeek) const;
 	void			GetTileImageMapFilepath(const WCHAR *pszName, 
 			WSTRING &wstrFilepath) const;
+	bool			ReadTileImageMap(const WCHAR *wszFilepath,
+			vector<UINT> &MappingIndex) const;
 	SDL_Surface *	LoadBitmapSurface(const WCHAR *wszName);
 	virtual bool	LoadTileImages(const WCHAR *pszName, bool bReplaceAntiAliasColors)=0;
 	void			ReplaceAntiAliasingColors(const UINT wTileImageNo, 
 			const SURFACECOLOR &Replace75, const SURFACECOLOR &Replace50);
+	bool			SelectTileSet(const UINT wKey);
 
+	//Active tile set.  These point into the front of TileSets.
 	SDL_Surface *			pTileImagesSurface;
 	TILEIMAGETYPE *		TileImageTypes;
 	list<LOADEDBITMAP *>	LoadedBitmaps;
+	list<DECODEDBITMAP *>	DecodedBitmaps;
 	SURFACECOLOR			TransparentColor;
 	bool						bIsColorKeySet;
 
@@ -122,6 +165,36 @@ protected:
 private:
 	void			BlitTileImage_Trans(Uint8 *pSrc, Uint8 *pDest,
 			const DWORD dwSrcPitch, const DWORD dwDestPitch);
+	void			ActivateTileSet(TILESET *pTileSet);
+	static SDL_Surface *	DecodeBitmapFile(const WCHAR *wszFilepath);
+	void			EvictTileSets(const DECODEDBITMAP *pKeep=NULL);
+	void			FreeTileSet(TILESET *pTileSet);
+	DWORD			GetDecodedBitmapSize(const DECODEDBITMAP *pBitmap) const;
+	DWORD			GetDecodedBitmapsSize() const;
+	DWORD			GetTileSetSize() const;
+	bool			ParseTileImageMap(const char *pszText, vector<UINT> &MappingIndex) const;
+	static bool	ReadCompiledTileImageMap(const WCHAR *wszFilepath,
+			const Uint32 dwTextSize, const Uint32 dwTextHash, vector<UINT> &MappingIndex);
+	static bool	WriteCompiledTileImageMap(const WCHAR *wszFilepath,
+			const Uint32 dwTextSize, const Uint32 dwTextHash, const vector<UINT> &MappingIndex);
+	void			DecodeQueuedBitmap(DECODEDBITMAP *pBitmap) const;
+	DECODEDBITMAP *	FindDecodedBitmap(const WCHAR *wszName) const;
+	static int		LoaderThread(void *pBitmapManager);
+	DECODEDBITMAP *	QueueBitmap(const WCHAR *wszName, const bool bHasMap);
+	void			StopLoader();
+	void			WaitForDecodedBitmap(DECODEDBITMAP *pBitmap);
+
+	//Background decoding.  DecodedBitmaps and the entries' eState are
+	//guarded by pLoaderLock.
+	SDL_Thread *	pLoaderThread;
+	SDL_mutex *		pLoaderLock;
+	SDL_cond *		pLoaderWake;	//signaled when a bitmap is queued
+	SDL_cond *		pLoaderDone;	//signaled when a bitmap is ready
+	list<DECODEDBITMAP *>	LoaderQueue;
+	bool			bStopLoader;
+
+	list<TILESET *>	TileSets;		//most recently used first
+	DWORD			dwTileSetMemoryCap;
 };
 
 //Define global pointer to the one and only CBitmapManager object.
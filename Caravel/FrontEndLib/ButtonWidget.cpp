@@ -99,9 +99,11 @@ void CButtonWidget::HandleKeyDown(
 			Press();
 			Paint();
 			g_pTheSound->PlaySoundEffect(SOUNDLIB::SEID_BUTTON);
+			CEventHandlerWidget::FlushUpdateRects();
 			SDL_Delay(200);
 			Unpress();
 			Paint();
+			CEventHandlerWidget::FlushUpdateRects();
 			SDL_Delay(50);
 
 			//Call OnClick() notifier.
@@ -29,7 +29,7 @@
 //*********************************************************************************
 CEffect::CEffect(CWidget *pSetOwnerWidget, const UINT eType)
 	: pOwnerWidget(pSetOwnerWidget)
-	, dwTimeStarted(SDL_GetTicks()), dwTimeOfLastMove(SDL_GetTicks())
+	, dwTimeStarted(GetAnimationTicks()), dwTimeOfLastMove(GetAnimationTicks())
 	, eEffectType(eType)
 //Constructor.
 {
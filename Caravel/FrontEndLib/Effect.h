@@ -99,7 +99,7 @@ public:
 	const SDL_Rect GetAreaOfEffect() const {return this->rAreaOfEffect;}
 	
 protected:
-	UINT			GetFrameNo() const {return (SDL_GetTicks() - this->dwTimeStarted) / 33;}
+	UINT			GetFrameNo() const {return (GetAnimationTicks() - this->dwTimeStarted) / 33;}
 	SDL_Surface *	GetDestSurface() {return this->pOwnerWidget->GetDestSurface();}
 
 	CWidget *		pOwnerWidget;
@@ -32,9 +32,11 @@ CEffectList::CEffectList(CWidget *pOwnerWidget)
    : pOwnerWidget(pOwnerWidget)
    , pOwnerScreen(NULL)
    , dwTimeEffectsWereFrozen(0L)
+   , bRepaintingAreas(false)
 {
    if (pOwnerWidget->eType == WT_Screen)
       this->pOwnerScreen = DYN_CAST(CScreen*, CWidget*, pOwnerWidget);
+   memset(&this->LastDrawStats, 0, sizeof(this->LastDrawStats));
 }
 
 //*****************************************************************************
@@ -116,7 +118,19 @@ void CEffectList::DrawEffects(
                               //(default = false)
    SDL_Surface *pDestSurface) //(in) where to draw effects (default = NULL)
 {
-	list<CEffect *>::const_iterator iSeek = this->Effects.begin();
+	if (this->bRepaintingAreas)
+	{
+		//The owner is repainting under expired effects.  Just put back the
+		//running effects that overlap those areas (the clip rect does the rest).
+		for (list<CEffect *>::const_iterator iSeek = this->Effects.begin();
+			iSeek != this->Effects.end(); ++iSeek)
+			(*iSeek)->Draw(pDestSurface);
+		return;
+	}
+
+	memset(&this->LastDrawStats, 0, sizeof(this->LastDrawStats));
+
+	list<CEffect *>::iterator iSeek = this->Effects.begin();
 	while (iSeek != this->Effects.end())
 	{
       CEffect *pEffect = *iSeek;
@@ -125,25 +139,79 @@ void CEffectList::DrawEffects(
 		if (!bFreezeEffects && this->dwTimeEffectsWereFrozen)
 		{
 			//Unfreeze effect where it left off.
-			pEffect->dwTimeStarted += SDL_GetTicks() - this->dwTimeEffectsWereFrozen;
-			pEffect->dwTimeOfLastMove += SDL_GetTicks() - this->dwTimeEffectsWereFrozen;
+			pEffect->dwTimeStarted += GetAnimationTicks() - this->dwTimeEffectsWereFrozen;
+			pEffect->dwTimeOfLastMove += GetAnimationTicks() - this->dwTimeEffectsWereFrozen;
 		}
 
-		++iSeek;
 		if (pEffect->Draw(pDestSurface))
       {
+         ++this->LastDrawStats.dwEffectsDrawn;
+         this->LastDrawStats.dwPixelsTouched += pEffect->rAreaOfEffect.w *
+               pEffect->rAreaOfEffect.h;
          if (this->pOwnerScreen)
             this->pOwnerScreen->UpdateRect(pEffect->rAreaOfEffect);
+         ++iSeek;
       } else {
-			//Effect is finished--remove from list.
-         if (this->pOwnerScreen)
-            this->pOwnerScreen->Paint();  //refresh area of effect
-			this->Effects.remove(pEffect);
+			//Effect is finished--touch up the area it covered and remove it.
+         ++this->LastDrawStats.dwEffectsExpired;
+         DirtyAreaOfEffect(pEffect->rAreaOfEffect);
+			iSeek = this->Effects.erase(iSeek);
 			delete pEffect;
 		}
 	}
 
-	this->dwTimeEffectsWereFrozen = (bFreezeEffects ? SDL_GetTicks() : 0L);
+	this->dwTimeEffectsWereFrozen = (bFreezeEffects ? GetAnimationTicks() : 0L);
+
+	RepaintDirtyAreas();
+}
+
+//*****************************************************************************
+void CEffectList::DirtyAreaOfEffect(
+//Marks an area left by an expired effect for repainting.  On a screen, the
+//area is repainted at the end of DrawEffects().  Other owners repaint under
+//their effects themselves.  The room widget, for one, dirties the tiles under
+//every effect before it draws them, so an effect that expires has already
+//been painted over.
+//
+//Params:
+	const SDL_Rect &rect)	//(in)	Area the effect covered.
+{
+	if (this->pOwnerScreen && rect.w && rect.h)
+		this->DirtyAreas.push_back(rect);
+}
+
+//*****************************************************************************
+void CEffectList::RepaintDirtyAreas()
+//Repaints the owner screen under effects that expired, and nowhere else.
+{
+	if (this->DirtyAreas.empty()) return;
+	ASSERT(this->pOwnerScreen);
+
+	SDL_Surface *pDestSurface = this->pOwnerScreen->GetDestSurface();
+	this->bRepaintingAreas = true;
+	for (vector<SDL_Rect>::iterator iArea = this->DirtyAreas.begin();
+			iArea != this->DirtyAreas.end(); ++iArea)
+	{
+		//An area inside the room only needs the room tiles under it repainted,
+		//and then running effects there put back.  Anywhere else, the screen
+		//repaints under a clip rect, skipping widgets outside of it.
+		CWidget *pRoomWidget = this->pOwnerScreen->GetWidgetContainingCoords(
+				iArea->x, iArea->y, WT_Room);
+		if (pRoomWidget && pRoomWidget->ContainsCoords(iArea->x + iArea->w - 1,
+				iArea->y + iArea->h - 1))
+		{
+			pRoomWidget->PaintClipped(iArea->x, iArea->y, iArea->w, iArea->h, false);
+			SDL_SetClipRect(pDestSurface, &*iArea);
+			DrawEffects(false, pDestSurface);
+			SDL_SetClipRect(pDestSurface, NULL);
+		}
+		else
+			this->pOwnerScreen->PaintClipped(iArea->x, iArea->y, iArea->w, iArea->h, false);
+		this->pOwnerScreen->UpdateRect(*iArea);
+		this->LastDrawStats.dwPixelsTouched += iArea->w * iArea->h;
+	}
+	this->bRepaintingAreas = false;
+	this->DirtyAreas.clear();
 }
 
 //*****************************************************************************
@@ -156,19 +224,20 @@ void CEffectList::RemoveEffectsOfType(
    bool bRepaint = false;
 
    //Clear list of given effect type.
-	list<CEffect *>::const_iterator iSeek = this->Effects.begin();
+	list<CEffect *>::iterator iSeek = this->Effects.begin();
 	while (iSeek != this->Effects.end())
 	{
       CEffect *pEffect = *iSeek;
 		ASSERT(pEffect);
-		++iSeek;
 		if (eEffectType == pEffect->GetEffectType())
 		{
 			//Remove from list.
 			bRepaint = true;
-			this->Effects.remove(pEffect);
+			iSeek = this->Effects.erase(iSeek);
 			delete pEffect;
 		}
+		else
+			++iSeek;
 	}
 
    if (bRepaint)
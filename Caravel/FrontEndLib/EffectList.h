@@ -28,6 +28,16 @@
 
 #include "Effect.h"
 
+#include <vector>
+
+//What one call to DrawEffects() did.
+struct EFFECTSTATS
+{
+	DWORD dwEffectsDrawn;	//effects still running after being drawn
+	DWORD dwEffectsExpired;	//effects removed because they finished
+	DWORD dwPixelsTouched;	//area drawn by effects plus area repainted under expired ones
+};
+
 //****************************************************************************************
 class CScreen;
 class CEffectList
@@ -41,16 +51,27 @@ public:
 	bool				ContainsEffectOfType(const UINT eEffectType);
 	void				DrawEffects(const bool bFreezeEffects=false,
          SDL_Surface *pDestSurface=NULL);
+	const EFFECTSTATS &	GetLastDrawStats() const {return this->LastDrawStats;}
 	virtual void	RemoveEffectsOfType(const UINT eEffectType);
 
 	list<CEffect *> Effects;
 
 protected:
+	virtual void	DirtyAreaOfEffect(const SDL_Rect &rect);
+
 	CWidget *	pOwnerWidget;
    CScreen *   pOwnerScreen;
 
 	//Save time when effects are temporarily stopped
 	Uint32			dwTimeEffectsWereFrozen;
+
+	EFFECTSTATS		LastDrawStats;
+
+private:
+	void				RepaintDirtyAreas();
+
+	vector<SDL_Rect>	DirtyAreas;	//left by expired effects on the owner screen
+	bool				bRepaintingAreas;
 };
 
 #endif //...#ifndef EFFECTLIST_H
@@ -27,6 +27,8 @@
 #include "Sound.h"
 #include <BackEndLib/Assert.h>
 
+#include <vector>
+
 //A focus list iterator pointing to the end will mean that no widget is selected.
 #define NO_SELECTION (this->FocusList.end())
 
@@ -38,6 +40,22 @@ static SDL_KeyboardEvent	m_RepeatingKey; //Will be initialized in constructor.
 static DWORD				m_dwLastKeyDown = 0L;
 static DWORD				m_dwLastKeyRepeat = 0L;
 
+//Screen areas waiting to be pushed to the display.  These are also shared by
+//all event-handling widgets, so that a dialog activated from inside a screen's
+//event handler pushes the screen's pending updates along with its own.
+static vector<SDL_Rect>	m_DirtyRects;
+static UINT				m_wUpdateBatchDepth = 0;
+static DWORD				m_dwLastUpdateFlush = 0L;
+static UPDATESTATS		m_FrameUpdateStats = {0L, 0L, 0L};
+static UPDATESTATS		m_LastFrameUpdateStats = {0L, 0L, 0L};
+
+//Frame pacing totals for all event-handling widgets since the last reset.
+static FRAMESTATS		m_FrameStats;
+
+//An event handler that runs its own animation loop won't return to Activate()
+//to flush, so queued updates older than this are pushed as new ones arrive.
+static const DWORD		MAX_UPDATE_DELAY = 30L;
+
 //************************************************************************************
 CEventHandlerWidget::CEventHandlerWidget(
 //Constructor.
@@ -90,6 +108,48 @@ void CEventHandlerWidget::StopMouseRepeating()
    this->pHeldDownWidget = NULL;
 }
 
+//*****************************************************************************
+void CEventHandlerWidget::FlushUpdateRects()
+//Push all queued screen areas to the display with one SDL_UpdateRects call.
+{
+	m_dwLastUpdateFlush = SDL_GetTicks();
+	if (m_DirtyRects.empty()) return;
+
+	SDL_Surface *pScreenSurface = GetWidgetScreenSurface();
+	if (pScreenSurface->locked) return; //never call SDL_UpdateRects when surface is locked
+
+	for (vector<SDL_Rect>::const_iterator iRect = m_DirtyRects.begin();
+			iRect != m_DirtyRects.end(); ++iRect)
+		m_FrameUpdateStats.dwPixelsPushed += iRect->w * iRect->h;
+	m_FrameUpdateStats.dwRectsPushed += m_DirtyRects.size();
+
+	SDL_UpdateRects(pScreenSurface, m_DirtyRects.size(), &*m_DirtyRects.begin());
+	m_DirtyRects.clear();
+}
+
+//*****************************************************************************
+const UPDATESTATS& CEventHandlerWidget::GetLastFrameUpdateStats()
+//Returns:
+//Screen update totals for the last completed pass through an event loop.
+{
+	return m_LastFrameUpdateStats;
+}
+
+//*****************************************************************************
+const FRAMESTATS& CEventHandlerWidget::GetFrameStats()
+//Returns:
+//Frame pacing totals since the app started or ResetFrameStats() was called.
+{
+	return m_FrameStats;
+}
+
+//*****************************************************************************
+void CEventHandlerWidget::ResetFrameStats()
+//Clears frame pacing totals.
+{
+	memset(&m_FrameStats, 0, sizeof(m_FrameStats));
+}
+
 //******************************************************************************
 CWidget * CEventHandlerWidget::GetSelectedWidget()
 //Returns the selected widget or NULL if no selectable widgets available.
@@ -128,10 +188,15 @@ void CEventHandlerWidget::SetKeyRepeat(
 void CEventHandlerWidget::Activate()
 //Handle the input loop while event-handling widget is active.  
 //The method exits when Deactivate() is called.
+//
+//Each pass through the loop is one frame: handle waiting events, run any
+//between-events tick that is due, push the screen updates, then sleep.  While
+//the app has focus, the sleep lasts until the next tick or key repeat is due,
+//or until the frame budget is used up, whichever comes first.
 {
     DWORD dwStartFrame, dwSince;
     
-    //The delay between frames will be calculated to fit inside key repeat setting plus this many 
+    //The frame budget will be calculated to fit inside key repeat setting plus this many 
     //milliseconds.  Also, don't delay past 30fps or things will look bad.
     const UINT FRAME_DELAY_PAD = 5;
     UINT wMaxFrameDelay = this->dwContinueKeyRepeatDelay + FRAME_DELAY_PAD;
@@ -152,6 +217,7 @@ void CEventHandlerWidget::Activate()
 	while (!this->bDeactivate)
 	{	
         dwStartFrame = SDL_GetTicks();
+        BeginUpdateBatch();
             
 		//Get any events waiting in the queue.
 		while (!this->bDeactivate && SDL_PollEvent(&event)) 
@@ -196,13 +262,33 @@ void CEventHandlerWidget::Activate()
          if (!this->bDeactivate)
 			   Activate_HandleBetweenEvents();
 
+         //Show everything painted this frame.
+         EndUpdateBatch();
+
          //These calls will cause Windows and maybe other O/Ss to sleep a tiny bit,
 		   //freeing up the processor.  On my computer, CPU usage was cut from 100 to 50%
 		   //on the game screen during idle moments.
          if (bActive && bHasFocus)
          {
-            dwSince = SDL_GetTicks() - dwStartFrame;
-            SDL_Delay(dwSince > wMaxFrameDelay ? 1 : wMaxFrameDelay - dwSince);
+            const DWORD dwEndWork = SDL_GetTicks();
+            dwSince = dwEndWork - dwStartFrame;
+            DWORD dwSleep = dwSince >= wMaxFrameDelay ? 1 : wMaxFrameDelay - dwSince;
+            const DWORD dwUntilTick = GetTimeUntilNextTick(dwEndWork);
+            if (dwUntilTick < dwSleep) dwSleep = dwUntilTick ? dwUntilTick : 1;
+            SDL_Delay(dwSleep);
+
+            //Record how the frame went.
+            const DWORD dwSlept = SDL_GetTicks() - dwEndWork;
+            UINT wWorkBucket = dwSince / FRAME_HISTOGRAM_MSECS;
+            UINT wFrameBucket = (dwSince + dwSlept) / FRAME_HISTOGRAM_MSECS;
+            if (wWorkBucket >= FRAME_HISTOGRAM_BUCKETS) wWorkBucket = FRAME_HISTOGRAM_BUCKETS - 1;
+            if (wFrameBucket >= FRAME_HISTOGRAM_BUCKETS) wFrameBucket = FRAME_HISTOGRAM_BUCKETS - 1;
+            ++m_FrameStats.dwFrames;
+            if (dwSince >= wMaxFrameDelay) ++m_FrameStats.dwOverBudgetFrames;
+            m_FrameStats.dwIdleMSecs += dwSlept;
+            if (dwSlept > dwSleep) m_FrameStats.dwOversleptMSecs += dwSlept - dwSleep;
+            ++m_FrameStats.dwWorkTimes[wWorkBucket];
+            ++m_FrameStats.dwFrameTimes[wFrameBucket];
          }
          else
          {
@@ -212,6 +298,8 @@ void CEventHandlerWidget::Activate()
             StopMouseRepeating();
          }
       } else {
+         EndUpdateBatch();
+
          //Slow it down even more when minimized.
          SDL_Delay(200);
          StopKeyRepeating();
@@ -249,6 +337,18 @@ void CEventHandlerWidget::RemoveAnimatedWidget(
 	this->AnimatedList.remove(pWidget);
 }
 
+//**********************************************************************************
+void CEventHandlerWidget::AnimateWidgets()
+//Show the next frame of each visible animated widget.
+{
+	for (WIDGET_ITERATOR iSeek = this->AnimatedList.begin();
+			iSeek != this->AnimatedList.end(); ++iSeek)
+	{
+		if ((*iSeek)->IsVisible())
+			(*iSeek)->HandleAnimate();
+	}
+}
+
 //**********************************************************************************
 void CEventHandlerWidget::AddFocusWidget(
 //Add widget to list of focusable widgets that may be selected.
@@ -293,6 +393,63 @@ void CEventHandlerWidget::RemoveFocusWidget(
 	this->FocusList.remove(pWidget);
 }
 
+//**********************************************************************************
+bool CEventHandlerWidget::QueueUpdateRect(
+//Queue an area of the screen to be pushed to the display at the end of the
+//current frame.  Overlapping and adjacent areas are merged whenever the merged
+//rect is no larger than the areas it replaces.
+//
+//Params:
+	SDL_Surface *pSurface,	//(in)	Surface being updated.
+	const SDL_Rect &rect)	//(in)	Area to update, already cropped to the screen.
+//
+//Returns:
+//True if the update was queued (or is empty), false if the caller should
+//update the surface itself, i.e. no event loop is running or the surface
+//is not the screen.
+{
+	if (!m_wUpdateBatchDepth || pSurface != GetWidgetScreenSurface())
+		return false;
+	if (!rect.w || !rect.h) return true;
+
+	++m_FrameUpdateStats.dwRectsQueued;
+
+	int nX1 = rect.x, nY1 = rect.y, nX2 = rect.x + rect.w, nY2 = rect.y + rect.h;
+	Uint32 dwArea = rect.w * rect.h;
+	vector<SDL_Rect>::iterator iRect = m_DirtyRects.begin();
+	while (iRect != m_DirtyRects.end())
+	{
+		const int nMinX = iRect->x < nX1 ? iRect->x : nX1;
+		const int nMinY = iRect->y < nY1 ? iRect->y : nY1;
+		const int nMaxX = iRect->x + iRect->w > nX2 ? iRect->x + iRect->w : nX2;
+		const int nMaxY = iRect->y + iRect->h > nY2 ? iRect->y + iRect->h : nY2;
+		const Uint32 dwQueuedArea = iRect->w * iRect->h;
+		const Uint32 dwMergedArea = (nMaxX - nMinX) * (nMaxY - nMinY);
+		if (dwMergedArea == dwQueuedArea)
+			return true;	//already covered
+		if (dwMergedArea <= dwQueuedArea + dwArea)
+		{
+			//Absorb the queued rect and check the grown area against the rest.
+			nX1 = nMinX;
+			nY1 = nMinY;
+			nX2 = nMaxX;
+			nY2 = nMaxY;
+			dwArea = dwMergedArea;
+			*iRect = m_DirtyRects.back();
+			m_DirtyRects.pop_back();
+			iRect = m_DirtyRects.begin();
+		}
+		else ++iRect;
+	}
+
+	SDL_Rect merged = {nX1, nY1, nX2 - nX1, nY2 - nY1};
+	m_DirtyRects.push_back(merged);
+
+	if (SDL_GetTicks() - m_dwLastUpdateFlush >= MAX_UPDATE_DELAY)
+		FlushUpdateRects();
+	return true;
+}
+
 //**********************************************************************************
 void CEventHandlerWidget::Activate_HandleActiveEvent(
 //Handles SDL_ACTIVEEVENT event.
@@ -393,17 +550,50 @@ void CEventHandlerWidget::Activate_HandleBetweenEvents()
 	if (!this->bPaused &&
 		dwNow - this->dwLastOnBetweenEventsCall > this->dwBetweenEventsInterval)
 	{
-		//Animate widgets.
-		for (WIDGET_ITERATOR iSeek = this->AnimatedList.begin();
-				iSeek != this->AnimatedList.end(); ++iSeek)
-		{
-			if ((*iSeek)->IsVisible())
-				(*iSeek)->HandleAnimate();
-		}
-
+		AnimateWidgets();
 		OnBetweenEvents();
-		this->dwLastOnBetweenEventsCall = dwNow;
+
+		//Keep ticks on a fixed cadence, so a late tick doesn't push back the
+		//ones after it.  After a stall, start over from now instead of
+		//catching up with a burst of ticks.
+		if (dwNow - this->dwLastOnBetweenEventsCall > 2 * this->dwBetweenEventsInterval)
+			this->dwLastOnBetweenEventsCall = dwNow;
+		else
+			this->dwLastOnBetweenEventsCall += this->dwBetweenEventsInterval;
+	}
+}
+
+//******************************************************************************
+DWORD CEventHandlerWidget::GetTimeUntilNextTick(
+//Determines how long the event loop can sleep without missing a scheduled
+//between-events call or key repeat.
+//
+//Params:
+	const DWORD dwNow)	//(in)	Current time.
+//
+//Returns:
+//Milliseconds until the next call or repeat is due, 0 if one is already due,
+//or (DWORD)-1 if nothing is scheduled.
+const
+{
+	DWORD dwUntil = (DWORD)-1;
+
+	if (!this->bPaused)
+	{
+		const DWORD dwDue = this->dwLastOnBetweenEventsCall + this->dwBetweenEventsInterval + 1;
+		dwUntil = static_cast<int>(dwDue - dwNow) > 0 ? dwDue - dwNow : 0;
 	}
+
+	if (m_RepeatingKey.keysym.sym != SDLK_UNKNOWN)
+	{
+		const DWORD dwDue = (dwNow - m_dwLastKeyDown > this->dwStartKeyRepeatDelay) ?
+				m_dwLastKeyRepeat + this->dwContinueKeyRepeatDelay + 1 :
+				m_dwLastKeyDown + this->dwStartKeyRepeatDelay + 1;
+		const DWORD dwUntilRepeat = static_cast<int>(dwDue - dwNow) > 0 ? dwDue - dwNow : 0;
+		if (dwUntilRepeat < dwUntil) dwUntil = dwUntilRepeat;
+	}
+
+	return dwUntil;
 }
 
 //******************************************************************************
@@ -640,7 +830,14 @@ bool CEventHandlerWidget::IsKeyRepeating(
 			if (dwNow - m_dwLastKeyRepeat > dwContinueKeyRepeatDelay)
 			{
 				dwRepeatTagNo = this->dwTagNo;
-				m_dwLastKeyRepeat = dwNow;
+
+				//Repeat on a fixed cadence like between-events calls.  The first
+				//repeat, or one after a stall, starts the cadence over.
+				if (m_dwLastKeyRepeat == m_dwLastKeyDown ||
+						dwNow - m_dwLastKeyRepeat > 2 * dwContinueKeyRepeatDelay)
+					m_dwLastKeyRepeat = dwNow;
+				else
+					m_dwLastKeyRepeat += dwContinueKeyRepeatDelay;
 				return true;
 			}
 		}
@@ -836,6 +1033,27 @@ void CEventHandlerWidget::SelectWidget(
 	SelectWidget(pWidget, bPaint);
 }
 
+//*************************************************************************************
+void CEventHandlerWidget::BeginUpdateBatch()
+//Start queueing screen updates for a pass through the event loop.
+{
+	if (!m_wUpdateBatchDepth++)
+		m_dwLastUpdateFlush = SDL_GetTicks();
+}
+
+//*************************************************************************************
+void CEventHandlerWidget::EndUpdateBatch()
+//Push the frame's queued screen updates and record the frame's totals.
+{
+	ASSERT(m_wUpdateBatchDepth);
+	FlushUpdateRects();
+	--m_wUpdateBatchDepth;
+
+	m_LastFrameUpdateStats = m_FrameUpdateStats;
+	m_FrameUpdateStats.dwRectsQueued = m_FrameUpdateStats.dwRectsPushed =
+			m_FrameUpdateStats.dwPixelsPushed = 0L;
+}
+
 //*************************************************************************************
 void CEventHandlerWidget::ChangeSelection(
 //Change the selected widget to a new widget.
@@ -84,6 +84,29 @@
 #include "Widget.h"
 #include <BackEndLib/Assert.h>
 
+//Screen update totals for one pass through the event loop.
+struct UPDATESTATS
+{
+	DWORD dwRectsQueued;	//update requests made by widgets
+	DWORD dwRectsPushed;	//rects sent to the display after merging
+	DWORD dwPixelsPushed;	//area of those rects
+};
+
+//Frame pacing totals, collected while an event loop has the app's focus.
+//Histogram bucket i counts frames taking i*FRAME_HISTOGRAM_MSECS up to
+//(i+1)*FRAME_HISTOGRAM_MSECS-1 ms.  The last bucket also holds anything longer.
+#define FRAME_HISTOGRAM_BUCKETS	(16)
+#define FRAME_HISTOGRAM_MSECS		(4)
+struct FRAMESTATS
+{
+	DWORD dwFrames;			//passes through the event loop
+	DWORD dwOverBudgetFrames;	//frames whose work alone used up the frame budget
+	DWORD dwIdleMSecs;		//time spent sleeping
+	DWORD dwOversleptMSecs;	//time slept beyond what was asked for
+	DWORD dwFrameTimes[FRAME_HISTOGRAM_BUCKETS];	//work plus sleep
+	DWORD dwWorkTimes[FRAME_HISTOGRAM_BUCKETS];	//events, animation and screen updates
+};
+
 class CScreenManager;
 class CEventHandlerWidget : public CWidget
 {
@@ -97,6 +120,14 @@ public:
 	void			StopKeyRepeating();
    void        StopMouseRepeating();
 
+	//Screen areas updated while an event loop is running are collected and
+	//pushed to the display once per frame.  Code that paints and then waits
+	//without returning to the event loop should call FlushUpdateRects() first.
+	static void		FlushUpdateRects();
+	static const UPDATESTATS& GetLastFrameUpdateStats();
+	static const FRAMESTATS& GetFrameStats();
+	static void		ResetFrameStats();
+
 	CWidget *	MouseDraggingInWidget() {return this->pHeldDownWidget;}
 	bool			RightMouseButton() {return this->wButtonIndex == SDL_BUTTON_RIGHT;}
 
@@ -109,8 +140,10 @@ public:
    //focus, minimizing/restoring, and mouse entering/leaving window.
 
 	virtual void	OnBetweenEvents() { }
-	//Called periodically when no events are being processed.  The guaranteed minimum
-	//interval can be set by SetBetweenEventsInterval() and defaults to 33ms (30 fps).
+	//Called periodically when no events are being processed.  Calls are scheduled on
+	//a fixed tick set by SetBetweenEventsInterval(), which defaults to 33ms (30 fps).
+	//A late call doesn't delay the ones after it, but ticks missed during a long
+	//stall are dropped rather than run back-to-back.
 
 	virtual void	OnSelectChange(const DWORD /*dwTagNo*/) { }
 	//Called when a widget's selection changes.  Not every widget is used to select
@@ -175,7 +208,9 @@ protected:
 
 	void			Activate();
 	void			AddAnimatedWidget(CWidget *pWidget);
+	static bool	QueueUpdateRect(SDL_Surface *pSurface, const SDL_Rect &rect);
 	void			AddFocusWidget(CWidget *pWidget);
+	void			AnimateWidgets();
 	void			Deactivate() {ASSERT(!this->bDeactivate); this->bDeactivate=true;};
 	bool			IsDeactivating() const {return this->bDeactivate;}
 	void			RemoveAnimatedWidget(CWidget *pWidget);
@@ -197,9 +232,13 @@ private:
 	void			Activate_HandleMouseMotion(const SDL_MouseMotionEvent &Motion);
 	void			Activate_HandleQuit();
 
+	static void	BeginUpdateBatch();
+	static void	EndUpdateBatch();
+
 	void			ChangeSelection(WIDGET_ITERATOR iSelect, const bool bPaint);
 	bool			CheckForSelectionChange(const SDL_KeyboardEvent &KeyboardEvent);
 	bool			IsKeyRepeating(DWORD &dwRepeatTagNo);
+	DWORD			GetTimeUntilNextTick(const DWORD dwNow) const;
 	CWidget *		pHeldDownWidget;
 	bool			bIsFirstMouseDownRepeat;
 	DWORD			dwLastMouseDownRepeat;
@@ -211,7 +250,7 @@ private:
 
 	bool			bDeactivate;
 	DWORD			dwBetweenEventsInterval;
-	DWORD			dwLastOnBetweenEventsCall;
+	DWORD			dwLastOnBetweenEventsCall;	//time the current tick was due
 	DWORD			dwStartKeyRepeatDelay, 	dwContinueKeyRepeatDelay;
 
 	list<CWidget *>	AnimatedList;
@@ -28,6 +28,83 @@
 
 #include <memory.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define FADE_USE_SSE2
+#	include <emmintrin.h>
+#endif
+
+//Mixing amounts are fixed-point fractions of this.  Using 256 instead of 255
+//lets blending shift instead of divide, and still reach the new image exactly.
+const UINT FADE_ONE = 256;
+
+//*****************************************************************************
+static void BlendBytes(
+//Sets each byte of pDest to a mix of the corresponding bytes of pFrom and pTo.
+//
+//Params:
+	Uint8 *pDest,					//(out)	Mixed bytes.
+	const Uint8 *pFrom, const Uint8 *pTo,	//(in)	Bytes to mix.
+	UINT wBytes,					//(in)	Number of bytes.
+	const UINT wAmount)			//(in)	Amount of pTo in [0,FADE_ONE].
+{
+	const UINT wOldAmount = FADE_ONE - wAmount;
+
+#ifdef FADE_USE_SSE2
+	//Sixteen bytes at a time, as 16-bit products.
+	//255 * FADE_ONE fits in 16 bits, so the sums can't overflow.
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i amount = _mm_set1_epi16(static_cast<short>(wAmount));
+	const __m128i oldAmount = _mm_set1_epi16(static_cast<short>(wOldAmount));
+	while (wBytes >= 16)
+	{
+		const __m128i from = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pFrom));
+		const __m128i to = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTo));
+		const __m128i lo = _mm_srli_epi16(_mm_add_epi16(
+				_mm_mullo_epi16(_mm_unpacklo_epi8(from, zero), oldAmount),
+				_mm_mullo_epi16(_mm_unpacklo_epi8(to, zero), amount)), 8);
+		const __m128i hi = _mm_srli_epi16(_mm_add_epi16(
+				_mm_mullo_epi16(_mm_unpackhi_epi8(from, zero), oldAmount),
+				_mm_mullo_epi16(_mm_unpackhi_epi8(to, zero), amount)), 8);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pDest), _mm_packus_epi16(lo, hi));
+		pDest += 16;
+		pFrom += 16;
+		pTo += 16;
+		wBytes -= 16;
+	}
+#else
+	//Four bytes at a time, mixing alternate bytes in 16-bit lanes of a word.
+	//Only possible when all three buffers can be aligned together.
+	while (wBytes && (reinterpret_cast<size_t>(pDest) & 3))
+	{
+		*(pDest++) = (wOldAmount * *(pFrom++) + wAmount * *(pTo++)) >> 8;
+		--wBytes;
+	}
+	if (!((reinterpret_cast<size_t>(pFrom) | reinterpret_cast<size_t>(pTo)) & 3))
+	{
+		Uint32 *pDest32 = reinterpret_cast<Uint32*>(pDest);
+		const Uint32 *pFrom32 = reinterpret_cast<const Uint32*>(pFrom);
+		const Uint32 *pTo32 = reinterpret_cast<const Uint32*>(pTo);
+		for (UINT wWords = wBytes / 4; wWords--; )
+		{
+			const Uint32 from = *(pFrom32++), to = *(pTo32++);
+			const Uint32 even = (((from & 0x00FF00FF) * wOldAmount +
+					(to & 0x00FF00FF) * wAmount) >> 8) & 0x00FF00FF;
+			const Uint32 odd = (((from >> 8) & 0x00FF00FF) * wOldAmount +
+					((to >> 8) & 0x00FF00FF) * wAmount) & 0xFF00FF00;
+			*(pDest32++) = even | odd;
+		}
+		pDest = reinterpret_cast<Uint8*>(pDest32);
+		pFrom = reinterpret_cast<const Uint8*>(pFrom32);
+		pTo = reinterpret_cast<const Uint8*>(pTo32);
+		wBytes &= 3;
+	}
+#endif
+
+	//Remaining bytes.
+	while (wBytes--)
+		*(pDest++) = (wOldAmount * *(pFrom++) + wAmount * *(pTo++)) >> 8;
+}
+
 //*****************************************************************************
 void CFade::InitFade(
 //Initialize vars for fade between two surfaces.
@@ -39,6 +116,9 @@ void CFade::InitFade(
 								//		up faded to new surface when routine exits.
 	SDL_Surface* pNewSurface)	//(in)	Image that destination surface will change to.
 {
+	fadeRect.x = fadeRect.y = 0;
+	fadeRect.w = fadeRect.h = 0;
+
 	//Set NULL pointers to temporary black screens
 	//(for simple fade-in/out effects).
 	if (!pOldSurface)
@@ -104,6 +184,49 @@ void CFade::InitFade(
 	memcpy(fadeToRGB, prt, size);
 
    if ( SDL_MUSTLOCK(pOldFadeSurface) ) SDL_UnlockSurface(pOldFadeSurface);
+
+	CalcFadeRect();
+}
+
+//*****************************************************************************
+void CFade::CalcFadeRect()
+//Find the smallest rect containing all pixels that differ between the old
+//and new images.  Nothing outside of it needs to be blended or updated.
+{
+	const UINT wBPP = pOldFadeSurface->format->BytesPerPixel;
+	const UINT wPitch = pOldFadeSurface->pitch;
+	const UINT wRowBytes = pOldFadeSurface->w * wBPP;
+	int nTop = -1, nBottom = -1;
+	UINT wLeft = wRowBytes, wRight = 0;	//byte offsets within a row
+
+	for (int nY = 0; nY < pOldFadeSurface->h; ++nY)
+	{
+		const Uint8 *pFrom = fadeFromRGB + nY * wPitch;
+		const Uint8 *pTo = fadeToRGB + nY * wPitch;
+		if (!memcmp(pFrom, pTo, wRowBytes))
+			continue;
+
+		if (nTop < 0) nTop = nY;
+		nBottom = nY;
+
+		UINT wI;
+		for (wI = 0; wI < wLeft && pFrom[wI] == pTo[wI]; ++wI) ;
+		wLeft = wI;
+		for (wI = wRowBytes; wI > wRight && pFrom[wI-1] == pTo[wI-1]; --wI) ;
+		wRight = wI;
+	}
+
+	if (nTop < 0)
+	{
+		//Images are identical.
+		fadeRect.x = fadeRect.y = 0;
+		fadeRect.w = fadeRect.h = 0;
+		return;
+	}
+	fadeRect.x = wLeft / wBPP;
+	fadeRect.y = nTop;
+	fadeRect.w = (wRight + wBPP - 1) / wBPP - fadeRect.x;
+	fadeRect.h = nBottom - nTop + 1;
 }
 
 //*****************************************************************************
@@ -138,6 +261,19 @@ void CFade::ExitFade()
 void CFade::IncrementFade(
 //Show transition between two surfaces at 'ratio' between them.
 //
+//Params:
+	float fRatio)	//(in) mixing ratio [0,1].
+{
+   if (fRatio < 0.0) fRatio = 0.0;
+   if (fRatio > 1.0) fRatio = 1.0;
+
+	BlendToAmount(static_cast<UINT>(fRatio * FADE_ONE));
+}
+
+//*****************************************************************************
+void CFade::BlendToAmount(
+//Show transition between two surfaces at a fixed-point amount between them.
+//
 //'pOldFadeSurface' is the surface the fade is applied to,
 //'fadeFromRGB' is a copy of what the old screen looks like, and
 //'fadeToRGB' is a copy of what the new screen looks like,
@@ -145,36 +281,32 @@ void CFade::IncrementFade(
 //NOTE: fadeFrom, fadeTo, and pOldFadeSurface must be the same size and dimensions.
 //
 //Params:
-	float fRatio)	//(in) mixing ratio [0,1].
+	const UINT wAmount)	//(in) mixing amount [0,FADE_ONE].
 {
 	if (bOldNull && bNewNull) return;	//no fade to do
+	if (!fadeFromRGB || !fadeToRGB) return;
+	if (!fadeRect.w || !fadeRect.h) return;	//nothing changes
 
-   if (fRatio < 0.0) fRatio = 0.0;
-   if (fRatio > 1.0) fRatio = 1.0;
-
-	const Uint8 amount = (Uint8)(fRatio * 255);
-	const Uint8 nOldAmt = 255 - amount;
-
-	const Uint8 *pFrom = fadeFromRGB;
-	const Uint8 *pTo = fadeToRGB;
-	
-	//Mix pixels in "from" and "to" images by 'amount'.
-	Uint8 *pw = (Uint8 *)pOldFadeSurface->pixels;
-	const Uint32 size = pOldFadeSurface->pitch * pOldFadeSurface->h;
-	Uint8 *const pStop = pw + size;
+	ASSERT(wAmount <= FADE_ONE);
 
    if ( SDL_MUSTLOCK(pOldFadeSurface) )
 		if ( SDL_LockSurface(pOldFadeSurface) < 0 )
 			return;
 
-   do {
-      //dividing by 256 instead of 255 provides huge optimization
-	   *pw = (nOldAmt * *(pFrom++) + amount * *(pTo++)) / 256;
-   } while (++pw != pStop);
+	//Mix pixels in "from" and "to" images by 'amount', one row of the fade
+	//rect at a time.
+	const UINT wBPP = pOldFadeSurface->format->BytesPerPixel;
+	const UINT wPitch = pOldFadeSurface->pitch;
+	const UINT wRowBytes = fadeRect.w * wBPP;
+	UINT wOffset = fadeRect.y * wPitch + fadeRect.x * wBPP;
+	Uint8 *pw = (Uint8 *)pOldFadeSurface->pixels;
+	for (UINT wRow = fadeRect.h; wRow--; wOffset += wPitch)
+		BlendBytes(pw + wOffset, fadeFromRGB + wOffset, fadeToRGB + wOffset,
+				wRowBytes, wAmount);
 
    if ( SDL_MUSTLOCK(pOldFadeSurface) ) SDL_UnlockSurface(pOldFadeSurface);
 
-	SDL_UpdateRect(pOldFadeSurface, 0, 0, pOldFadeSurface->w, pOldFadeSurface->h);
+	SDL_UpdateRect(pOldFadeSurface, fadeRect.x, fadeRect.y, fadeRect.w, fadeRect.h);
 }
 
 //*****************************************************************************
@@ -188,6 +320,7 @@ void CFade::FadeBetween(
 	ASSERT(wFadeDuration > 0);
 
 	if ((bOldNull && bNewNull) || wFadeDuration == 0) return;	//no fade to do
+	if (!fadeRect.w || !fadeRect.h) return;	//nothing changes
 
 	//Fade from old to new surface.  Effect takes constant time.
 	DWORD
@@ -196,7 +329,9 @@ void CFade::FadeBetween(
 	do
 	{
 		//The +50 is to allow first frame to show some change.
-		IncrementFade((dwNow - dwFirstPaint + 50)	/ (float)wFadeDuration);
+		const DWORD dwElapsed = dwNow - dwFirstPaint + 50;
+		BlendToAmount(dwElapsed >= wFadeDuration ? FADE_ONE :
+				(dwElapsed * FADE_ONE) / wFadeDuration);
 		dwNow = SDL_GetTicks();
 	} while (dwNow - dwFirstPaint + 50 < wFadeDuration);	// constant-time effect
 }
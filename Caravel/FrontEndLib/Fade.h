@@ -51,7 +51,10 @@ private:
 	SDL_Surface *pOldFadeSurface, *pNewFadeSurface;
 	Uint8 *fadeFromRGB, *fadeToRGB;	//surface pixels
 	bool bOldNull, bNewNull;			//whether a surface is NULL
+	SDL_Rect fadeRect;					//area where the surfaces differ
 
+	void BlendToAmount(const UINT wAmount);
+	void CalcFadeRect();
 	void InitFade(SDL_Surface* pOldSurface, SDL_Surface* pNewSurface);
 	void ExitFade(void);
 };
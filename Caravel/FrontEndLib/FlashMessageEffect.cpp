@@ -49,7 +49,7 @@ CFlashMessageEffect::CFlashMessageEffect(
 
 	this->wAnimFrame = 0;
 
-	this->dwLastFrame = this->dwStartTime = SDL_GetTicks();
+	this->dwLastFrame = this->dwStartTime = GetAnimationTicks();
 }
 
 //********************************************************************************
@@ -59,7 +59,7 @@ bool CFlashMessageEffect::Draw(SDL_Surface* pDestSurface)
 	const UINT eDrawFont = (this->wAnimFrame == 0 ?
 			FONTLIB::F_FlashMessage_1 : FONTLIB::F_FlashMessage_2);
 	//End after duration has elapsed.
-	const Uint32 dwNow = SDL_GetTicks();
+	const Uint32 dwNow = GetAnimationTicks();
 	if (dwNow - dwStartTime > wDuration)
 		return false;
 
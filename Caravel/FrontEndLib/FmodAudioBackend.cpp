@@ -0,0 +1,427 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is Deadly Rooms of Death.
+ *
+ * The Initial Developer of the Original Code is
+ * Caravel Software.
+ * Portions created by the Initial Developer are Copyright (C) 2005
+ * Caravel Software. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+
+//FmodAudioBackend.cpp
+//Implementation of CFmodAudioBackend.
+
+#ifdef WIN32
+#pragma warning(disable:4786)
+#endif
+
+#include "FmodAudioBackend.h"
+
+#ifdef USE_FMOD
+
+//Lyric callback for the song playing now.  This is module-scoped because the
+//FMOD callback needs to access it.
+static LYRICCALLBACK m_pfnLyricCallback = NULL;
+
+//******************************************************************************
+static void F_CALLBACKAPI OnLyricNotePlayed(FMUSIC_MODULE* /*pModule*/, unsigned char /*InstrumentNo*/)
+//Called by FMOD whenever a note plays for the lyric instrument.
+//
+//From FMOD docs:
+//It is important to note that this callback will be called from directly WITHIN
+//the mixer / music update thread, therefore it is imperative that whatever you
+//do from this callback be extremely efficient. If the routine takes too long
+//then breakups in the sound will occur, or it will basically stop mixing until
+//you return from the function.
+{
+	if (m_pfnLyricCallback) m_pfnLyricCallback();
+}
+
+//
+//CFmodAudioBackend public methods.
+//
+
+//**********************************************************************************
+bool CFmodAudioBackend::Init(
+//Initializes FSOUND, falling back to lower mixing rates and fewer channels
+//when the best case fails.
+//
+//Params:
+	const UINT wModuleChannelCount,	//(in)	Channels set aside for songs.
+	const UINT wSampleChannelCount,	//(in)	Channels for samples.
+	string &strInitLog)				//(in/out)	Appended to with what happened.
+//
+//Returns:
+//true if at least samples will be available, false otherwise.
+{
+	const UINT CHANNEL_COUNT = wModuleChannelCount + wSampleChannelCount;
+	this->bMusicAvailable = true;
+
+	while (true) //non-looping.
+	{
+		//Compare loaded FMOD.DLL version to import library linked into .EXE.
+		if (FSOUND_GetVersion() != FMOD_VERSION) 
+		{
+			char szVersion[100];
+			sprintf(szVersion, "  FMOD.DLL version is %g and import library is %g!\r\n",
+					FSOUND_GetVersion(), FMOD_VERSION);
+			strInitLog += szVersion;
+			break;
+		}
+		else
+			strInitLog += "  FMOD.DLL version matches import library.\r\n";
+		
+		//Init FSOUND--try best case params first.  Best case includes a second
+		//set of module channels, so two songs can play during a crossfade.
+		if (FSOUND_Init(44100, CHANNEL_COUNT + wModuleChannelCount, 0)) 
+		{
+			strInitLog += "  FSOUND was initialized with best case params.\r\n";
+			this->bCrossfadeAvailable = true;
+		}
+		else if (FSOUND_Init(44100, CHANNEL_COUNT, 0)) 
+			strInitLog += "  FSOUND was initialized without crossfade channels.\r\n";
+		else
+		{
+			strInitLog += "  FSOUND_Init(44100, CHANNEL_COUNT, 0) failed.\r\n";
+
+			//Maybe the mixing rate is too high?  Try 22mhz and 11mhz.
+			if (FSOUND_Init(22050, CHANNEL_COUNT, 0)) return true;
+			strInitLog += "  FSOUND_Init(22050, CHANNEL_COUNT, 0) failed.\r\n";
+			if (FSOUND_Init(11025, CHANNEL_COUNT, 0)) return true;
+			strInitLog += "  FSOUND_Init(11025, CHANNEL_COUNT, 0) failed.\r\n";
+
+			//Maybe I'm asking for too many channels?  Try just enough for 
+			//sound effects, but not music.
+			if (FSOUND_Init(44100, wSampleChannelCount, 0))
+			{
+				//Not enough channels for music.  CSound logs this.
+				this->bMusicAvailable = false; 
+				return true;
+			}
+			strInitLog += "  FSOUND_Init(44100, SAMPLE_CHANNEL_COUNT, 0) failed.\r\n";
+
+			//I give up.
+			break;
+		}
+						
+		//Ready to play sound effects and probably music.
+		return true;
+	}
+
+	//Sadly, there will be no sound.
+	this->bMusicAvailable = this->bCrossfadeAvailable = false;
+
+	//Log the last FSOUND error which probably caused the failure.
+	GetLastFSOUNDError(strInitLog);
+		
+	//Cleanup.
+	FSOUND_Close();
+	return false;
+}
+
+//**********************************************************************************
+void CFmodAudioBackend::Deinit(void)
+{
+	FSOUND_Close();
+}
+
+//**********************************************************************************
+SAMPLEHANDLE CFmodAudioBackend::LoadSample(
+//Loads a sample from a wave file read into memory.
+//
+//Params:
+	const BYTE *pData,				//(in)	Contents of the wave file.
+	const UINT dwSize,				//(in)	Size of contents.
+	const WCHAR * /*pwszFilepath*/)
+//
+//Returns:
+//The sample, or NULL if it didn't load.
+{
+	FSOUND_SAMPLE *pSample = FSOUND_Sample_Load(FSOUND_FREE, (const char*)pData, 
+			FSOUND_2D | FSOUND_LOADMEMORY, 0, dwSize);
+	if (pSample) FSOUND_Sample_SetMode(pSample, FSOUND_LOOP_OFF);
+	return pSample;
+}
+
+//**********************************************************************************
+void CFmodAudioBackend::FreeSample(SAMPLEHANDLE hSample)
+{
+	FSOUND_Sample_Free(static_cast<FSOUND_SAMPLE *>(hSample));
+}
+
+//**********************************************************************************
+DWORD CFmodAudioBackend::GetChannelMSecsLeft(
+//Figures out how long the sample playing on a channel has left to play.
+//
+//Params:
+	const int nChannel)	//(in)	Channel to check.
+//
+//Returns:
+//Msecs left, or 0 if nothing is playing on the channel.
+{
+	if (!FSOUND_IsPlaying(nChannel)) return 0L;
+
+	FSOUND_SAMPLE *pSample = FSOUND_GetCurrentSample(nChannel);
+	const int nFrequency = FSOUND_GetFrequency(nChannel);
+	if (!pSample || nFrequency <= 0)
+		return 10L;	//can't tell--check again shortly
+
+	const UINT wLength = FSOUND_Sample_GetLength(pSample);
+	const UINT wPosition = FSOUND_GetCurrentPosition(nChannel);
+	const UINT wLeft = wPosition < wLength ? wLength - wPosition : 0;
+	return (wLeft / nFrequency) * 1000 + (wLeft % nFrequency) * 1000 / nFrequency + 1;
+}
+
+//**********************************************************************************
+bool CFmodAudioBackend::IsChannelPlaying(const int nChannel)
+{
+	return FSOUND_IsPlaying(nChannel) != 0;
+}
+
+//**********************************************************************************
+bool CFmodAudioBackend::PlaySample(
+//Plays a sample, stopping any other sample playing on the channel.
+//
+//Params:
+	const int nChannel,		//(in)	Channel to play on.
+	SAMPLEHANDLE hSample)	//(in)	Sample to play.
+//
+//Returns:
+//True if it played, false if not.
+{
+	if (!FSOUND_StopSound(nChannel)) ASSERTP(false, "Failed to stop sound.");
+	return FSOUND_PlaySound(nChannel, static_cast<FSOUND_SAMPLE *>(hSample)) != 0;
+}
+
+//**********************************************************************************
+bool CFmodAudioBackend::ReserveChannel(
+//Reserves a channel so that FMOD doesn't use it for playing songs.
+//
+//Params:
+	const int nChannel)	//(in)	Channel to reserve.
+{
+	return FSOUND_SetReserved(nChannel, true) != 0;
+}
+
+//**********************************************************************************
+void CFmodAudioBackend::SetSampleVolume(const int nVolume)
+{
+	FSOUND_SetSFXMasterVolume(nVolume);
+}
+
+//**********************************************************************************
+bool CFmodAudioBackend::StopChannel(const int nChannel)
+{
+	return FSOUND_StopSound(nChannel) != 0;
+}
+
+//**********************************************************************************
+SONGHANDLE CFmodAudioBackend::LoadSong(
+//Loads a song from a file read into memory.
+//
+//Params:
+	const BYTE *pData,				//(in)	Contents of the song file.
+	const UINT dwSize,				//(in)	Size of contents.
+	const WCHAR * /*pwszFilepath*/)
+//
+//Returns:
+//The song, or NULL if it didn't load.
+{
+	return FMUSIC_LoadSongEx((const char*)pData,0,dwSize,FSOUND_LOADMEMORY,NULL,1);
+}
+
+//**********************************************************************************
+void CFmodAudioBackend::FreeSong(SONGHANDLE hSong)
+{
+	FMUSIC_FreeSong(static_cast<FMUSIC_MODULE *>(hSong));
+}
+
+//**********************************************************************************
+int CFmodAudioBackend::GetSongVolume(SONGHANDLE hSong)
+{
+	return FMUSIC_GetMasterVolume(static_cast<FMUSIC_MODULE *>(hSong));
+}
+
+//**********************************************************************************
+bool CFmodAudioBackend::IsSongFinished(
+//Returns whether the song has completed playing, or when the last order has 
+//finished playing.  This stays set even if the song loops.
+	SONGHANDLE hSong)
+{
+	return FMUSIC_IsFinished(static_cast<FMUSIC_MODULE *>(hSong)) != 0;
+}
+
+//**********************************************************************************
+bool CFmodAudioBackend::PlaySong(SONGHANDLE hSong)
+{
+	return FMUSIC_PlaySong(static_cast<FMUSIC_MODULE *>(hSong)) != 0;
+}
+
+//**********************************************************************************
+bool CFmodAudioBackend::SetLyricCallback(
+//Has a callback called whenever a note plays for an instrument in the song.
+//Only one song's callback is kept.
+//
+//Params:
+	SONGHANDLE hSong,				//(in)	Song to count notes in.
+	const int nInstrumentNo,		//(in)	Instrument that corresponds to lyrics.
+	LYRICCALLBACK pfnCallback)		//(in)	Called for each note, or NULL to stop
+									//		calling back for this song's notes.
+//
+//Returns:
+//True if the callback was set, false if not.
+{
+	if (!pfnCallback)
+		return FMUSIC_SetInstCallback(static_cast<FMUSIC_MODULE *>(hSong),
+				NULL, nInstrumentNo) != 0;
+
+	m_pfnLyricCallback = pfnCallback;
+	return FMUSIC_SetInstCallback(static_cast<FMUSIC_MODULE *>(hSong),
+			OnLyricNotePlayed, nInstrumentNo) != 0;
+}
+
+//**********************************************************************************
+void CFmodAudioBackend::SetSongVolume(SONGHANDLE hSong, const int nVolume)
+{
+	FMUSIC_SetMasterVolume(static_cast<FMUSIC_MODULE *>(hSong), nVolume);
+}
+
+//**********************************************************************************
+bool CFmodAudioBackend::StopSong(SONGHANDLE hSong)
+{
+	return FMUSIC_StopSong(static_cast<FMUSIC_MODULE *>(hSong)) != 0;
+}
+
+//
+//CFmodAudioBackend private methods.
+//
+
+//***********************************************************************************
+int CFmodAudioBackend::GetLastFSOUNDError(
+//Gets last FSOUND error code along with test description.
+//
+//Params:
+	string &strErrDesc)	//(in/out)	Corresponds to error code.  Appends to end of 
+						//			string which may or may not be empty.
+//
+//Returns:
+//Error code or FMOD_ERR_NONE if no FSOUND error.
+const
+{
+	int nErrCode = FSOUND_GetError();
+	char szTemp[30];
+	sprintf(szTemp, "    FMOD Error #%d: ", nErrCode);
+	strErrDesc += szTemp;
+
+	//These are taken out of the FMOD 3.5 docs.  Update with new versions as
+	//needed.
+	switch (nErrCode)
+	{
+		case FMOD_ERR_NONE: 
+			strErrDesc +=	"No errors.\r\n"; 
+		break;
+		
+		case FMOD_ERR_BUSY: 
+			strErrDesc +=	"Cannot call this command after FSOUND_Init. Call "
+							"FSOUND_Close first.\r\n"; 
+		break;
+		
+		case FMOD_ERR_UNINITIALIZED: 
+			strErrDesc +=	"This command failed because FSOUND_Init or "
+							"FSOUND_SetOutput was not called.\r\n"; 
+		break;
+ 
+		case FMOD_ERR_INIT:
+			strErrDesc +=	"Error initializing output device.\r\n";
+		break;
+ 
+		case FMOD_ERR_ALLOCATED:
+			strErrDesc +=	"Error initializing output device, but more "
+							"specifically, the output device is already in use and "
+							"cannot be reused.\r\n";
+ 		break;
+
+		case FMOD_ERR_PLAY:
+			strErrDesc +=	"Playing the sound failed.\r\n";
+ 		break;
+ 
+		case FMOD_ERR_OUTPUT_FORMAT:
+			strErrDesc +=	"Soundcard does not support the features needed for "
+							"this soundsystem (16bit stereo output).\r\n";
+ 		break;
+ 
+		case FMOD_ERR_COOPERATIVELEVEL:
+			strErrDesc +=	"Error setting cooperative level for hardware.\r\n";
+ 		break;
+ 
+		case FMOD_ERR_CREATEBUFFER:
+			strErrDesc +=	"Error creating hardware sound buffer.\r\n";
+ 		break;
+ 
+		case FMOD_ERR_FILE_NOTFOUND:
+			strErrDesc +=	"File not found.\r\n";
+ 		break;
+ 
+		case FMOD_ERR_FILE_FORMAT:
+			strErrDesc +=	"Unknown file format.\r\n";
+ 		break;
+ 
+		case FMOD_ERR_FILE_BAD:
+			strErrDesc +=	"Error loading file.\r\n";
+ 		break;
+ 
+		case FMOD_ERR_MEMORY:
+			strErrDesc +=	"Not enough memory or resources.\r\n";
+ 		break;
+ 
+		case FMOD_ERR_VERSION:
+			strErrDesc +=	"The version number of this file format is not "
+							"supported.\r\n";
+ 		break;
+ 
+		case FMOD_ERR_INVALID_PARAM:
+			strErrDesc +=	"An invalid parameter was passed to this "
+							"function.\r\n";
+ 		break;
+ 
+		case FMOD_ERR_NO_EAX:
+			strErrDesc +=	"Tried to use an EAX command on a non EAX enabled "
+							"channel or output.\r\n";
+ 		break;
+ 
+		case FMOD_ERR_CHANNEL_ALLOC:
+			strErrDesc +=	"Failed to allocate a new channel.\r\n";
+ 		break;
+ 
+		case FMOD_ERR_RECORD:
+			strErrDesc +=	"Recording is not supported on this machine.\r\n";
+ 		break;
+ 
+		case FMOD_ERR_MEDIAPLAYER:
+			strErrDesc +=	"Windows Media Player not installed so cannot play wma "
+							"or use internet streaming.\r\n";
+		break;
+
+		default:
+			strErrDesc +=	"Description unavailable.\r\n";
+	}
+
+	return nErrCode;
+}
+
+#endif //...#ifdef USE_FMOD
@@ -0,0 +1,76 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is Deadly Rooms of Death.
+ *
+ * The Initial Developer of the Original Code is
+ * Caravel Software.
+ * Portions created by the Initial Developer are Copyright (C) 2005
+ * Caravel Software. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+
+//FmodAudioBackend.h
+//Declarations for CFmodAudioBackend.
+//Audio backend that plays samples and songs with FMOD 3.
+
+#ifndef FMODAUDIOBACKEND_H
+#define FMODAUDIOBACKEND_H
+
+#include "AudioBackend.h"
+
+#ifdef USE_FMOD
+
+#include <fmod.h>
+
+class CFmodAudioBackend : public CAudioBackend
+{
+public:
+	CFmodAudioBackend(void) {}
+	virtual ~CFmodAudioBackend(void) {}
+
+	virtual bool	Init(const UINT wModuleChannelCount, const UINT wSampleChannelCount,
+			string &strInitLog);
+	virtual void	Deinit(void);
+
+	virtual SAMPLEHANDLE LoadSample(const BYTE *pData, const UINT dwSize,
+			const WCHAR *pwszFilepath);
+	virtual void	FreeSample(SAMPLEHANDLE hSample);
+	virtual DWORD	GetChannelMSecsLeft(const int nChannel);
+	virtual bool	IsChannelPlaying(const int nChannel);
+	virtual bool	PlaySample(const int nChannel, SAMPLEHANDLE hSample);
+	virtual bool	ReserveChannel(const int nChannel);
+	virtual void	SetSampleVolume(const int nVolume);
+	virtual bool	StopChannel(const int nChannel);
+
+	virtual SONGHANDLE LoadSong(const BYTE *pData, const UINT dwSize,
+			const WCHAR *pwszFilepath);
+	virtual void	FreeSong(SONGHANDLE hSong);
+	virtual int		GetSongVolume(SONGHANDLE hSong);
+	virtual bool	IsSongFinished(SONGHANDLE hSong);
+	virtual bool	PlaySong(SONGHANDLE hSong);
+	virtual bool	SetLyricCallback(SONGHANDLE hSong, const int nInstrumentNo,
+			LYRICCALLBACK pfnCallback);
+	virtual void	SetSongVolume(SONGHANDLE hSong, const int nVolume);
+	virtual bool	StopSong(SONGHANDLE hSong);
+
+private:
+	int				GetLastFSOUNDError(string &strErrorDesc) const;
+};
+
+#endif //...#ifdef USE_FMOD
+
+#endif //...#ifndef FMODAUDIOBACKEND_H
@@ -31,6 +31,7 @@
 #include "Outline.h"
 
 #include <BackEndLib/Files.h>
+#include <BackEndLib/SysTimer.h>
 #include <BackEndLib/Wchar.h>
 
 //Holds the only instance of CFontManager for the app.
@@ -48,6 +49,7 @@ CFontManager::CFontManager()
 	: vFontCache(0)	//init empty font cache
 	, LoadedFonts(NULL)
    , pColorMapSurface(NULL)
+   , pRenderTime(NULL)
 //Constructor.
 {
 }
@@ -130,7 +132,7 @@ WSTRING CFontManager::CalcPartialWord(
 //
 //Params:
 	const UINT eFontType,		//(in)	Indicates font and associated settings.
-   WCHAR *wczWord,            //(in)   Word to render.
+   const WCHAR *wczWord,      //(in)   Word to render.
    const UINT wWordLen,       //(in)   # chars in word.
    const int nMaxWidth,       //(in)   Allotted width.
    UINT &wCharsNotDrawn)      //(out)  The number of chars that still need to be drawn.
@@ -181,7 +183,7 @@ void CFontManager::DrawPartialWord(
 //
 //Params:
 	const UINT eFontType,		//(in)	Indicates font and associated settings.
-   WCHAR *wczWord,            //(in)   Word to render.
+   const WCHAR *wczWord,      //(in)   Word to render.
    const UINT wWordLen,       //(in)   # chars in word.
    const int xDraw, const int yDraw,//(in)   Coord to start drawing word at.
    const UINT wXLimit,        //(in)	Dest rectangle x-pixel limit.
@@ -208,25 +210,33 @@ const
 }
 
 //*********************************************************************************
-void CFontManager::DrawTextToRect(
-//Draw text within a rectangle on a surface.
+void CFontManager::BuildTextLayout(
+//Break text into rows that fit within a width and find where each word goes.
+//The same rules are used by DrawTextToRect() and GetTextRectHeight(), so a
+//layout can be drawn with DrawTextLayout() and measured from its accessors.
 //
 //Params:
 	const UINT eFontType,		//(in)	Indicates font and associated settings.
-	const WCHAR *pwczText,	//(in)	Text to draw.
-	int nX, int nY,			//(in)	Dest coords.
-	UINT wW, UINT wH,		//(in)	Dest width and height to draw within.
-	SDL_Surface *pSurface)	//(in)	Dest surface.
+	const WCHAR *pwczText,	//(in)	Text to lay out.
+	const UINT wW,				//(in)	Width to lay out text within.
+	CTextLayout &layout,		//(out)	Receives the layout.
+	const UINT wMaxH)			//(in)	Stop after rows below this height (0 = no
+									//		limit, which is required for measuring).
 const
 {
 	const LOADEDFONT *pFont = &(this->LoadedFonts[eFontType]);
 	ASSERT(pFont->pTTFFont);
-	if (pFont->wLineSkipHeight > wH) return; //No room to display any text.
 
-	if (WCSlen(pwczText) == 0) return; //Nothing to do.
-	
+	layout.Clear();
+	layout.eFontType = eFontType;
+	layout.wstrText = pwczText;
+	layout.wW = wW;
+	layout.wMaxH = wMaxH;
+	layout.wLineH = pFont->wLineSkipHeight;
+	layout.wSpaceW = pFont->wSpaceWidth;
+
 	//Adjust drawing position for any spaces and CRLFs preceding the first word.
-	int xDraw = nX, yDraw = nY;
+	UINT xDraw = 0, yDraw = 0;
 	const WCHAR *pwczSeek = pwczText;
 	UINT wSpaceCount, wCRLFCount;
 	pwczSeek = DrawText_SkipOverNonWord(pwczSeek, wSpaceCount, wCRLFCount);
@@ -235,68 +245,80 @@ const
 	else
 		xDraw += (wSpaceCount * pFont->wSpaceWidth);
 
-	//Each iteration draws one word to surface.
-	SDL_Surface *pText = NULL;
+	//Each iteration places one word.
 	WCHAR wczWord[MAXLEN_WORD + 1];
-	UINT wWordLen;
-	while (yDraw + (int)pFont->wLineSkipHeight <= (int)(nY + wH) && *pwczSeek != '\0')
+	UINT wWordLen, wWordW;
+	while ((!wMaxH || yDraw + pFont->wLineSkipHeight <= wMaxH) && *pwczSeek != '\0')
 	{
+		TEXTLAYOUTWORD word;
+		word.wTextStart = pwczSeek - pwczText;
+		word.bWordEnd = true;
+		word.bRowEnd = false;
+		word.bWrapped = false;
+		word.xPrev = word.yPrev = 0;
+
 		//Copy the next word into buffer.
 		pwczSeek = DrawText_CopyNextWord(pwczSeek, wczWord, wWordLen);
-
-		//Render the text.
-		if (pText) SDL_FreeSurface(pText);
-		pText = RenderWord(eFontType, wczWord);
-		if (!pText) {ASSERTP(false, "Failed to render word.(3)"); return;}
+		word.wTextEnd = pwczSeek - pwczText;
+		word.wstrRendered = wczWord;
+		wWordW = 0;
+		GetWordWidth(eFontType, wczWord, wWordW);
 
 		//Does rendered text fit horizontally in rect after drawing point?
-		if (static_cast<UINT>(xDraw + pText->w) <= nX + wW)
-      {
-         //Rendered text fits.
-			//Blit word to dest surface.
-			SDL_Rect src = {0, 0, pText->w, pText->h};
-			SDL_Rect dest = {xDraw, yDraw, pText->w, pText->h};
-			SDL_BlitSurface(pText, &src, pSurface, &dest);
-
-			xDraw += pText->w;
-      } else {
-         //Would the text fit horizontally at the beginning of a row?
-			if (static_cast<UINT>(pText->w) > wW) //No.
-         {
+		if (xDraw + wWordW <= wW)
+		{
+			//Rendered text fits.
+			word.x = xDraw;
+			word.y = yDraw;
+			word.wW = wWordW;
+			layout.words.push_back(word);
+			xDraw += wWordW;
+		} else {
+			//Would the text fit horizontally at the beginning of a row?
+			if (wWordW > wW) //No.
+			{
 				//Moving down to a new row won't help draw this text.  So
 				//draw it char-by-char until one char doesn't fit.
-            UINT wNumCharsLeft;
-            DrawPartialWord(eFontType, wczWord, wWordLen, xDraw, yDraw, nX + wW,
-               pSurface, wNumCharsLeft);
-            pwczSeek -= wNumCharsLeft;
+				UINT wNumCharsLeft;
+				word.wstrRendered = CalcPartialWord(eFontType, wczWord, wWordLen,
+						(int)wW - (int)xDraw, wNumCharsLeft);
+				pwczSeek -= wNumCharsLeft;
+				if (!word.wstrRendered.empty())
+				{
+					word.wTextEnd -= wNumCharsLeft;
+					word.bWordEnd = (wNumCharsLeft == 0);
+					word.bRowEnd = true;
+					word.x = xDraw;
+					word.y = yDraw;
+					word.wW = 0;
+					GetWordWidth(eFontType, word.wstrRendered.c_str(), word.wW);
+					layout.words.push_back(word);
+					xDraw += word.wW;
+				}
+				else if (xDraw == 0)
+					break;	//Not even one char fits on a row -- nothing more can be drawn.
 
 				//Jump down to next row.
-				xDraw = nX;
+				if (xDraw > layout.wLongestLineW) layout.wLongestLineW = xDraw;
+				xDraw = 0;
 				yDraw += pFont->wLineSkipHeight;
-            continue;   //don't need to check for whitespace
+				continue;   //don't need to check for whitespace
 			} //...Text won't fit on a row by itself.
 			else
 			{
-				//Blit word to dest surface on next row,
-            //if another row will fit in rectangle.
-	         if (yDraw + (int)pFont->wLineSkipHeight * 2 <= (int)(nY + wH))
-            {
-				   xDraw = nX;
-				   yDraw += pFont->wLineSkipHeight;
-				   SDL_Rect src = {0, 0, pText->w, pText->h};
-				   SDL_Rect dest = {xDraw, yDraw, pText->w, pText->h};
-				   SDL_BlitSurface(pText, &src, pSurface, &dest);
-
-				   xDraw += pText->w;
-            } else {
-               //Otherwise, just draw as much as will fit on this (last) row.
-               UINT wNumCharsLeft;
-               DrawPartialWord(eFontType, wczWord, wWordLen, xDraw, yDraw,
-                     nX + wW, pSurface, wNumCharsLeft);
-
-               xDraw = nX;
-				   yDraw += pFont->wLineSkipHeight;
-            }
+				//Place word on next row.  If it turns out there is no room for
+				//that row when drawing, part of it goes on this row instead.
+				word.bWrapped = true;
+				word.xPrev = xDraw;
+				word.yPrev = yDraw;
+				if (xDraw > layout.wLongestLineW) layout.wLongestLineW = xDraw;
+				xDraw = 0;
+				yDraw += pFont->wLineSkipHeight;
+				word.x = xDraw;
+				word.y = yDraw;
+				word.wW = wWordW;
+				layout.words.push_back(word);
+				xDraw += wWordW;
 			}
 		}
 
@@ -304,14 +326,90 @@ const
 		pwczSeek = DrawText_SkipOverNonWord(pwczSeek, wSpaceCount, wCRLFCount);
 		if (wCRLFCount)
 		{
-			xDraw = nX;
+			if (xDraw > layout.wLongestLineW) layout.wLongestLineW = xDraw;
+			xDraw = 0;
 			yDraw += (pFont->wLineSkipHeight * wCRLFCount);
 		}
 		else
 			xDraw += pFont->wSpaceWidth * wSpaceCount;
-	} //...while yDraw is not past the rect.
+	} //...while yDraw is not past the limit.
+
+	layout.bTruncated = (*pwczSeek != '\0');
+
+	if (xDraw > layout.wLongestLineW) layout.wLongestLineW = xDraw;
+	if (layout.wLongestLineW > wW) layout.wLongestLineW = wW; //Sometimes it's a few pixels over.
+	layout.wLastLineW = xDraw;
+	layout.wH = yDraw + pFont->wLineSkipHeight;
+}
+
+//*********************************************************************************
+void CFontManager::DrawTextLayout(
+//Draw previously laid out text within a rectangle on a surface.
+//
+//Params:
+	const CTextLayout &layout,	//(in)	Layout from BuildTextLayout().
+	int nX, int nY,			//(in)	Dest coords.
+	UINT wH,					//(in)	Dest height to draw within.
+	SDL_Surface *pSurface)	//(in)	Dest surface.
+const
+{
+	const UINT eFontType = layout.eFontType;
+	SDL_Surface *pText = NULL;
+	for (vector<TEXTLAYOUTWORD>::const_iterator word = layout.words.begin();
+			word != layout.words.end(); ++word)
+	{
+		if (word->y + layout.wLineH > wH)
+		{
+			//No room for this row.  A word that was moved down to it is drawn
+			//as much as will fit on the (last) row above instead.
+			if (word->bWrapped && word->yPrev + layout.wLineH <= wH)
+			{
+				//As in DrawText_CopyNextWord(), a trailing dash isn't counted
+				//in the word length.
+				UINT wWordLen = word->wstrRendered.size();
+				if (wWordLen && word->wstrRendered[wWordLen-1] == '-')
+					--wWordLen;
+				UINT wNumCharsLeft;
+				DrawPartialWord(eFontType, word->wstrRendered.c_str(), wWordLen,
+						nX + word->xPrev, nY + word->yPrev, nX + layout.wW,
+						pSurface, wNumCharsLeft);
+			}
+			break;
+		}
+
+		//Render the text.
+		pText = RenderWord(eFontType, word->wstrRendered.c_str());
+		if (!pText) {ASSERTP(false, "Failed to render word.(3)"); return;}
+
+		//Blit word to dest surface.
+		SDL_Rect src = {0, 0, pText->w, pText->h};
+		SDL_Rect dest = {nX + word->x, nY + word->y, pText->w, pText->h};
+		SDL_BlitSurface(pText, &src, pSurface, &dest);
+		SDL_FreeSurface(pText);
+	}
+}
+
+//*********************************************************************************
+void CFontManager::DrawTextToRect(
+//Draw text within a rectangle on a surface.
+//
+//Params:
+	const UINT eFontType,		//(in)	Indicates font and associated settings.
+	const WCHAR *pwczText,	//(in)	Text to draw.
+	int nX, int nY,			//(in)	Dest coords.
+	UINT wW, UINT wH,		//(in)	Dest width and height to draw within.
+	SDL_Surface *pSurface)	//(in)	Dest surface.
+const
+{
+	const LOADEDFONT *pFont = &(this->LoadedFonts[eFontType]);
+	ASSERT(pFont->pTTFFont);
+	if (pFont->wLineSkipHeight > wH) return; //No room to display any text.
+
+	if (WCSlen(pwczText) == 0) return; //Nothing to do.
 
-	if (pText) SDL_FreeSurface(pText);
+	CTextLayout layout;
+	BuildTextLayout(eFontType, pwczText, wW, layout, wH);
+	DrawTextLayout(layout, nX, nY, wH, pSurface);
 }
 
 //*********************************************************************************
@@ -409,100 +507,13 @@ UINT CFontManager::GetTextRectHeight(
 //The width of the last line.
 const
 {
-	const LOADEDFONT *pFont = &(this->LoadedFonts[eFontType]);
-	ASSERT(pFont->pTTFFont);
-
-	//Adjust drawing position for any spaces and CRLFs preceding the first word.
-	UINT xDraw = 0, yDraw = 0;
-	const WCHAR *pwczSeek = pwczText;
-	UINT wSpaceCount, wCRLFCount;
-	pwczSeek = DrawText_SkipOverNonWord(pwczSeek, wSpaceCount, wCRLFCount);
-	if (wCRLFCount)
-		yDraw += (wCRLFCount * pFont->wLineSkipHeight);
-	else
-		xDraw += (wSpaceCount * pFont->wSpaceWidth);
-
-	//Each iteration draws one word to surface.
-	wLongestLineW = 0;
-	SDL_Surface *pText = NULL;
-	WCHAR wczWord[MAXLEN_WORD + 1];
-	UINT wWordLen;
-	while (*pwczSeek != '\0')
-	{
-		//Copy the next word into buffer.
-		pwczSeek = DrawText_CopyNextWord(pwczSeek, wczWord, wWordLen);
-
-		//Render the text.
-		if (pText) SDL_FreeSurface(pText);
-		pText = RenderWord(eFontType, wczWord, true);
-		if (!pText) {ASSERTP(false, "Failed to render word.(5)"); return 0L;}
-
-		//Does rendered text fit horizontally in rect after drawing point?
-		if (xDraw + pText->w > wW) //No.
-		{
-			//Would the text fit horizontally at the beginning of a row?
-			if (static_cast<UINT>(pText->w) > wW) //No.
-         {
-				//Moving down to a new row won't help draw this text.  So
-				//draw it char-by-char until one char doesn't fit.
-            UINT wCharI;
-				for (wCharI = 0; wCharI < wWordLen; ++wCharI)
-				{
-					static WCHAR wczChar[2] = { W_t(0), W_t(0) };
-					wczChar[0] = wczWord[wCharI];
-
-					//Render the char.
-					if (pText) SDL_FreeSurface(pText);
-					pText = RenderWord(eFontType, wczChar, true);
-					if (!pText) {ASSERTP(false, "Failed to render word.(6)"); return 0L;}
-
-					//Is char past right bound?
-					if (xDraw + pText->w > wW) //Yes.
-						break;
-					else
-						xDraw += pText->w;
-				}
-            //Render the rest on the next line.
-            pwczSeek -= wWordLen - wCharI + 1;
-
-				//Jump down to next row.
-				if (xDraw > wLongestLineW) wLongestLineW = xDraw;
-				xDraw = 0;
-				yDraw += pFont->wLineSkipHeight;
-            continue;   //don't need to check for whitespace
-			} //...Text won't fit on a row by itself.
-			else
-			{
-				//Move down to next row.
-	         if (xDraw > wLongestLineW) wLongestLineW = xDraw;
-				xDraw = pText->w;
-				yDraw += pFont->wLineSkipHeight;
-			}
-		} //...Rendered text does not fit horizontally within rect.
-		else
-			//Rendered text fits.
-			xDraw += pText->w;
-
-		//Adjust drawing position for spaces and CRLFs found after word.
-		pwczSeek = DrawText_SkipOverNonWord(pwczSeek, wSpaceCount, wCRLFCount);
-		if (wCRLFCount)
-		{
-			if (xDraw > wLongestLineW) wLongestLineW = xDraw;
-			xDraw = 0;
-			yDraw += (pFont->wLineSkipHeight * wCRLFCount);
-		}
-		else
-			xDraw += pFont->wSpaceWidth * wSpaceCount;
-	} //...while yDraw is not past the rect.
+	CTextLayout layout;
+	BuildTextLayout(eFontType, pwczText, wW, layout);
 
-	if (pText) SDL_FreeSurface(pText);
+	wLongestLineW = layout.GetLongestLineW();
+	wH = layout.GetHeight();
 
-	if (xDraw > wLongestLineW) wLongestLineW = xDraw;
-	if (wLongestLineW > wW) wLongestLineW = wW; //Sometimes it's a few pixels over.
-
-	wH = yDraw + pFont->wLineSkipHeight;
-
-   return xDraw;
+   return layout.GetLastLineW();
 }
 
 //*****************************************************************************
@@ -558,7 +569,8 @@ const
 
 //*****************************************************************************
 void CFontManager::GetWordWidth(
-//Get width of a word of rendered text.
+//Get width of a word of rendered text.  The word is measured without being
+//rendered, so text can be laid out and then drawn with one render per word.
 //NOTE: Call this to initialize font spacing width.
 //
 //Params:
@@ -567,12 +579,15 @@ void CFontManager::GetWordWidth(
 	UINT &wW)		//(out)	Width of the text.
 const
 {
-  	//Render the word.
-	SDL_Surface *pText = RenderWord(eFontType, wczWord, true);
-	if (!pText) {ASSERTP(false,"Failed to render word.(8)."); return;}
+	//Rendered surfaces are as wide as this, and outlining doesn't widen them.
+	const LOADEDFONT *pFont = &(this->LoadedFonts[eFontType]);
+	ASSERT(pFont->pTTFFont);
+	int nW, nH;
+	if (TTF_SizeUNICODE(pFont->pTTFFont, reinterpret_cast<const Uint16*>(wczWord),
+			&nW, &nH) < 0)
+		{ASSERTP(false,"Failed to size word.(8)."); return;}
 
-   wW = pText->w;
-	SDL_FreeSurface(pText);
+   wW = nW;
 }
 
 //*****************************************************************************
@@ -609,6 +624,7 @@ const
 
 	const LOADEDFONT *pFont = &(this->LoadedFonts[eFontType]);
 	ASSERT(pFont->pTTFFont);
+	const ULONGLONG qwStart = this->pRenderTime ? GetMicroTicks() : 0;
 
 	//Draw the text.
 	if (pFont->bAntiAlias && !bRenderFast)
@@ -637,6 +653,8 @@ const
 		AddOutline(pText, pFont->OutlineColor, pFont->wOutlineWidth);
 	}
 
+	if (this->pRenderTime)
+		*this->pRenderTime += GetMicroTicks() - qwStart;
 	return pText;
 }
 
@@ -741,6 +759,106 @@ const
 	return pwczSeek;
 }
 
+//
+//CTextLayout methods.
+//
+
+//*********************************************************************************
+void CTextLayout::Clear()
+//Empties the layout.
+{
+	this->eFontType = static_cast<UINT>(FONTLIB::F_Unspecified);
+	this->wstrText.resize(0);
+	this->wW = this->wMaxH = 0;
+	this->wLineH = this->wSpaceW = 0;
+	this->words.clear();
+	this->bTruncated = false;
+	this->wH = this->wLongestLineW = this->wLastLineW = 0;
+}
+
+//*********************************************************************************
+bool CTextLayout::IsFor(
+//Returns: whether this layout was built from the same params, and so doesn't
+//need to be rebuilt.
+//
+//Params:
+	const UINT eFontType, const WCHAR *pwczText, const UINT wW, const UINT wMaxH)
+const
+{
+	return this->eFontType == eFontType && this->wW == wW &&
+			this->wMaxH == wMaxH && this->wstrText == pwczText;
+}
+
+//*********************************************************************************
+bool CTextLayout::GetPenPosition(
+//Gets the drawing position after the first wTextLen chars of the text, i.e.
+//what GetTextRectHeight() would give for just those chars: the width of the
+//last line and the top of the last row.
+//
+//Params:
+	const UINT wTextLen,		//(in)	Length of text prefix.
+	UINT &wX, UINT &wY)		//(out)	Drawing position.
+//
+//Returns:
+//False if the prefix ends within a word, or past what was laid out.  A word
+//might be broken differently when it is cut short, so the caller must lay
+//out the prefix by itself in this case.
+const
+{
+	if (wTextLen > this->wstrText.size()) return false;
+
+	//Find the last word that ends within the prefix.
+	UINT wSeek = 0;
+	bool bInWord = false, bRowEnd = false;
+	wX = wY = 0;
+	vector<TEXTLAYOUTWORD>::const_iterator word;
+	for (word = this->words.begin(); word != this->words.end(); ++word)
+	{
+		if (word->wTextEnd > wTextLen)
+		{
+			if (word->wTextStart < wTextLen)
+				return false;	//prefix ends within this word
+			break;
+		}
+		if (word->bRowEnd)
+		{
+			wX = 0;
+			wY = word->y + this->wLineH;
+		} else {
+			wX = word->x + word->wW;
+			wY = word->y;
+		}
+		wSeek = word->wTextEnd;
+		bInWord = !word->bWordEnd;
+		bRowEnd = word->bRowEnd;
+	}
+	if (bInWord)
+		return false;	//rest of the word is on the next row
+	if (word == this->words.end() && this->bTruncated)
+		return false;
+	if (bRowEnd && wSeek < wTextLen)
+		return false;	//whitespace isn't skipped after a word broken over rows
+
+	//Adjust drawing position for spaces and CRLFs after the last word.
+	UINT wSpaceCount = 0, wCRLFCount = 0;
+	for ( ; wSeek < wTextLen; ++wSeek)
+	{
+		const WCHAR wc = this->wstrText[wSeek];
+		if (wc == ' ') ++wSpaceCount;
+		else if (wc == '\r') ++wCRLFCount;
+		else if (wc != '\n') return false;
+	}
+	if (wCRLFCount)
+	{
+		wX = 0;
+		wY += this->wLineH * wCRLFCount;
+	}
+	else
+		wX += this->wSpaceW * wSpaceCount;
+
+	return true;
+}
+
 // $Log: FontManager.cpp,v $
 // Revision 1.22  2005/03/15 21:54:33  mrimer
 // Fixed memory leak.
@@ -101,6 +101,52 @@ namespace FONTLIB
 	};
 };
 
+//One word (or piece of a word) placed within a CTextLayout.
+typedef struct tagTextLayoutWord
+{
+	UINT		wTextStart, wTextEnd;	//Span of source text covered by this word.
+	WSTRING	wstrRendered;			//Text to render.  Ends with a dash when a
+										//word is too long to fit on one row.
+	UINT		x, y;						//Position relative to top-left of layout.
+	UINT		wW;						//Rendered width.
+	bool		bWordEnd;				//False when rest of word is on the next row.
+	bool		bRowEnd;					//Set when drawing continues on the next row.
+	bool		bWrapped;				//If set, the word was moved down from the
+	UINT		xPrev, yPrev;			//row at (xPrev,yPrev), where part of it will
+										//be drawn if no more rows fit in the rect.
+} TEXTLAYOUTWORD;
+
+//****************************************************************************
+class CTextLayout
+//Line breaks and word positions for text drawn with one font within one width.
+//Built by CFontManager::BuildTextLayout() and reused by callers that measure
+//and draw the same text repeatedly.
+{
+public:
+	CTextLayout() {Clear();}
+
+	void			Clear();
+	UINT			GetHeight() const {return this->wH;}
+	UINT			GetLastLineW() const {return this->wLastLineW;}
+	UINT			GetLongestLineW() const {return this->wLongestLineW;}
+	bool			GetPenPosition(const UINT wTextLen, UINT &wX, UINT &wY) const;
+	bool			IsFor(const UINT eFontType, const WCHAR *pwczText, const UINT wW,
+			const UINT wMaxH=0) const;
+
+private:
+	friend class CFontManager;
+
+	UINT			eFontType;
+	WSTRING		wstrText;
+	UINT			wW, wMaxH;		//Width laid out within and height limit (0 = none).
+	UINT			wLineH, wSpaceW;	//Font spacing at time of layout.
+
+	vector<TEXTLAYOUTWORD> words;
+	bool			bTruncated;		//Set when not all text could be laid out.
+
+	UINT			wH, wLongestLineW, wLastLineW;
+};
+
 //****************************************************************************
 class CFontManager
 {
@@ -108,13 +154,17 @@ public:
 	CFontManager(void);
 	virtual ~CFontManager(void);
 	
-   WSTRING     CalcPartialWord(const UINT eFontType, WCHAR *wczWord,
+	void			BuildTextLayout(const UINT eFontType, const WCHAR *pwczText,
+			const UINT wW, CTextLayout &layout, const UINT wMaxH=0) const;
+   WSTRING     CalcPartialWord(const UINT eFontType, const WCHAR *wczWord,
          const UINT wWordLen, const int nMaxWidth, UINT &wCharsNotDrawn) const;
 	void			DrawTextXY(const UINT eFontType, const WCHAR *pwczText,
          SDL_Surface *pSurface, const int nX, const int nY,
          const UINT wWidth=0, const UINT wHeight=0) const;
 	void			DrawTextToRect(const UINT eFontType, const WCHAR *pwczText, 
 			int nX, int nY, UINT wW, UINT wH, SDL_Surface *pSurface) const;
+	void			DrawTextLayout(const CTextLayout &layout, int nX, int nY,
+			UINT wH, SDL_Surface *pSurface) const;
 	void			DrawHotkeyTextToLine(const UINT eFontType,
 			const WCHAR *pwczText, int nX, int nY, UINT wW, SDL_Surface *pSurface) const;
 	SDL_Color		GetFontBackColor(const UINT eFontType) const {return this->LoadedFonts[eFontType].BackColor;}
@@ -128,15 +178,19 @@ public:
 	void			GetWordWidth(const UINT eFontType, const WCHAR *pwczWord,
 			UINT &wW) const;
 	virtual UINT		Init()=0;
+	ULONGLONG		GetRenderTime() const {
+			return this->pRenderTime ? *this->pRenderTime : 0;}
 	void			SetFontColor(const UINT eFontType, SDL_Color color) {
 			this->LoadedFonts[eFontType].ForeColor = color;}
+	void			SetRenderTime(ULONGLONG *pSetRenderTime) {
+			this->pRenderTime = pSetRenderTime;}
 
 protected:
 	const WCHAR *	DrawText_CopyNextWord(const WCHAR *pwczStart,	
 			WCHAR *wczWord, UINT &wWordLen) const;
 	const WCHAR *	DrawText_SkipOverNonWord(const WCHAR *pwczStart, 
 			UINT &wTrailSpaceCount,	UINT &wTrailCRLFCount) const;
-   void        DrawPartialWord(const UINT eFontType, WCHAR *wczWord,
+   void        DrawPartialWord(const UINT eFontType, const WCHAR *wczWord,
          const UINT wWordLen, const int xDraw, const int yDraw,
          const UINT wXLimit, SDL_Surface *pSurface,
          UINT& wCharsNotDrawn) const;
@@ -150,6 +204,7 @@ protected:
 	LOADEDFONT		*LoadedFonts;
 
 	SDL_Surface *	pColorMapSurface;
+	ULONGLONG *		pRenderTime;	//if set, microseconds spent rendering words are added here
 };
 
 //Define global pointer to the one and only CFontManager object.
@@ -23,8 +23,11 @@
  * ***** END LICENSE BLOCK ***** */
 
 #include "FrameRateEffect.h"
+#include "EventHandlerWidget.h"
 #include "FontManager.h"
 
+static const WCHAR wszKilo[] = {W_t('k'), W_t(0)};
+
 //
 //Public methods.
 //
@@ -70,15 +73,24 @@ bool CFrameRateEffect::Draw(SDL_Surface* pDestSurface)
 	this->wLastFrameRate = wFrameRate;
 	this->wLastDisplayFrameRate = wDisplayFrameRate;
 
-	//Display frame rate in top-left corner of widget.
-	WCHAR wczFrameRate[20];
-	_itoW(wDisplayFrameRate, wczFrameRate, 10);
-	g_pTheFM->DrawTextXY(FONTLIB::F_FrameRate, wczFrameRate, pDestSurface,
+	//Display frame rate in top-left corner of widget, followed by the
+	//thousands of pixels pushed to the display last frame.
+	WCHAR wczNum[20];
+	WSTRING wstrFrameRate;
+	_itoW(wDisplayFrameRate, wczNum, 10);
+	wstrFrameRate += wczNum;
+	wstrFrameRate += wszSpace;
+	_itoW(CEventHandlerWidget::GetLastFrameUpdateStats().dwPixelsPushed / 1000,
+			wczNum, 10);
+	wstrFrameRate += wczNum;
+	wstrFrameRate += wszKilo;
+	g_pTheFM->DrawTextXY(FONTLIB::F_FrameRate, wstrFrameRate.c_str(), pDestSurface,
          this->x, this->y);
 
 	//Get area of effect.
 	UINT cxDraw, cyDraw;
-	g_pTheFM->GetTextWidthHeight(FONTLIB::F_FrameRate, wczFrameRate, cxDraw, cyDraw);
+	g_pTheFM->GetTextWidthHeight(FONTLIB::F_FrameRate, wstrFrameRate.c_str(),
+			cxDraw, cyDraw);
 	this->rAreaOfEffect.w = cxDraw;
 	this->rAreaOfEffect.h = cyDraw;
 
@@ -87,6 +87,14 @@ LIB32=link.exe -lib
 # PROP Default_Filter ""
 # Begin Source File
 
+SOURCE=.\AudioBackend.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\AudioBackend.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\BitmapManager.cpp
 # End Source File
 # Begin Source File
@@ -111,6 +119,14 @@ SOURCE=.\Fade.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\FmodAudioBackend.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\FmodAudioBackend.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\FontManager.cpp
 # End Source File
 # Begin Source File
@@ -135,6 +151,14 @@ SOURCE=.\Pan.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\SDLMixerAudioBackend.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\SDLMixerAudioBackend.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\Sound.cpp
 # End Source File
 # Begin Source File
@@ -66,9 +66,9 @@ const
 		return;
 	}
 
-	//Ask font manager about it.
-	g_pTheFM->GetTextRectHeight(this->eFontType, this->wstrText.c_str(), 
-			this->w, wW, wH);
+	const CTextLayout &layout = GetTextLayout();
+	wW = layout.GetLongestLineW();
+	wH = layout.GetHeight();
 }
 
 //*****************************************************************************
@@ -87,13 +87,8 @@ void CLabelWidget::SetText(
 
 	if (bResizeToFit)
 	{
-		//Get text height from the font manager.
-		UINT wTextW, wTextH;
-		g_pTheFM->GetTextRectHeight(this->eFontType, this->wstrText.c_str(), 
-			this->w, wTextW, wTextH);
-
 		//Resize height to fit text.
-		Resize(this->w, wTextH);
+		Resize(this->w, GetTextLayout().GetHeight());
 	}
 }
 
@@ -112,24 +107,36 @@ void CLabelWidget::Paint(
 	int nOffsetX, nOffsetY;
 	GetScrollOffset(nOffsetX, nOffsetY);
 
+	const CTextLayout &layout = GetTextLayout();
 	UINT wLineOffsetX = 0;
 
 	//Get drawing X coord for centered text.
 	if (this->eTextAlign == TA_CenterGroup)
-	{
-		UINT wLongestLineW, wH;
-		g_pTheFM->GetTextRectHeight(this->eFontType, this->wstrText.c_str(), 
-				this->w, wLongestLineW, wH);
-		wLineOffsetX = (this->w - wLongestLineW) / 2;
-	}
+		wLineOffsetX = (this->w - layout.GetLongestLineW()) / 2;
 	
-	g_pTheFM->DrawTextToRect(this->eFontType, this->wstrText.c_str(), 
+	g_pTheFM->DrawTextLayout(layout, 
 			this->x + wLineOffsetX + nOffsetX, this->y + nOffsetY,
-			this->w, this->h, GetDestSurface());
+			this->h, GetDestSurface());
 
 	if (bUpdateRect) UpdateRect();
 }
 
+//
+//Private methods.
+//
+
+//*****************************************************************************
+const CTextLayout& CLabelWidget::GetTextLayout()
+//Gets layout of the label's text, only laying it out again when the text,
+//font or width has changed since the last call.
+const
+{
+	if (!this->textLayout.IsFor(this->eFontType, this->wstrText.c_str(), this->w))
+		g_pTheFM->BuildTextLayout(this->eFontType, this->wstrText.c_str(),
+				this->w, this->textLayout);
+	return this->textLayout;
+}
+
 // $Log: LabelWidget.cpp,v $
 // Revision 1.3  2003/07/19 02:13:00  mrimer
 // Modified API for a method in CFontManager.
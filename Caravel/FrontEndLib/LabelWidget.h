@@ -54,9 +54,13 @@ public:
 	void				SetText(const WCHAR *pwczSetText, bool bResizeToFit=false);
 
 private:
+	const CTextLayout &	GetTextLayout() const;
+
 	WSTRING				wstrText;
 	UINT			eFontType;
 	TEXTALIGN			eTextAlign;
+
+	mutable CTextLayout	textLayout;	//kept between paints
 };
 
 #endif //#ifndef LABELWIDGET_H
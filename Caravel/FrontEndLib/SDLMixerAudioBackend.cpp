@@ -0,0 +1,317 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is Deadly Rooms of Death.
+ *
+ * The Initial Developer of the Original Code is
+ * Caravel Software.
+ * Portions created by the Initial Developer are Copyright (C) 2005
+ * Caravel Software. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+
+//SDLMixerAudioBackend.cpp
+//Implementation of CSDLMixerAudioBackend.
+
+#ifdef WIN32
+#pragma warning(disable:4786)
+#endif
+
+#include "SDLMixerAudioBackend.h"
+
+#ifdef USE_SDL_MIXER
+
+#include <string.h>
+
+//Set when the song playing reaches its end.  This is module-scoped because the
+//SDL_mixer callback needs to access it.
+static volatile bool m_bSongEnded = false;
+
+//******************************************************************************
+static void OnMusicFinished(void)
+//Called by SDL_mixer when a song stops, from its mixer thread if the song
+//ended.  SDL_mixer functions can't be called from here.
+{
+	m_bSongEnded = true;
+}
+
+//
+//CSDLMixerAudioBackend public methods.
+//
+
+//**********************************************************************************
+CSDLMixerAudioBackend::CSDLMixerAudioBackend(void)
+//Constructor.
+	: pPlayingSong(NULL), dwBytesPerSec(0L)
+{
+}
+
+//**********************************************************************************
+bool CSDLMixerAudioBackend::Init(
+//Opens the audio device, falling back to a lower mixing rate if needed.
+//
+//Params:
+	const UINT wModuleChannelCount,	//(in)	Channels set aside for songs.  SDL_mixer
+									//		plays songs apart from its channels, but
+									//		these are allocated so that sample channel
+									//		numbers match the other backends.
+	const UINT wSampleChannelCount,	//(in)	Channels for samples.
+	string &strInitLog)				//(in/out)	Appended to with what happened.
+//
+//Returns:
+//true if samples and music will be available, false otherwise.
+{
+	if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0)
+	{
+		strInitLog += "  SDL_InitSubSystem(SDL_INIT_AUDIO) failed: ";
+		strInitLog += SDL_GetError();
+		strInitLog += "\r\n";
+		return false;
+	}
+
+	if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0)
+	{
+		strInitLog += "  Mix_OpenAudio(44100, ...) failed.\r\n";
+		if (Mix_OpenAudio(22050, MIX_DEFAULT_FORMAT, 2, 1024) < 0)
+		{
+			strInitLog += "  Mix_OpenAudio(22050, ...) failed: ";
+			strInitLog += Mix_GetError();
+			strInitLog += "\r\n";
+			SDL_QuitSubSystem(SDL_INIT_AUDIO);
+			return false;
+		}
+	}
+	strInitLog += "  SDL_mixer was initialized.\r\n";
+
+	int nFrequency, nChannels;
+	Uint16 wFormat;
+	Mix_QuerySpec(&nFrequency, &wFormat, &nChannels);
+	this->dwBytesPerSec = nFrequency * nChannels * ((wFormat & 0xFF) / 8);
+
+	const UINT wChannelCount = wModuleChannelCount + wSampleChannelCount;
+	Mix_AllocateChannels(wChannelCount);
+	this->ChannelStartTimes.assign(wChannelCount, 0);
+	this->ChannelLengths.assign(wChannelCount, 0L);
+	Mix_HookMusicFinished(OnMusicFinished);
+
+	this->bMusicAvailable = true;
+	return true;
+}
+
+//**********************************************************************************
+void CSDLMixerAudioBackend::Deinit(void)
+{
+	Mix_HookMusicFinished(NULL);
+	Mix_HaltMusic();
+	this->pPlayingSong = NULL;
+	Mix_CloseAudio();
+	SDL_QuitSubSystem(SDL_INIT_AUDIO);
+}
+
+//**********************************************************************************
+SAMPLEHANDLE CSDLMixerAudioBackend::LoadSample(
+//Loads a sample from a wave file read into memory.
+//
+//Params:
+	const BYTE *pData,				//(in)	Contents of the wave file.
+	const UINT dwSize,				//(in)	Size of contents.
+	const WCHAR * /*pwszFilepath*/)
+//
+//Returns:
+//The sample, or NULL if it didn't load.
+{
+	return Mix_LoadWAV_RW(SDL_RWFromMem(const_cast<BYTE *>(pData), dwSize), 1);
+}
+
+//**********************************************************************************
+void CSDLMixerAudioBackend::FreeSample(SAMPLEHANDLE hSample)
+{
+	Mix_FreeChunk(static_cast<Mix_Chunk *>(hSample));
+}
+
+//**********************************************************************************
+DWORD CSDLMixerAudioBackend::GetChannelMSecsLeft(
+//Figures out how long the sample playing on a channel has left to play, from
+//when it started.  SDL_mixer doesn't report a channel's position.
+//
+//Params:
+	const int nChannel)	//(in)	Channel to check.
+//
+//Returns:
+//Msecs left, or 0 if nothing is playing on the channel.
+{
+	if (!Mix_Playing(nChannel)) return 0L;
+
+	const DWORD dwElapsed = SDL_GetTicks() - this->ChannelStartTimes[nChannel];
+	return dwElapsed < this->ChannelLengths[nChannel] ?
+			this->ChannelLengths[nChannel] - dwElapsed + 1 : 1L;
+}
+
+//**********************************************************************************
+bool CSDLMixerAudioBackend::IsChannelPlaying(const int nChannel)
+{
+	return Mix_Playing(nChannel) != 0;
+}
+
+//**********************************************************************************
+bool CSDLMixerAudioBackend::PlaySample(
+//Plays a sample, stopping any other sample playing on the channel.
+//
+//Params:
+	const int nChannel,		//(in)	Channel to play on.
+	SAMPLEHANDLE hSample)	//(in)	Sample to play.
+//
+//Returns:
+//True if it played, false if not.
+{
+	Mix_Chunk *pChunk = static_cast<Mix_Chunk *>(hSample);
+	if (Mix_PlayChannel(nChannel, pChunk, 0) < 0) return false;
+
+	this->ChannelStartTimes[nChannel] = SDL_GetTicks();
+	this->ChannelLengths[nChannel] = this->dwBytesPerSec ?
+			(DWORD)((double)pChunk->alen * 1000.0 / this->dwBytesPerSec) : 0L;
+	return true;
+}
+
+//**********************************************************************************
+void CSDLMixerAudioBackend::SetSampleVolume(const int nVolume)
+{
+	Mix_Volume(-1, nVolume * MIX_MAX_VOLUME / 255);
+}
+
+//**********************************************************************************
+bool CSDLMixerAudioBackend::StopChannel(const int nChannel)
+{
+	Mix_HaltChannel(nChannel);
+	return true;
+}
+
+//**********************************************************************************
+SONGHANDLE CSDLMixerAudioBackend::LoadSong(
+//Loads a song from a file read into memory.  Needs SDL_mixer 1.2.7 or later.
+//
+//Params:
+	const BYTE *pData,				//(in)	Contents of the song file.
+	const UINT dwSize,				//(in)	Size of contents.
+	const WCHAR * /*pwszFilepath*/)
+//
+//Returns:
+//The song, or NULL if it didn't load.
+{
+	SDLMIXERSONG *pSong = new SDLMIXERSONG;
+	pSong->pData = new BYTE[dwSize];
+	memcpy(pSong->pData, pData, dwSize);
+	pSong->pRW = SDL_RWFromMem(pSong->pData, dwSize);
+	pSong->pMusic = pSong->pRW ? Mix_LoadMUS_RW(pSong->pRW) : NULL;
+	pSong->nVolume = 255;
+	pSong->bFinished = false;
+	if (!pSong->pMusic)
+	{
+		if (pSong->pRW) SDL_FreeRW(pSong->pRW);
+		delete[] pSong->pData;
+		delete pSong;
+		return NULL;
+	}
+	return pSong;
+}
+
+//**********************************************************************************
+void CSDLMixerAudioBackend::FreeSong(SONGHANDLE hSong)
+{
+	SDLMIXERSONG *pSong = static_cast<SDLMIXERSONG *>(hSong);
+	if (pSong == this->pPlayingSong) StopSong(hSong);
+	Mix_FreeMusic(pSong->pMusic);
+	SDL_FreeRW(pSong->pRW);
+	delete[] pSong->pData;
+	delete pSong;
+}
+
+//**********************************************************************************
+int CSDLMixerAudioBackend::GetSongVolume(SONGHANDLE hSong)
+{
+	return static_cast<SDLMIXERSONG *>(hSong)->nVolume;
+}
+
+//**********************************************************************************
+bool CSDLMixerAudioBackend::IsSongFinished(
+//A song is finished once it has played through, been stopped, or been
+//replaced by another song.  This stays set once the song loops.
+	SONGHANDLE hSong)
+{
+	SDLMIXERSONG *pSong = static_cast<SDLMIXERSONG *>(hSong);
+	return pSong != this->pPlayingSong || pSong->bFinished || m_bSongEnded;
+}
+
+//**********************************************************************************
+bool CSDLMixerAudioBackend::PlaySong(
+//Plays a song, looping.  Any other song playing stops.  The first time through
+//is played once, so its end can be seen, and ContinueSongs() loops it after.
+//
+//Params:
+	SONGHANDLE hSong)	//(in)	Song to play.
+//
+//Returns:
+//True if it played, false if not.
+{
+	SDLMIXERSONG *pSong = static_cast<SDLMIXERSONG *>(hSong);
+	Mix_VolumeMusic(pSong->nVolume * MIX_MAX_VOLUME / 255);
+	if (Mix_PlayMusic(pSong->pMusic, 0) < 0) return false;
+	m_bSongEnded = false;
+	pSong->bFinished = false;
+	this->pPlayingSong = pSong;
+	return true;
+}
+
+//**********************************************************************************
+void CSDLMixerAudioBackend::SetSongVolume(SONGHANDLE hSong, const int nVolume)
+{
+	SDLMIXERSONG *pSong = static_cast<SDLMIXERSONG *>(hSong);
+	pSong->nVolume = nVolume;
+	if (pSong == this->pPlayingSong)
+		Mix_VolumeMusic(nVolume * MIX_MAX_VOLUME / 255);
+}
+
+//**********************************************************************************
+bool CSDLMixerAudioBackend::StopSong(SONGHANDLE hSong)
+{
+	if (hSong == this->pPlayingSong)
+	{
+		Mix_HaltMusic();
+		m_bSongEnded = false;
+		this->pPlayingSong = NULL;
+	}
+	return true;
+}
+
+//**********************************************************************************
+bool CSDLMixerAudioBackend::ContinueSongs(void)
+//Once the song playing has played through, restarts it looping forever.
+//
+//Returns:
+//True while the song is still on its first time through.
+{
+	SDLMIXERSONG *pSong = this->pPlayingSong;
+	if (!pSong || pSong->bFinished) return false;
+	if (!m_bSongEnded) return true;
+
+	m_bSongEnded = false;
+	pSong->bFinished = true;
+	if (Mix_PlayMusic(pSong->pMusic, -1) < 0)
+		this->pPlayingSong = NULL;
+	return false;
+}
+
+#endif //...#ifdef USE_SDL_MIXER
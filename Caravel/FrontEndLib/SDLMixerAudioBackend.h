@@ -0,0 +1,99 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is Deadly Rooms of Death.
+ *
+ * The Initial Developer of the Original Code is
+ * Caravel Software.
+ * Portions created by the Initial Developer are Copyright (C) 2005
+ * Caravel Software. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+
+//SDLMixerAudioBackend.h
+//Declarations for CSDLMixerAudioBackend.
+//Audio backend that plays samples and songs with SDL_mixer.
+
+#ifndef SDLMIXERAUDIOBACKEND_H
+#define SDLMIXERAUDIOBACKEND_H
+
+#include "AudioBackend.h"
+
+#ifdef USE_SDL_MIXER
+
+#include <SDL_mixer.h>
+
+#include <vector>
+
+//A song loaded by SDL_mixer.  SDL_mixer reads the song from pRW while it
+//plays, so the file's contents are kept with it.
+typedef struct tagSDLMixerSong
+{
+	Mix_Music *		pMusic;
+	SDL_RWops *		pRW;
+	BYTE *			pData;
+	int				nVolume;
+	bool			bFinished;		//has played through once, and loops from then on
+} SDLMIXERSONG;
+
+//SDL_mixer plays one song at a time, so there are no crossfades, and it has
+//no note callbacks, so lyric notes aren't counted.  SDL_mixer doesn't report
+//when a looping song starts over, so a song plays through once and then is
+//restarted looping by ContinueSongs().
+class CSDLMixerAudioBackend : public CAudioBackend
+{
+public:
+	CSDLMixerAudioBackend(void);
+	virtual ~CSDLMixerAudioBackend(void) {}
+
+	virtual bool	Init(const UINT wModuleChannelCount, const UINT wSampleChannelCount,
+			string &strInitLog);
+	virtual void	Deinit(void);
+
+	virtual SAMPLEHANDLE LoadSample(const BYTE *pData, const UINT dwSize,
+			const WCHAR *pwszFilepath);
+	virtual void	FreeSample(SAMPLEHANDLE hSample);
+	virtual DWORD	GetChannelMSecsLeft(const int nChannel);
+	virtual bool	IsChannelPlaying(const int nChannel);
+	virtual bool	PlaySample(const int nChannel, SAMPLEHANDLE hSample);
+	virtual bool	ReserveChannel(const int /*nChannel*/) {return true;}
+	virtual void	SetSampleVolume(const int nVolume);
+	virtual bool	StopChannel(const int nChannel);
+
+	virtual SONGHANDLE LoadSong(const BYTE *pData, const UINT dwSize,
+			const WCHAR *pwszFilepath);
+	virtual void	FreeSong(SONGHANDLE hSong);
+	virtual int		GetSongVolume(SONGHANDLE hSong);
+	virtual bool	IsSongFinished(SONGHANDLE hSong);
+	virtual bool	PlaySong(SONGHANDLE hSong);
+	virtual bool	SetLyricCallback(SONGHANDLE /*hSong*/, const int /*nInstrumentNo*/,
+			LYRICCALLBACK /*pfnCallback*/) {return false;}
+	virtual void	SetSongVolume(SONGHANDLE hSong, const int nVolume);
+	virtual bool	StopSong(SONGHANDLE hSong);
+	virtual bool	ContinueSongs(void);
+
+private:
+	SDLMIXERSONG *	pPlayingSong;
+	DWORD			dwBytesPerSec;			//of mixer output
+
+	//When the sample on each channel started and how long it plays.
+	vector<Uint32>	ChannelStartTimes;
+	vector<DWORD>	ChannelLengths;
+};
+
+#endif //...#ifdef USE_SDL_MIXER
+
+#endif //...#ifndef SDLMIXERAUDIOBACKEND_H
@@ -42,10 +42,8 @@ CScalerWidget::CScalerWidget(
 {
 	this->pTrueScaleSurface = NULL;
 	this->bNewScaleDimensions = false;
-	this->ppTrueToDestScaleMap = NULL;
-
-	this->nAntiAliasY = 0;
-	this->bAntiAliasInProgress = false;
+	this->pColumnTaps = this->pRowTaps = NULL;
+	this->pBlendedRow = NULL;
 
 	this->pTrueScaleContainer = new CFrameWidget(TAG_UNSPECIFIED, 0, 0, 0, 0, wszEmpty);
 }
@@ -122,7 +120,7 @@ bool CScalerWidget::Load(void)
 {
 	ASSERT(!this->bIsLoaded);
 	ASSERT(!this->pTrueScaleSurface);
-	ASSERT(!this->ppTrueToDestScaleMap);
+	ASSERT(!this->pColumnTaps && !this->pRowTaps && !this->pBlendedRow);
 
 	SDL_Rect ContainerRect;
 	this->pTrueScaleContainer->GetRect(ContainerRect);
@@ -155,15 +153,10 @@ void CScalerWidget::Unload(void)
 		this->pTrueScaleSurface = NULL;
 	}
 	
-	if (this->ppTrueToDestScaleMap)
-	{
-		delete [] this->ppTrueToDestScaleMap;
-		this->ppTrueToDestScaleMap = NULL;
-	}
+	DeleteScaleInstructions();
 	
 	//In case widget is reloaded, force reinits on everything.
 	this->bNewScaleDimensions = true;
-	this->bAntiAliasInProgress = false;
 
 	this->bIsLoaded = false;
 }
@@ -202,7 +195,6 @@ CWidget * CScalerWidget::AddScaledWidget(
 
 		pTrueScaleContainer->Resize(ChildrenRect.w, ChildrenRect.h);
 		this->bNewScaleDimensions = true;
-		this->bAntiAliasInProgress = false;
 	}
 
 	//If widget was added after CScalerWidget loaded, then set dest surface.
@@ -218,7 +210,6 @@ void CScalerWidget::Resize(UINT wSetW, UINT wSetH)
 {
 	CWidget::Resize(wSetW, wSetH);
 	this->bNewScaleDimensions = true;
-	this->bAntiAliasInProgress = false;
 }
 
 //***************************************************************************************
@@ -270,19 +261,13 @@ void CScalerWidget::Paint(
 		}
 		if (!CalcScaleInstructions()) {ASSERTP(false, "Calc scale instr. failed."); return;}
 		this->bNewScaleDimensions = false;
-		this->bAntiAliasInProgress = false;
 	}
 
 	//Paint scaled children to true-scale surface.
 	this->pTrueScaleContainer->PaintChildren(false);
 
-	//Draw quick scale to widget area.
-	DrawScaledQuick();
-	
-	//Set up members to later draw anti-aliased during animate.
-	//Try to anti-alias in about one second.
-	this->nAntiAliasY = this->y;
-	this->bAntiAliasInProgress = true;
+	//Draw anti-aliased scale to widget area.
+	DrawScaled();
 
 	//Paint children (non-scaled).
 	PaintChildren();
@@ -291,210 +276,74 @@ void CScalerWidget::Paint(
 	if (bUpdateRect) UpdateRect();
 }
 
-//
-//Protected methods.
-//
-
-//***************************************************************************************
-void CScalerWidget::HandleAnimate(void)
-//Handles animation occurring between events.
-{
-	ASSERT(IsVisible());
-
-	if (this->bAntiAliasInProgress)
-	{	
-		//I'm going to spend 25ms working on the anti-aliased image each time
-		//HandleAnimate() is called.  HandleAnimate() probably won't be called 
-		//more often than 33ms (30 fps) so this gives the event-handler a little
-		//time to work on other things.  A higher value might result in choppiness.
-		//A lower value would make the anti-aliasing take longer.  If it seems
-		//like the value should be different on different screens, then we can
-		//add a method to set the maximum time to spend per animate.
-		const DWORD MAX_TIME_PER_ANIMATE = 25;
-
-		//Anti-alias the lines.
-		UINT wAntiAliasLineCount =
-				DrawAntiAliasedLines(this->nAntiAliasY, MAX_TIME_PER_ANIMATE);
-
-		//Update anti-aliasing status.
-		this->nAntiAliasY += wAntiAliasLineCount;
-		this->bAntiAliasInProgress = (this->nAntiAliasY < static_cast<int>(this->y + this->h));
-
-		//Paint children (non-scaled).
-		PaintChildren();
-
-		//Show finished anti-aliasing when done.
-		if (!this->bAntiAliasInProgress) UpdateRect();
-	}
-}
-
 //
 //Private methods.
 //
 
 //***************************************************************************************
-void CScalerWidget::DrawScaledQuick(void)
-//Do a quick scaled draw from true-scale surface to widget area on screen surface.
+void CScalerWidget::DrawScaled(void)
+//Draw an anti-aliased scale from true-scale surface to widget area on screen surface.
+//
+//Each destination row is drawn by first blending its two source rows into
+//pBlendedRow, then blending two samples of that row for each destination pixel.
+//Both passes use precomputed taps and 8-bit fixed point weights, so the inner
+//loops are plain integer arithmetic over packed bytes.
 {
 	ASSERT(!this->bNewScaleDimensions);
 	ASSERT(this->pTrueScaleSurface);
-	ASSERT(this->ppTrueToDestScaleMap);
+	ASSERT(this->pColumnTaps && this->pRowTaps && this->pBlendedRow);
 
 	SDL_Surface *pDestSurface = LockDestSurface();
 	const UINT wBPP = pDestSurface->format->BytesPerPixel;
 	ASSERT(wBPP == 3);
-
-	//Set pointer to first element of map.  There is one element for each
-	//destination pixel that points to a pixel in the true-scale surface to be copied.
-	Uint8 * *ppSrc = this->ppTrueToDestScaleMap;
-	
-	//Calc offset between end of a row and beginning of next.
-	DWORD dwRowOffset = (pDestSurface->w - this->w) * wBPP;
-
-	//Calc location of topleft pixel.
-	Uint8 *pSeek = (Uint8 *)(pDestSurface->pixels) + 
-			( (this->y * pDestSurface->w) + this->x) * wBPP;
-
-	//Calc location of bottomleft pixel plus one row too far.
-	Uint8 *pEndOfSeek = pSeek + (this->h * pDestSurface->w * wBPP);
-
-	//Each iteration fills one row of pixels.
-	Uint8 *pEndOfRow, *pSrc;
-	while (pSeek != pEndOfSeek)
-	{
-		ASSERT(pSeek < pEndOfSeek);
-		pEndOfRow = pSeek + (this->w * wBPP);
-
-		//Each iteration sets 3 bytes (1 pixel) from the scale map.
-		while (pSeek != pEndOfRow)
-		{
-			pSrc = *ppSrc;
-			pSeek[0] = pSrc[0];
-			pSeek[1] = pSrc[1];
-			pSeek[2] = pSrc[2];
-			pSeek += wBPP;
-
-			++ppSrc;
-		}
-
-		//Advance to beginning of next row.
-		pSeek += dwRowOffset;
-	}
-
-	UnlockDestSurface();
-}
-
-//***************************************************************************************
-UINT CScalerWidget::DrawAntiAliasedLines(
-//Draw one or more destination lines using the true-scale surface for source.
-//Pixels will be anti-aliased by averaging their neighbors.
-//
-//Params:
-	int nStartY,		//(in)	Destination line at which to begin drawing.
-	DWORD dwMaxTime)	//(in)	Maximum amount of time, in milliseconds to spend
-						//		in routine.  Actually, routine is likely to go
-						//		a tiny bit longer.
-//
-//Returns:
-//Number of lines that were drawn.
-{
-	DWORD dwStopTime = SDL_GetTicks() + dwMaxTime;
-
-	//Number of source pixels to move for each dest pixel.
-	SDL_Rect ContainerRect;
-	this->pTrueScaleContainer->GetRect(ContainerRect);
-	const double dblIncSrcX = (double) ContainerRect.w / (double) this->w;
-	const double dblIncSrcY = (double) ContainerRect.h / (double) this->h;
-	
-	//Algorithm is incorrect if dest is less than half the size of source.
-	//It only uses a maximum of four source pixels to average into one dest pixel.
-	ASSERT(dblIncSrcX <= 2 && dblIncSrcY <= 2);
-	
-	//Lock dest surface for pixel copying.
-	SDL_Surface *pDestSurface = LockDestSurface();
-	const UINT wBPP = pDestSurface->format->BytesPerPixel;
-
-	//Copy pixels over.
-	Uint8 *pSrc, *pSrcTop, *pDest, *pSrcEast, *pSrcSouth, *pSrcSoutheast;
-	UINT xSrc, ySrc;
-	double dblSouthOffsetPercent, dblEastOffsetPercent, dblSoutheastOffsetPercent;
-	double dblSrcPercent, dblSrcX;
-	double dblSrcY = dblIncSrcY * (double) (nStartY - this->y);
+	ASSERT(this->pTrueScaleSurface->format->BytesPerPixel == 3);
 
 	//shorthand vars for speed optimization
-	const UINT yEnd = this->y + this->h;
-	const UINT xEnd = this->x + this->w;
-	const UINT yEndMinusOne = yEnd - 1;
-	const UINT xEndMinusOne = xEnd - 1;
-	const UINT thisx = this->x;
-	const UINT wPitch =	this->pTrueScaleSurface->pitch;
-
-	//Loop vars.
-	double yPercent;
-	double xPercent;
-	double OneMinusYPercent;
+	const UINT wRowBytes = this->pTrueScaleSurface->w * 3;
+	const Uint8 *pSrcPixels = static_cast<const Uint8 *>(this->pTrueScaleSurface->pixels);
+	Uint16 *pBlended = this->pBlendedRow;
+	Uint8 *pDestRow = (Uint8 *)(pDestSurface->pixels) +
+			(this->y * pDestSurface->pitch) + (this->x * wBPP);
+	const SCALETAP *pColumnTapsEnd = this->pColumnTaps + this->w;
 
 	//Each iteration draws one anti-aliased line.
-   UINT yDest;
-	for (yDest = nStartY; yDest < yEndMinusOne; ++yDest)
+	const SCALETAP *pLastRowTap = NULL;
+	for (const SCALETAP *pRowTap = this->pRowTaps, *pRowTapsEnd = this->pRowTaps + this->h;
+			pRowTap != pRowTapsEnd; ++pRowTap)
 	{
-		dblSrcX = 0;
-		ySrc = (UINT) dblSrcY;
-		yPercent = dblSrcY - ySrc;	//shorthand
-		OneMinusYPercent = 1.0 - yPercent;
-
-		//init
-		pDest = (Uint8 *)(pDestSurface->pixels) +
-					(yDest * pDestSurface->pitch) + (this->x * wBPP);
-		pSrcTop = (Uint8 *)(this->pTrueScaleSurface->pixels) +
-					(ySrc * wPitch);
+		//Blend the two source rows, unless the previous dest row used the same ones.
+		//Result is 8.8 fixed point.
+		if (!pLastRowTap || pLastRowTap->dwOffset0 != pRowTap->dwOffset0 ||
+				pLastRowTap->wWeight != pRowTap->wWeight)
+		{
+			const Uint8 *pTop = pSrcPixels + pRowTap->dwOffset0;
+			const Uint8 *pBottom = pSrcPixels + pRowTap->dwOffset1;
+			const UINT wBottom = pRowTap->wWeight, wTop = 256 - wBottom;
+			for (UINT wI = 0; wI < wRowBytes; ++wI)
+				pBlended[wI] = static_cast<Uint16>(pTop[wI] * wTop + pBottom[wI] * wBottom);
+			pLastRowTap = pRowTap;
+		}
 
 		//Each iteration draws one anti-aliased pixel.
-		for (UINT xDest = thisx; xDest < xEndMinusOne; ++xDest)
+		Uint8 *pDest = pDestRow;
+		for (const SCALETAP *pColumnTap = this->pColumnTaps;
+				pColumnTap != pColumnTapsEnd; ++pColumnTap)
 		{
-			xSrc = (UINT) dblSrcX;
-			xPercent = dblSrcX - xSrc;	//shorthand
-
-			dblSouthOffsetPercent = yPercent * (1.0 - xPercent);
-			dblEastOffsetPercent = xPercent * OneMinusYPercent;
-			dblSoutheastOffsetPercent = yPercent * xPercent;
-			ASSERT(dblEastOffsetPercent + dblSouthOffsetPercent +
-					dblSoutheastOffsetPercent <= 1.0);
-			dblSrcPercent = 1.0 - dblSoutheastOffsetPercent - dblEastOffsetPercent -
-				dblSouthOffsetPercent;
-
-			//last row and column are skipped to avoid lots of bounds logic here
-			pSrc = pSrcTop + (xSrc * wBPP);
-			pSrcEast = pSrc + wBPP;
-			pSrcSouth = pSrc + wPitch;
-			pSrcSoutheast = pSrcSouth + wBPP;
-
-			pDest[0] = static_cast<Uint8>(pSrc[0] * dblSrcPercent +
-						pSrcEast[0] * dblEastOffsetPercent +
-						pSrcSouth[0] * dblSouthOffsetPercent +
-						pSrcSoutheast[0] * dblSoutheastOffsetPercent);
-
-			pDest[1] = static_cast<Uint8>(pSrc[1] * dblSrcPercent +
-						pSrcEast[1] * dblEastOffsetPercent +
-						pSrcSouth[1] * dblSouthOffsetPercent +
-						pSrcSoutheast[1] * dblSoutheastOffsetPercent);
-
-			pDest[2] = static_cast<Uint8>(pSrc[2] * dblSrcPercent +
-						pSrcEast[2] * dblEastOffsetPercent +
-						pSrcSouth[2] * dblSouthOffsetPercent +
-						pSrcSoutheast[2] * dblSoutheastOffsetPercent);
-
-			dblSrcX += dblIncSrcX;
-			pDest += wBPP;
+			const Uint16 *pWest = pBlended + pColumnTap->dwOffset0;
+			const Uint16 *pEast = pBlended + pColumnTap->dwOffset1;
+			const UINT wEast = pColumnTap->wWeight, wWest = 256 - wEast;
+
+			//16.16 fixed point, rounded.
+			pDest[0] = static_cast<Uint8>((pWest[0] * wWest + pEast[0] * wEast + 0x8000) >> 16);
+			pDest[1] = static_cast<Uint8>((pWest[1] * wWest + pEast[1] * wEast + 0x8000) >> 16);
+			pDest[2] = static_cast<Uint8>((pWest[2] * wWest + pEast[2] * wEast + 0x8000) >> 16);
+			pDest += 3;
 		}
-		dblSrcY += dblIncSrcY;
 
-		if (SDL_GetTicks() > dwStopTime) break;
+		pDestRow += pDestSurface->pitch;
 	}
 
 	UnlockDestSurface();
-
-	return (yDest - nStartY) + 1;
 }
 
 //***************************************************************************************
@@ -520,20 +369,16 @@ bool CScalerWidget::CreateNewTrueScaleSurface(void)
 			ContainerRect.w, ContainerRect.h, 
 			24, 0, 0, 0, 0);
 	
-	//Delete the true-to-dest scale map since it has pointers into the deleted
-	//pixel data.
-	if (this->ppTrueToDestScaleMap)
-	{
-		delete [] this->ppTrueToDestScaleMap;
-		this->ppTrueToDestScaleMap = NULL;
-	}
+	//Scale taps depend on the source dimensions.
+	DeleteScaleInstructions();
 
 	return (this->pTrueScaleSurface != NULL);
 }
 
 //***************************************************************************************
 bool CScalerWidget::CalcScaleInstructions(void)
-//Calculate instructions for scaling.
+//Calculate instructions for scaling.  For each destination column and row, finds
+//the two nearest source columns or rows and how much each contributes.
 //
 //Returns:
 //True if successful, false if not.
@@ -541,60 +386,69 @@ bool CScalerWidget::CalcScaleInstructions(void)
 	ASSERT(this->w && this->h);
 	ASSERT(this->pTrueScaleSurface);
 
-	//Delete the true-to-dest scale map because the destination size may have changed.
-	if (this->ppTrueToDestScaleMap)
-	{
-		delete [] this->ppTrueToDestScaleMap;
-		this->ppTrueToDestScaleMap = NULL;
-	}
-
-	//Alloc a new true-to-dest scale map.
-	this->ppTrueToDestScaleMap = new Uint8 *[this->w * this->h];
+	//Delete the old taps because the destination size may have changed.
+	DeleteScaleInstructions();
 
 	//Calc number of source pixels to move for each dest pixel.
 	SDL_Rect ContainerRect;
 	this->pTrueScaleContainer->GetRect(ContainerRect);
 	const double dblIncSrcX = (double) ContainerRect.w / (double) this->w;
 	const double dblIncSrcY = (double) ContainerRect.h / (double) this->h;
-	
-	//Set up some shorthand vars for better speed in loop.
-	const UINT yEnd = this->y + this->h;
-	const UINT xEnd = this->x + this->w;
-	const UINT wPitch =	this->pTrueScaleSurface->pitch;
-	const UINT wBPP = this->pTrueScaleSurface->format->BytesPerPixel;
-	const int thisx = this->x;
-	Uint8 *pSrcPixels = static_cast<Uint8 *>(this->pTrueScaleSurface->pixels);
-
-	//Each iteration fills map for one destination row.
-	UINT xSrc, ySrc;
-	double dblSrcX, dblSrcY = 0;
-	Uint8 *pSrcTop, *pSrc;
-	Uint8 * *ppMapElement = this->ppTrueToDestScaleMap;
-	UINT xDest, yDest;
-	for (yDest = this->y; yDest < yEnd; ++yDest)
-	{
-		dblSrcX = 0;
-		ySrc = static_cast<UINT>(dblSrcY);
-		pSrcTop = pSrcPixels +	(ySrc * wPitch);
 
-		//Each iteration fills map for one destination pixel.
-		for (xDest = thisx; xDest < xEnd; ++xDest)
-		{
-			xSrc = static_cast<UINT>(dblSrcX);
-			pSrc = pSrcTop + (xSrc * wBPP);
-			*(ppMapElement++) = pSrc;
+	//Algorithm is incorrect if dest is less than half the size of source.
+	//It only uses a maximum of four source pixels to average into one dest pixel.
+	ASSERT(dblIncSrcX <= 2 && dblIncSrcY <= 2);
 
-			dblSrcX += dblIncSrcX;
-		}
+	this->pColumnTaps = new SCALETAP[this->w];
+	this->pRowTaps = new SCALETAP[this->h];
+	this->pBlendedRow = new Uint16[ContainerRect.w * 3];
+	if (!this->pColumnTaps || !this->pRowTaps || !this->pBlendedRow)
+	{
+		DeleteScaleInstructions();
+		return false;
+	}
 
-		dblSrcY += dblIncSrcY;
+	//Column offsets index pBlendedRow, which holds 3 channels per pixel.
+	UINT wSrc, wIndex;
+	double dblSrc = 0;
+	for (wIndex = 0; wIndex < this->w; ++wIndex)
+	{
+		wSrc = static_cast<UINT>(dblSrc);
+		SCALETAP &tap = this->pColumnTaps[wIndex];
+		tap.dwOffset0 = wSrc * 3;
+		tap.dwOffset1 = (wSrc + 1 < (UINT)ContainerRect.w ? wSrc + 1 : wSrc) * 3;
+		tap.wWeight = static_cast<UINT>((dblSrc - wSrc) * 256.0);
+		dblSrc += dblIncSrcX;
 	}
 
-	ASSERT(ppMapElement - this->ppTrueToDestScaleMap == static_cast<int>(this->w * this->h));
+	//Row offsets index the true-scale surface pixels.
+	const UINT wPitch = this->pTrueScaleSurface->pitch;
+	dblSrc = 0;
+	for (wIndex = 0; wIndex < this->h; ++wIndex)
+	{
+		wSrc = static_cast<UINT>(dblSrc);
+		SCALETAP &tap = this->pRowTaps[wIndex];
+		tap.dwOffset0 = wSrc * wPitch;
+		tap.dwOffset1 = (wSrc + 1 < (UINT)ContainerRect.h ? wSrc + 1 : wSrc) * wPitch;
+		tap.wWeight = static_cast<UINT>((dblSrc - wSrc) * 256.0);
+		dblSrc += dblIncSrcY;
+	}
 
 	return true;
 }
 
+//***************************************************************************************
+void CScalerWidget::DeleteScaleInstructions(void)
+//Frees scale taps and the blended row buffer.
+{
+	delete [] this->pColumnTaps;
+	this->pColumnTaps = NULL;
+	delete [] this->pRowTaps;
+	this->pRowTaps = NULL;
+	delete [] this->pBlendedRow;
+	this->pBlendedRow = NULL;
+}
+
 //Some of ScalerWidget.cpp's code was cut-and-pasted from RoomWidget.cpp, and contains
 //contributions outside of those contained in erikh2000's commits.  Specifically,
 //mrimer made optimizations to DrawScaledImage() which reappeared in
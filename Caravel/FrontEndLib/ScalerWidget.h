@@ -29,10 +29,10 @@
 //SUMMARY
 //
 //CScalerWidget draws one or more other widgets, scaling them to fit
-//inside of its area.  It draws in two passes.  The first pass draw, performed
-//in Paint(), is done as quickly as possible and doesn't look great.  The second 
-//pass draw, performed in one or more HandleAnimate() calls, generates an 
-//anti-aliased image.
+//inside of its area.  Paint() draws an anti-aliased (bilinear filtered) image
+//in a single pass.  The source columns, rows and blend weights for each 
+//destination pixel are computed once whenever the scaling dimensions change,
+//so each paint is only a pair of integer blends per pixel.
 //
 //USAGE
 //
@@ -56,11 +56,12 @@
 //
 //MEMORY
 //
-//CScalerWidget can use a lot of memory in its loaded state to keep instructions 
-//for quick drawing and a hidden true-scale surface as a source image.  Use this 
-//formula to estimate how much memory is used:
+//CScalerWidget keeps a hidden true-scale surface as a source image, one scale
+//tap for each destination column and row, and one row of blended source pixels.
+//Use this formula to estimate how much memory is used:
 //
-//  (DestWidth * DestHeight * 4 bytes) + (SourceWidth * SourceHeight * 3 bytes)
+//  ((DestWidth + DestHeight) * 12 bytes) + (SourceWidth * SourceHeight * 3 bytes)
+//     + (SourceWidth * 6 bytes)
 //
 //FUTURE CONSIDERATIONS
 //
@@ -74,6 +75,16 @@
 #include "FrameWidget.h"
 #include "Widget.h"
 
+//One source sample pair for a destination column or row.  Offsets are in bytes
+//from the start of the source row (columns) or surface pixels (rows).  The
+//second sample gets wWeight/256 of the blend, and the first sample the rest.
+typedef struct tagScaleTap
+{
+	UINT	dwOffset0;
+	UINT	dwOffset1;
+	UINT	wWeight;
+} SCALETAP;
+
 //******************************************************************************
 class CScalerWidget : public CWidget
 {		
@@ -93,24 +104,19 @@ public:
 	virtual void	Resize(const UINT wSetW, const UINT wSetH);
 	virtual void	Unload();
 
-protected:
-	virtual void	HandleAnimate();
-	virtual bool   IsAnimated() const {return true;}
-
 private:
 	bool				CalcScaleInstructions();
 	bool				CreateNewTrueScaleSurface();
-	UINT				DrawAntiAliasedLines(int nStartY, DWORD dwMaxY);
-	void				DrawScaledQuick();
+	void				DeleteScaleInstructions();
+	void				DrawScaled();
 
 	CFrameWidget *		pTrueScaleContainer;
 
 	bool				bNewScaleDimensions;
 	SDL_Surface *		pTrueScaleSurface;
-	Uint8 * *			ppTrueToDestScaleMap;
-
-	int					nAntiAliasY;
-	bool				bAntiAliasInProgress;
+	SCALETAP *			pColumnTaps;
+	SCALETAP *			pRowTaps;
+	Uint16 *			pBlendedRow;
 };
 
 #endif //#ifndef SCALERWIDGET_H
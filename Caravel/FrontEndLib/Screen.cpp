@@ -752,6 +752,9 @@ void CScreen::UpdateRect() const
 {
    if (IsLocked()) return; //never call SDL_UpdateRect when surface is locked
 
+   const SDL_Rect rect = {0, 0, CX_SCREEN, CY_SCREEN};
+   if (QueueUpdateRect(GetDestSurface(), rect)) return;
+
    SDL_UpdateRect(GetDestSurface(), 0, 0, 0, 0);
 }
 
@@ -769,7 +772,8 @@ void CScreen::UpdateRect(const SDL_Rect &rect) const
    //We want the asserts to catch everything during testing,
    //but we'll put an actual check in code to prevent crashing, just in case.
    if (rect.x >= 0 && rect.y >= 0 && rect.x + rect.w <= CX_SCREEN &&
-         rect.y + rect.h <= CY_SCREEN)
+         rect.y + rect.h <= CY_SCREEN &&
+         !QueueUpdateRect(GetDestSurface(), rect))
       SDL_UpdateRect(GetDestSurface(), rect.x, rect.y, rect.w, rect.h);
 }
 
@@ -907,6 +911,7 @@ void CScreen::ShowStatusMessage(
 	ShowCursor();
 	this->pStatusDialog->Show();
 	this->pStatusDialog->Paint();
+	FlushUpdateRects();	//caller is about to get busy
 }
 
 //*****************************************************************************
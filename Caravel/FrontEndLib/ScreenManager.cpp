@@ -44,9 +44,13 @@ CScreenManager::CScreenManager(
 //Constructor.
 //
 //Params:
-	SDL_Surface *pSetScreenSurface) //(in)	The screen surface.
+	SDL_Surface *pSetScreenSurface, //(in)	The screen surface.
+	const bool bSetHeadless)			//(in)	Whether the screen surface is offscreen,
+											//		with no display behind it.  Screen
+											//		transitions are skipped.  Default false.
 	: pCursor(NULL)
    , eTransition(Fade)
+   , bHeadless(bSetHeadless)
 {
 	ASSERT(pSetScreenSurface);
 		
@@ -184,7 +188,7 @@ UINT CScreenManager::ActivateScreen(const UINT eScreen)
 			
 			//Animate transition to dest screen.
             //this->eTransition = Cut; //!!
-			switch (this->eTransition)
+			switch (this->bHeadless ? Cut : this->eTransition)
 			{
 				case Cut:
 					pScreen->Paint();
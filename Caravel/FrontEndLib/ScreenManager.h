@@ -60,7 +60,7 @@ class CScreen;
 class CScreenManager
 {
 public:
-	CScreenManager(SDL_Surface *pSetScreenSurface);
+	CScreenManager(SDL_Surface *pSetScreenSurface, const bool bSetHeadless=false);
 	virtual ~CScreenManager();
 
 	virtual UINT Init() {return 0L;}
@@ -74,6 +74,7 @@ public:
 			{this->eTransition = eTransType;}
 
 	UINT		ActivateScreen(const UINT eScreen);
+	bool			IsHeadless() const {return this->bHeadless;}
 	CScreen *		GetLoadedScreen(const UINT eScreen) const;
 	CScreen *		GetScreen(const UINT eScreen);
 	UINT		GetReturnScreenType() const;
@@ -100,6 +101,9 @@ protected:
 	//Screen transition effects.
 	TRANSTYPE eTransition;
 
+	//Screen surface is offscreen and nothing is displayed.
+	const bool bHeadless;
+
 	PREVENT_DEFAULT_COPY(CScreenManager);
 };
 
@@ -35,6 +35,7 @@
 #undef INCLUDED_FROM_SOUND_CPP
 
 #include <BackEndLib/Files.h>
+#include <BackEndLib/StretchyBuffer.h>
 
 #include <SDL.h>
 
@@ -50,21 +51,37 @@ UINT CSound::SAMPLE_CHANNEL_COUNT = 0;
 UINT CSound::MODULE_CHANNEL_COUNT = 0;
 UINT CSound::CHANNEL_COUNT = SAMPLE_CHANNEL_COUNT + MODULE_CHANNEL_COUNT;
 
-#ifndef __sgi
 //******************************************************************************
-void F_CALLBACKAPI OnLyricNotePlayed(FMUSIC_MODULE* /*pModule*/, unsigned char /*InstrumentNo*/)
-//Called by FMOD whenever a note plays for the lyric instrument.
-//
-//From FMOD docs:
-//It is important to note that this callback will be called from directly WITHIN
-//the mixer / music update thread, therefore it is imperative that whatever you
-//do from this callback be extremely efficient. If the routine takes too long
-//then breakups in the sound will occur, or it will basically stop mixing until
-//you return from the function.
+static void OnLyricNotePlayed(void)
+//Called by the audio backend whenever a note plays for the lyric instrument.
+//This may be called from the backend's mixer thread, so it has to be quick.
 {
 	++m_wLyricNoteCount;
 }
-#endif
+
+//******************************************************************************
+static bool ReadSoundFile(
+//Reads a wave or song file into memory, unencoding it if necessary.  Safe to
+//call from the audio thread.
+//
+//Params:
+	const WCHAR *pwszFilepath,	//(in)	Path+name of file to read.
+	CStretchyBuffer &buffer)	//(out)	Receives the file's contents.
+//
+//Returns:
+//True if the file was read, false if not.
+{
+	WSTRING wstrFilepath = pwszFilepath;
+	CFiles::GetTrueDatafileName(&*wstrFilepath.begin());
+	if (!CFiles::ReadFileIntoBuffer(wstrFilepath.c_str(),buffer))
+		return false;
+	if (CFiles::FileIsEncrypted(wstrFilepath.c_str()))
+	{
+		//Unencode encrpyted file.
+		buffer.Decode();
+	}
+	return true;
+}
 
 //
 //CSoundEffect public methods.
@@ -74,11 +91,10 @@ void F_CALLBACKAPI OnLyricNotePlayed(FMUSIC_MODULE* /*pModule*/, unsigned char /
 CSoundEffect::CSoundEffect(void)
 //Constructor.
 {
-#ifndef __sgi
+	this->pBackend = NULL;
 	this->nChannel = -1;
 	this->bPlayRandomSample = this->bIsLoaded = false;
 	this->iLastSamplePlayed = this->Samples.end();
-#endif
 }
 
 //***********************************************************************************
@@ -88,6 +104,29 @@ CSoundEffect::~CSoundEffect(void)
 	if (this->bIsLoaded) Unload();
 }
 
+//***********************************************************************************
+bool CSoundEffect::AddSample(
+//Adds a sample for the sound effect from a wave file read into memory.
+//
+//Params:
+	CStretchyBuffer &buffer,		//(in)	Contents of the wave file.
+	const WCHAR *pwszFilepath)	//(in)	Where the wave file came from.
+//
+//Returns:
+//True if the sample loaded, false if not.
+{
+	ASSERT(this->pBackend);
+	SAMPLEHANDLE hSample = this->pBackend->LoadSample((BYTE*)buffer, buffer.Size(),
+			pwszFilepath);
+	if (!hSample) return false;
+
+	this->Samples.push_back(hSample);
+
+	//If at least one sample loaded, then I will call this sound effect "loaded".
+	this->bIsLoaded = true;
+	return true;
+}
+
 //***********************************************************************************
 bool CSoundEffect::Load(
 //Load a sound effect so that it is ready to play.
@@ -109,53 +148,33 @@ bool CSoundEffect::Load(
 //True if all samples were loaded, false if not.  If no samples load, the Play()
 //method will do nothing when called.
 {
-#ifdef __sgi
-	return true;
-#else
 	bool bCompleteSuccess = true;
 	ASSERT(!this->bIsLoaded);
-	ASSERT(static_cast<UINT>(nSetChannel) >= CSound::MODULE_CHANNEL_COUNT);
-	ASSERT(static_cast<UINT>(nSetChannel) < CSound::CHANNEL_COUNT);
-
-	this->nChannel = nSetChannel;
-	this->bPlayRandomSample = bSetPlayRandomSample;
+	SetChannel(nSetChannel, bSetPlayRandomSample);
 
-	//Load each sample from a wave file.
+	//Load each sample from a wave file.  A simulated backend doesn't need the
+	//file's contents.
 	for (list<WSTRING>::const_iterator iFilepath = FilepathArray.begin();
 		iFilepath != FilepathArray.end(); ++iFilepath)
 	{
-char buffer[MAX_PATH+1];
-UnicodeToAscii(*iFilepath, buffer);
-		FSOUND_SAMPLE *pSample = LoadWave(iFilepath->c_str());
-		if (pSample)
-		{
-			FSOUND_Sample_SetMode(pSample, FSOUND_LOOP_OFF);
-			this->Samples.push_back(pSample);
-		}
-		else
+		CStretchyBuffer buffer;
+		if ((!this->pBackend->IsSimulated() && !ReadSoundFile(iFilepath->c_str(), buffer)) ||
+				!AddSample(buffer, iFilepath->c_str()))
 			bCompleteSuccess = false;
 	}
 
-	//If at least one sample loaded, then I will call this sound effect "loaded".
-	this->bIsLoaded = (this->Samples.size() > 0);
-
 	return bCompleteSuccess;
-#endif
 }
 
 //***********************************************************************************
 void CSoundEffect::Play(void)
 //Plays a sample for the sound effect.
 {
-#ifndef __sgi
 	//Do nothing if sound effect is not loaded.
 	if (!this->bIsLoaded) return;
 
-	//Stop any other samples playing on this channel.
-	if (!FSOUND_StopSound(this->nChannel)) ASSERTP(false, "Failed to stop sound.");
-
 	//Figure out which sample to play next.
-	list<FSOUND_SAMPLE *>::iterator iPlaySample;
+	list<SAMPLEHANDLE>::iterator iPlaySample;
 	if (this->Samples.size() == 1)
 		iPlaySample = this->iLastSamplePlayed = this->Samples.begin();
 	else if (this->bPlayRandomSample)
@@ -181,56 +200,42 @@ void CSoundEffect::Play(void)
 		iPlaySample = this->iLastSamplePlayed;
 	}
 
-	//Play the sample.
-	if (!FSOUND_PlaySound(this->nChannel, *iPlaySample)) ASSERTP(false, "Failed to play sound.");
-#endif
+	//Play the sample.  Any other sample playing on this channel stops.
+	if (!this->pBackend->PlaySample(this->nChannel, *iPlaySample))
+		ASSERTP(false, "Failed to play sound.");
+}
+
+//***********************************************************************************
+void CSoundEffect::SetChannel(
+//Sets the channel samples will play on, ahead of adding the samples.
+//
+//Params:
+	const int nSetChannel,					//(in)	Channel on which samples will
+											//		play.
+	const bool bSetPlayRandomSample)		//(in)	If true, samples will play
+											//		randomly (default = false).
+{
+	ASSERT(static_cast<UINT>(nSetChannel) >= CSound::MODULE_CHANNEL_COUNT);
+	ASSERT(static_cast<UINT>(nSetChannel) < CSound::CHANNEL_COUNT);
+
+	this->nChannel = nSetChannel;
+	this->bPlayRandomSample = bSetPlayRandomSample;
 }
 
 //***********************************************************************************
 void CSoundEffect::Unload(void)
 {
-#ifndef __sgi
 	ASSERT(this->bIsLoaded);
 
 	//Free the samples.
-	for (list<FSOUND_SAMPLE *>::iterator iSeek = this->Samples.begin();
+	for (list<SAMPLEHANDLE>::iterator iSeek = this->Samples.begin();
 			iSeek != this->Samples.end(); ++iSeek)
-		FSOUND_Sample_Free(*iSeek);
+		this->pBackend->FreeSample(*iSeek);
 	this->Samples.clear();
+	this->iLastSamplePlayed = this->Samples.end();
 
 	this->bIsLoaded = false;
-#endif
-}
-
-//
-//CSoundEffect private methods.
-//
-
-#ifndef __sgi
-//**********************************************************************************
-FSOUND_SAMPLE* CSoundEffect::LoadWave(
-//Load wave file, unencoding if necessary.
-//
-//Returns:
-//Loaded wave file.
-//
-//Params:
-	const WCHAR *pwszWaveFilepath)	//(in) Path+name of wave file to load
-const
-{
-	WSTRING wstrWaveFilepath = pwszWaveFilepath;
-	CFiles::GetTrueDatafileName(&*wstrWaveFilepath.begin());
-	CStretchyBuffer buffer;
-	CFiles::ReadFileIntoBuffer(pwszWaveFilepath,buffer);
-	if (CFiles::FileIsEncrypted(pwszWaveFilepath))
-	{
-		//Unencode encrpyted wave file.
-		buffer.Decode();
-	}
-	return FSOUND_Sample_Load(FSOUND_FREE, (char*)(BYTE*)buffer, 
-			FSOUND_2D | FSOUND_LOADMEMORY, 0, buffer.Size());
 }
-#endif
 
 //
 //CSound Public methods.
@@ -245,15 +250,22 @@ CSound::CSound(
    const bool bNoSound,
    const UINT SOUND_EFFECT_COUNT,
    const UINT SAMPLE_CHANNEL_COUNT,
-   const UINT MODULE_CHANNEL_COUNT)
+   const UINT MODULE_CHANNEL_COUNT,
+   const AUDIOBACKENDTYPE eBackend,	//(in)	Sound library to use (default =
+											//		ABT_Default).
+   const char *pszAudioLogFilepath)	//(in)	Where ABT_Recording writes its log
+											//		(default = NULL, meaning stdout).
    : bNoSound(bNoSound)
    , bMusicOn(!bNoSound), bMusicAvailable(false)
    , bSoundEffectsOn(!bNoSound), bSoundEffectsAvailable(false)
    , eCurrentPlayingSongID(SOUNDLIB::SONGID_NONE)
    , nSoundVolume(128), nMusicVolume(128)
-   , pModule(NULL)
+   , pBackend(NULL), hSong(NULL)
+   , pAudioThread(NULL), pAudioLock(NULL), pAudioWake(NULL), bStopAudio(false)
+   , wSoundEffectsPending(0), wSoundEffectsFailed(0), bSoundEffectsLoading(false)
+   , bSongRequested(false), eFailedSongID(SOUNDLIB::SONGID_NONE)
+   , nLyricInstrumentNo(-1), hFadingSong(NULL), nFadingVolume(0), dwFadeStartTime(0)
 {
-#ifndef __sgi
 	if (bNoSound) return;
 
 	CSound::SOUND_EFFECT_COUNT = SOUND_EFFECT_COUNT;
@@ -268,8 +280,12 @@ CSound::CSound(
 		this->ChannelSoundEffects[nChannel] = static_cast<UINT>(SOUNDLIB::SEID_NONE);
 
 	//The call to InitSound() will set music and sound effects availability.
-	InitSound();
-#endif
+	if (InitSound(eBackend, pszAudioLogFilepath))
+	{
+		for (UINT nSEI = 0; nSEI < SOUND_EFFECT_COUNT; ++nSEI)
+			this->SoundEffectArray[nSEI].SetBackend(this->pBackend);
+		StartAudioThread();
+	}
 }
 
 //**********************************************************************************
@@ -278,8 +294,10 @@ CSound::~CSound(void)
 {
   if (!bNoSound)
   {
+	  StopAudioThread();
 	  UnloadSoundEffects();
 	  DeinitSound();
+	  delete this->pBackend;
 
 	  delete[] this->ChannelSoundEffects;
 	  delete[] this->SoundEffectArray;
@@ -317,11 +335,11 @@ void CSound::SetSoundEffectsVolume(
 	const int volume	//(in) value between 0 (silent) and 255 (full)
 )
 {
-#ifndef __sgi
 	ASSERT(volume >= 0 && volume <= 255);
+	SDL_mutexP(this->pAudioLock);
 	nSoundVolume = volume;
-	FSOUND_SetSFXMasterVolume(volume);
-#endif
+	if (this->pBackend) this->pBackend->SetSampleVolume(volume);
+	SDL_mutexV(this->pAudioLock);
 }
 
 //********************************************************************************
@@ -330,11 +348,14 @@ void CSound::SetMusicVolume(
 	const int volume	//(in) value between 0 (silent) and 255 (full)
 )
 {
-#ifndef __sgi
 	ASSERT(volume >= 0 && volume <= 255);
+	SDL_mutexP(this->pAudioLock);
 	nMusicVolume = volume;
-	if (this->pModule) FMUSIC_SetMasterVolume(this->pModule,volume);
-#endif
+
+	//During a crossfade, the audio thread steps the volume toward this.
+	if (this->hSong && !this->hFadingSong)
+		this->pBackend->SetSongVolume(this->hSong,volume);
+	SDL_mutexV(this->pAudioLock);
 }
 
 //********************************************************************************
@@ -343,20 +364,22 @@ bool CSound::IsSongFinished(void) const
 //finished playing.  This stays set even if the song loops.  Also returns true
 //if no song is playing.
 {
-#ifndef __sgi
 	//Return without doing anything if no music is playing.
-	if (!this->bMusicOn || !this->bMusicAvailable || !this->pModule) 
+	if (!this->bMusicOn || !this->bMusicAvailable) 
 		return false;
 
-	return (FMUSIC_IsFinished(this->pModule) != 0);
-#else
-	return true;
-#endif
+	//A song still being started hasn't finished.
+	SDL_mutexP(this->pAudioLock);
+	const bool bFinished = !this->bSongRequested && this->hSong &&
+			this->pBackend->IsSongFinished(this->hSong);
+	SDL_mutexV(this->pAudioLock);
+	return bFinished;
 }
 
 //********************************************************************************
 void CSound::PlaySong(
-//Plays a song.
+//Plays a song.  The song is loaded and started on the audio thread, which
+//crossfades to it from any song playing now, so this returns right away.
 //
 //Params:
 	const UINT eSongID,			//(in)	Song to play.
@@ -365,88 +388,117 @@ void CSound::PlaySong(
 									//		If -1 (default) then no lyric note 
 									//		counting will be performed.
 {
-#ifndef __sgi
 	//Return successful without doing anything if music has been disabled.
 	if (!this->bMusicOn || !this->bMusicAvailable) return;
 
+	//Report a song the audio thread couldn't start last time.  It isn't
+	//playing, so asking for it again retries.
+	SDL_mutexP(this->pAudioLock);
+	const UINT eFailedSongID = this->eFailedSongID;
+	this->eFailedSongID = SOUNDLIB::SONGID_NONE;
+	SDL_mutexV(this->pAudioLock);
+	if (eFailedSongID != SOUNDLIB::SONGID_NONE)
+	{
+		if (eFailedSongID == this->eCurrentPlayingSongID)
+			this->eCurrentPlayingSongID = SOUNDLIB::SONGID_NONE;
+		ASSERTP(false, "Failed to load song.(2)");
+	}
+
 	//Is the requested song, currently playing?
 	if (eSongID == this->eCurrentPlayingSongID) return; //Yes--nothing to do.
 
-	//Stop any currently playing song.
-	if (!StopSong()) ASSERTP(false, "Failed to stop song.");
-
 	//Get filepath for new song to play.
-	WSTRING wstrSongFilepath;
-	if (!GetSongFilepath(eSongID, wstrSongFilepath))
+	QUEUEDSONG Song;
+	Song.eSongID = eSongID;
+	Song.nLyricInstrumentNo = nLyricInstrumentNo;
+	if (!GetSongFilepath(eSongID, Song.wstrFilepath))
    {
       CFiles f;
       f.AppendErrorLog("A song failed to load. Check whether ");
       char filepath[512];
-      UnicodeToAscii(wstrSongFilepath, filepath);
+      UnicodeToAscii(Song.wstrFilepath, filepath);
       f.AppendErrorLog(filepath);
       f.AppendErrorLog(" is a valid filename.\r\n");
       ASSERTP(false, "Song failed to load.");
+      StopSong();
       return;
    }
-	CFiles::GetTrueDatafileName(&*wstrSongFilepath.begin());
 
-	//Load the song.
-	CStretchyBuffer buffer;
-	CFiles::ReadFileIntoBuffer(wstrSongFilepath.c_str(),buffer);
-	if (CFiles::FileIsEncrypted(wstrSongFilepath.c_str()))
-	{
-		//Unencode encrpyted song file.
-		buffer.Decode();
-	}
-	this->pModule = FMUSIC_LoadSongEx((const char*)(BYTE*)buffer,0,buffer.Size(),
-         FSOUND_LOADMEMORY,NULL,1);
-	if (!this->pModule) {ASSERTP(false, "Failed to load song.(2)"); return;}
-
-	//Set volume.
-	FMUSIC_SetMasterVolume(this->pModule,nMusicVolume);
+	this->eCurrentPlayingSongID = eSongID;
+	m_wLyricNoteCount = 0;
 
-	//Set callback for counting lyric notes.
-	if (nLyricInstrumentNo != -1)
+	if (!this->pAudioThread)
 	{
-		if (!FMUSIC_SetInstCallback(this->pModule, OnLyricNotePlayed,
-				nLyricInstrumentNo))
-			ASSERTP(false, "Lyric counting isn't going to work.");
+		StartSong(Song);
+		return;
 	}
 
-	//Play the song.
-	if (!FMUSIC_PlaySong(this->pModule))
+	//A newer request replaces one the thread hasn't gotten to yet.
+	SDL_mutexP(this->pAudioLock);
+	this->RequestedSong = Song;
+	this->bSongRequested = true;
+	SDL_CondSignal(this->pAudioWake);
+	SDL_mutexV(this->pAudioLock);
+}
+
+//********************************************************************************
+void CSound::PrefetchSong(
+//Starts decoding a song on the audio thread, so that a later PlaySong() call
+//for it starts without waiting on the file.
+//
+//Params:
+	const UINT eSongID)	//(in)	Song to decode.
+{
+	if (!this->bMusicOn || !this->bMusicAvailable || !this->pAudioThread) return;
+	if (eSongID == this->eCurrentPlayingSongID) return;
+
+	QUEUEDSONG Song;
+	Song.eSongID = eSongID;
+	Song.nLyricInstrumentNo = -1;
+	if (!GetSongFilepath(eSongID, Song.wstrFilepath)) return;
+
+	SDL_mutexP(this->pAudioLock);
+	bool bQueued = false;
+	for (list<QUEUEDSONG>::const_iterator iSong = this->SongPrefetchQueue.begin();
+			iSong != this->SongPrefetchQueue.end() && !bQueued; ++iSong)
+		bQueued = (iSong->eSongID == eSongID);
+	for (list<PREFETCHEDSONG>::const_iterator iPrefetched = this->PrefetchedSongs.begin();
+			iPrefetched != this->PrefetchedSongs.end() && !bQueued; ++iPrefetched)
+		bQueued = (iPrefetched->eSongID == eSongID);
+	if (!bQueued)
 	{
-		FMUSIC_FreeSong(this->pModule);
-		this->pModule = NULL;
-		ASSERTP(false, "Failed to play song.");
-		return;
+		this->SongPrefetchQueue.push_back(Song);
+		SDL_CondSignal(this->pAudioWake);
 	}
-
-	//Success.
-	this->eCurrentPlayingSongID = eSongID;
-#endif
+	SDL_mutexV(this->pAudioLock);
 }
 
 //********************************************************************************
 bool CSound::StopSong(void)
-//Stops a currently playing song.
+//Stops a currently playing song.  The song fades out on the audio thread.
 //
 //Returns:
 //True if no song is playing when function returns, false if not.
 {
 	bool bSuccess=true;
-#ifndef __sgi
+	QUEUEDSONG Song;
+	Song.eSongID = SOUNDLIB::SONGID_NONE;
+	Song.nLyricInstrumentNo = -1;
+
+	this->eCurrentPlayingSongID = SOUNDLIB::SONGID_NONE;
+	m_wLyricNoteCount = 0;
 
-	if (this->pModule)
+	if (!this->pAudioThread)
 	{
-		bSuccess = (FMUSIC_StopSong(this->pModule) != 0);
-		FMUSIC_FreeSong(this->pModule);
-		this->pModule = NULL;
+		StartSong(Song);
+		return bSuccess;
 	}
 
-	this->eCurrentPlayingSongID = SOUNDLIB::SONGID_NONE;
-	m_wLyricNoteCount = 0;
-#endif
+	SDL_mutexP(this->pAudioLock);
+	this->RequestedSong = Song;
+	this->bSongRequested = true;
+	SDL_CondSignal(this->pAudioWake);
+	SDL_mutexV(this->pAudioLock);
 	return bSuccess;
 }
 
@@ -457,17 +509,23 @@ void CSound::PlaySoundEffect(
 //Params:
 	const UINT eSEID)	//(in) A SEID_* constant indicating sound effect to play.
 {
+	//Report on sound effects that have finished loading.
+	if (this->bSoundEffectsLoading) CheckSoundEffectsLoaded();
+
 	//Return successful without doing anything if sound effects have been disabled.
 	if (!this->bSoundEffectsOn || !this->bSoundEffectsAvailable) return;
 
     ASSERT(eSEID < CSound::SOUND_EFFECT_COUNT);
 	
-	//Play it.
+	//Play it.  A sound effect still loading on the audio thread is skipped.
+	SDL_mutexP(this->pAudioLock);
 	this->SoundEffectArray[eSEID].Play();
 
 	//Keep track of what sound effect is playing on what channel.
-	this->ChannelSoundEffects[this->SoundEffectArray[eSEID].GetChannel()] =
-		eSEID;
+	if (this->SoundEffectArray[eSEID].IsLoaded())
+		this->ChannelSoundEffects[this->SoundEffectArray[eSEID].GetChannel()] =
+			eSEID;
+	SDL_mutexV(this->pAudioLock);
 }
 
 //***********************************************************************************
@@ -481,7 +539,6 @@ bool CSound::IsSoundEffectPlaying(
 //True if it is, false if not.
 const
 {
-#ifndef __sgi
   //Return successful without doing anything if sound effects have been disabled.
 	if (!this->bSoundEffectsOn || !this->bSoundEffectsAvailable) return false;
 
@@ -492,14 +549,14 @@ const
 
 	//Other sound effects may play on the same channel.  Check that my sound effect
 	//is the last one that was played.
-	if (this->ChannelSoundEffects[nChannel] != eSEID) return false;
+	if (nChannel < 0 || this->ChannelSoundEffects[nChannel] != eSEID) return false;
 
 	//Check that a sample is currently playing on the channel.  If it is, then I
 	//know that it is playing a sample for my sound effect.
-	return (FSOUND_IsPlaying(nChannel)!=false);
-#else
-	return true;
-#endif
+	SDL_mutexP(this->pAudioLock);
+	const bool bPlaying = this->pBackend->IsChannelPlaying(nChannel);
+	SDL_mutexV(this->pAudioLock);
+	return bPlaying;
 }
 
 //***********************************************************************************
@@ -514,246 +571,145 @@ bool CSound::WaitForSoundEffectsToStop(
 //True if all sound effects stopped, false if max wait time elapsed.
 const
 {
-#ifndef __sgi
 	//Return successful without doing anything if sound effects have been disabled.
 	if (!this->bSoundEffectsOn || !this->bSoundEffectsAvailable) return true;
 
-	DWORD dwStartTime = SDL_GetTicks();
-	do
+	//Rather than polling, sleep until the sample with the most left to play is
+	//due to end, then check again in case another one started meanwhile.
+	const DWORD dwStartTime = SDL_GetTicks();
+	while (true)
 	{
-		//Check for samples playing on channels reserved for samples.  Channels
-		//after the module channels are sample channels.
-      UINT nChannelNo;
-		for (nChannelNo = MODULE_CHANNEL_COUNT; nChannelNo < CHANNEL_COUNT;
+		//Channels after the module channels are sample channels.
+		DWORD dwLongestRemaining = 0;
+		SDL_mutexP(this->pAudioLock);
+		for (UINT nChannelNo = MODULE_CHANNEL_COUNT; nChannelNo < CHANNEL_COUNT;
 				++nChannelNo)
 		{
-			if (FSOUND_IsPlaying(nChannelNo)) break; //At least one channel is playing.
+			const DWORD dwRemaining = this->pBackend->GetChannelMSecsLeft(nChannelNo);
+			if (dwRemaining > dwLongestRemaining)
+				dwLongestRemaining = dwRemaining;
 		}
-		if (nChannelNo == CHANNEL_COUNT) return true; //Everything has stopped.
+		SDL_mutexV(this->pAudioLock);
+		if (!dwLongestRemaining) return true; //Everything has stopped.
 
-		//Let other threads run.
-		SDL_Delay(100);
+		const DWORD dwElapsed = SDL_GetTicks() - dwStartTime;
+		if (dwElapsed >= dwMaxWaitTime) break;
+		SDL_Delay(dwLongestRemaining < dwMaxWaitTime - dwElapsed ?
+				dwLongestRemaining : dwMaxWaitTime - dwElapsed);
 	}
-	while (SDL_GetTicks() - dwStartTime < dwMaxWaitTime);
 	
 	//Timed out waiting.
 	return false;
-#else
-	return true;
-#endif
 }
 
 //
 //CSound Private methods.
 //
 
-//***********************************************************************************
-int CSound::GetLastFSOUNDError(
-//Gets last FSOUND error code along with test description.
-//
-//Params:
-	string &strErrDesc)	//(in/out)	Corresponds to error code.  Appends to end of 
-						//			string which may or may not be empty.
-//
-//Returns:
-//Error code or FMOD_ERR_NONE if no FSOUND error.
-const
-{
-#ifndef __sgi
-	int nErrCode = FSOUND_GetError();
-	char szTemp[30];
-	sprintf(szTemp, "    FMOD Error #%d: ", nErrCode);
-	strErrDesc += szTemp;
-
-	//These are taken out of the FMOD 3.5 docs.  Update with new versions as
-	//needed.
-	switch (nErrCode)
-	{
-		case FMOD_ERR_NONE: 
-			strErrDesc +=	"No errors.\r\n"; 
-		break;
-		
-		case FMOD_ERR_BUSY: 
-			strErrDesc +=	"Cannot call this command after FSOUND_Init. Call "
-							"FSOUND_Close first.\r\n"; 
-		break;
-		
-		case FMOD_ERR_UNINITIALIZED: 
-			strErrDesc +=	"This command failed because FSOUND_Init or "
-							"FSOUND_SetOutput was not called.\r\n"; 
-		break;
- 
-		case FMOD_ERR_INIT:
-			strErrDesc +=	"Error initializing output device.\r\n";
-		break;
- 
-		case FMOD_ERR_ALLOCATED:
-			strErrDesc +=	"Error initializing output device, but more "
-							"specifically, the output device is already in use and "
-							"cannot be reused.\r\n";
- 		break;
-
-		case FMOD_ERR_PLAY:
-			strErrDesc +=	"Playing the sound failed.\r\n";
- 		break;
- 
-		case FMOD_ERR_OUTPUT_FORMAT:
-			strErrDesc +=	"Soundcard does not support the features needed for "
-							"this soundsystem (16bit stereo output).\r\n";
- 		break;
- 
-		case FMOD_ERR_COOPERATIVELEVEL:
-			strErrDesc +=	"Error setting cooperative level for hardware.\r\n";
- 		break;
- 
-		case FMOD_ERR_CREATEBUFFER:
-			strErrDesc +=	"Error creating hardware sound buffer.\r\n";
- 		break;
- 
-		case FMOD_ERR_FILE_NOTFOUND:
-			strErrDesc +=	"File not found.\r\n";
- 		break;
- 
-		case FMOD_ERR_FILE_FORMAT:
-			strErrDesc +=	"Unknown file format.\r\n";
- 		break;
- 
-		case FMOD_ERR_FILE_BAD:
-			strErrDesc +=	"Error loading file.\r\n";
- 		break;
- 
-		case FMOD_ERR_MEMORY:
-			strErrDesc +=	"Not enough memory or resources.\r\n";
- 		break;
- 
-		case FMOD_ERR_VERSION:
-			strErrDesc +=	"The version number of this file format is not "
-							"supported.\r\n";
- 		break;
- 
-		case FMOD_ERR_INVALID_PARAM:
-			strErrDesc +=	"An invalid parameter was passed to this "
-							"function.\r\n";
- 		break;
- 
-		case FMOD_ERR_NO_EAX:
-			strErrDesc +=	"Tried to use an EAX command on a non EAX enabled "
-							"channel or output.\r\n";
- 		break;
- 
-		case FMOD_ERR_CHANNEL_ALLOC:
-			strErrDesc +=	"Failed to allocate a new channel.\r\n";
- 		break;
- 
-		case FMOD_ERR_RECORD:
-			strErrDesc +=	"Recording is not supported on this machine.\r\n";
- 		break;
- 
-		case FMOD_ERR_MEDIAPLAYER:
-			strErrDesc +=	"Windows Media Player not installed so cannot play wma "
-							"or use internet streaming.\r\n";
-		break;
-
-		default:
-			strErrDesc +=	"Description unavailable.\r\n";
-	}
-
-	return nErrCode;
-#else
-	return 0;
-#endif
-}
-
 //**********************************************************************************
-bool CSound::InitSound(void)
+bool CSound::InitSound(
 //Initializes sound module.
 //
+//Params:
+	const AUDIOBACKENDTYPE eBackend,	//(in)	Backend to play sound through.
+	const char *pszAudioLogFilepath)	//(in)	Where a recording backend writes
+										//		its log.
+//
 //Returns:
 //true if at least sound effects will be available, false otherwise.
 {
-#ifndef __sgi
-	this->bSoundEffectsAvailable = this->bMusicAvailable = true;
+	this->bSoundEffectsAvailable = this->bMusicAvailable = false;
 
 	//This log string will appear if an error occurs.
 	string strInitLog = "This is what happened while initializing sound:\r\n";
 
-	while (true) //non-looping.
+	ASSERT(!this->pBackend);
+	this->pBackend = CreateAudioBackend(eBackend, pszAudioLogFilepath);
+	if (!this->pBackend)
+		strInitLog += "  The requested audio backend isn't available in this build.\r\n";
+	else if (this->pBackend->Init(MODULE_CHANNEL_COUNT, SAMPLE_CHANNEL_COUNT,
+			strInitLog))
 	{
-		//Compare loaded FMOD.DLL version to import library linked into .EXE.
-		if (FSOUND_GetVersion() != FMOD_VERSION) 
-		{
-			char szVersion[100];
-			sprintf(szVersion, "  FMOD.DLL version is %g and import library is %g!\r\n",
-					FSOUND_GetVersion(), FMOD_VERSION);
-			strInitLog += szVersion;
-			break;
-		}
-		else
-			strInitLog += "  FMOD.DLL version matches import library.\r\n";
-		
-		//Init FSOUND--try best case params first.
-		if (FSOUND_Init(44100, CHANNEL_COUNT, 0)) 
-			strInitLog += "  FSOUND was initialized with best case params.\r\n";
-		else
+		//Ready to play sound effects and probably music.
+		this->bSoundEffectsAvailable = true;
+		this->bMusicAvailable = this->pBackend->IsMusicAvailable();
+		if (!this->bMusicAvailable)
 		{
-			strInitLog += "  FSOUND_Init(44100, CHANNEL_COUNT, 0) failed.\r\n";
-
-			//Maybe the mixing rate is too high?  Try 22mhz and 11mhz.
-			if (FSOUND_Init(22050, CHANNEL_COUNT, 0)) return true;
-			strInitLog += "  FSOUND_Init(22050, CHANNEL_COUNT, 0) failed.\r\n";
-			if (FSOUND_Init(11025, CHANNEL_COUNT, 0)) return true;
-			strInitLog += "  FSOUND_Init(11025, CHANNEL_COUNT, 0) failed.\r\n";
-
-			//Maybe I'm asking for too many channels?  Try just enough for 
-			//sound effects, but not music.
-			if (FSOUND_Init(44100, SAMPLE_CHANNEL_COUNT, 0))
-			{
-				//Not enough channels for music.
-				CFiles Files;
-				Files.AppendErrorLog("Not enough available channels for music.\r\n");
-				this->bMusicAvailable = false; 
-				return true;
-			}
-			strInitLog += "  FSOUND_Init(44100, SAMPLE_CHANNEL_COUNT, 0) failed.\r\n";
-
-			//I give up.
-			break;
+			CFiles Files;
+			Files.AppendErrorLog("Not enough available channels for music.\r\n");
 		}
-						
-		//Ready to play sound effects and probably music.
 		return true;
 	}
 
 	//Sadly, there will be no sound.
-	this->bMusicAvailable = this->bSoundEffectsAvailable = false;
-
-	//Log the last FSOUND error which probably caused the failure.
 	{
-		GetLastFSOUNDError(strInitLog);
 		CFiles Files;
 		Files.AppendErrorLog(strInitLog.c_str());
 	}
 		
 	//Cleanup.
 	DeinitSound();
+	delete this->pBackend;
+	this->pBackend = NULL;
 	return false;
-#else
-	return false;
-#endif
 }
 
 //***********************************************************************************
 void CSound::DeinitSound(void)
 //Deinits sound module.
 {
-#ifndef __sgi
-	if (this->pModule)
+	if (!this->pBackend) return;
+
+	if (this->hSong)
 	{
-		FMUSIC_FreeSong(this->pModule);
-		this->pModule = NULL;
+		this->pBackend->FreeSong(this->hSong);
+		this->hSong = NULL;
 	}
-	FSOUND_Close();
-#endif
+	if (this->hFadingSong)
+	{
+		this->pBackend->FreeSong(this->hFadingSong);
+		this->hFadingSong = NULL;
+	}
+	FreePrefetchedSongs();
+	this->pBackend->Deinit();
+}
+
+//**********************************************************************************
+void CSound::QueueSoundEffect(
+//Queues a sound effect for the audio thread to load.  Until it loads, playing
+//the sound effect does nothing.
+//
+//Params:
+	const UINT eSEID,						//(in)	Sound effect to load.
+	const list<WSTRING> &FilepathArray,		//(in)	Full paths to its wave files.
+	const int nChannel,						//(in)	Channel its samples play on.
+	const bool bPlayRandomSample)			//(in)	If true, samples will play
+											//		randomly (default = false).
+{
+	ASSERT(eSEID < CSound::SOUND_EFFECT_COUNT);
+
+	QUEUEDSOUNDEFFECT SoundEffect;
+	SoundEffect.eSEID = eSEID;
+	SoundEffect.FilepathArray = FilepathArray;
+	SoundEffect.nChannel = nChannel;
+	SoundEffect.bPlayRandomSample = bPlayRandomSample;
+
+	SDL_mutexP(this->pAudioLock);
+	this->SoundEffectArray[eSEID].SetChannel(nChannel, bPlayRandomSample);
+	++this->wSoundEffectsPending;
+	this->bSoundEffectsLoading = true;
+	SDL_mutexV(this->pAudioLock);
+
+	if (!this->pAudioThread)
+	{
+		LoadQueuedSoundEffect(SoundEffect);
+		return;
+	}
+
+	SDL_mutexP(this->pAudioLock);
+	this->SoundEffectQueue.push_back(SoundEffect);
+	SDL_CondSignal(this->pAudioWake);
+	SDL_mutexV(this->pAudioLock);
 }
 
 //**********************************************************************************
@@ -767,6 +723,371 @@ void CSound::UnloadSoundEffects(void)
 	}
 }
 
+//**********************************************************************************
+int CSound::AudioThread(
+//Loads sound effects, decodes songs and steps crossfades in the background
+//until StopAudioThread() is called.  A requested song goes ahead of any other
+//queued work.
+//
+//Params:
+	void *pSound)	//(in)	The CSound that started the thread.
+{
+	CSound *pThis = static_cast<CSound *>(pSound);
+
+	SDL_mutexP(pThis->pAudioLock);
+	while (!pThis->bStopAudio)
+	{
+		if (pThis->hFadingSong) pThis->StepCrossfade();
+		const bool bSongEnding = pThis->pBackend->ContinueSongs();
+
+		if (pThis->bSongRequested)
+		{
+			const QUEUEDSONG Song = pThis->RequestedSong;
+			pThis->bSongRequested = false;
+			SDL_mutexV(pThis->pAudioLock);
+			pThis->StartSong(Song);
+			SDL_mutexP(pThis->pAudioLock);
+			continue;
+		}
+
+		if (!pThis->SoundEffectQueue.empty())
+		{
+			const QUEUEDSOUNDEFFECT SoundEffect = pThis->SoundEffectQueue.front();
+			pThis->SoundEffectQueue.pop_front();
+			SDL_mutexV(pThis->pAudioLock);
+			pThis->LoadQueuedSoundEffect(SoundEffect);
+			SDL_mutexP(pThis->pAudioLock);
+			continue;
+		}
+
+		if (!pThis->SongPrefetchQueue.empty())
+		{
+			const QUEUEDSONG Song = pThis->SongPrefetchQueue.front();
+			pThis->SongPrefetchQueue.pop_front();
+			SDL_mutexV(pThis->pAudioLock);
+			pThis->PrefetchQueuedSong(Song);
+			SDL_mutexP(pThis->pAudioLock);
+			continue;
+		}
+
+		//Wake up to step a crossfade in progress, or to restart a song the
+		//backend can't loop by itself.
+		if (pThis->hFadingSong || bSongEnding)
+		{
+			SDL_CondWaitTimeout(pThis->pAudioWake, pThis->pAudioLock,
+					CROSSFADE_STEP_MSECS);
+			continue;
+		}
+
+		SDL_CondWait(pThis->pAudioWake, pThis->pAudioLock);
+	}
+	SDL_mutexV(pThis->pAudioLock);
+
+	return 0;
+}
+
+//**********************************************************************************
+void CSound::CheckSoundEffectsLoaded(void)
+//Once the audio thread has loaded every queued sound effect, reports the ones
+//that failed.  Logging is left to the main thread, since CFiles isn't safe to
+//use from the audio thread.
+{
+	SDL_mutexP(this->pAudioLock);
+	const bool bDone = !this->wSoundEffectsPending;
+	const UINT wFailed = this->wSoundEffectsFailed;
+	SDL_mutexV(this->pAudioLock);
+	if (!bDone) return;
+
+	this->bSoundEffectsLoading = false;
+	if (wFailed)
+	{
+		//If this fires, check 1. a load macro is present for each
+		//SEID_* value. 2. filenames specified in DROD.INI are correct.
+		CFiles f;
+		f.AppendErrorLog("A sound effect failed to load.  Check whether "
+			"the filenames specified in DROD.INI are correct.\r\n");
+		ASSERTP(false, "Sound effect failed to load.");
+	}
+
+	//Check sound effects to see what got loaded.
+	bool bOneSoundEffectLoaded = false;
+	for (UINT nSEI = 0; nSEI < CSound::SOUND_EFFECT_COUNT && !bOneSoundEffectLoaded; ++nSEI)
+		bOneSoundEffectLoaded = this->SoundEffectArray[nSEI].IsLoaded();
+	if (!bOneSoundEffectLoaded)
+		this->bSoundEffectsAvailable = false;
+}
+
+//**********************************************************************************
+void CSound::LoadQueuedSoundEffect(
+//Loads the samples of a queued sound effect.  The wave files are read without
+//holding pAudioLock, so the main thread can keep playing other sound effects.
+//
+//Params:
+	const QUEUEDSOUNDEFFECT &SoundEffect)	//(in)	Sound effect to load.
+{
+	bool bOneSampleLoaded = false;
+	for (list<WSTRING>::const_iterator iFilepath = SoundEffect.FilepathArray.begin();
+		iFilepath != SoundEffect.FilepathArray.end(); ++iFilepath)
+	{
+		//A simulated backend plays nothing, so there's no need to read the file.
+		CStretchyBuffer buffer;
+		if (!this->pBackend->IsSimulated() &&
+				!ReadSoundFile(iFilepath->c_str(), buffer))
+			continue;
+
+		SDL_mutexP(this->pAudioLock);
+		if (this->SoundEffectArray[SoundEffect.eSEID].AddSample(buffer,
+				iFilepath->c_str()))
+			bOneSampleLoaded = true;
+		SDL_mutexV(this->pAudioLock);
+	}
+
+	SDL_mutexP(this->pAudioLock);
+	if (!bOneSampleLoaded) ++this->wSoundEffectsFailed;
+	--this->wSoundEffectsPending;
+	SDL_mutexV(this->pAudioLock);
+}
+
+//**********************************************************************************
+void CSound::PrefetchQueuedSong(
+//Decodes a queued song and keeps it to be played later.  The oldest songs
+//decoded this way are freed past MAX_PREFETCHED_SONGS.
+//
+//Params:
+	const QUEUEDSONG &Song)	//(in)	Song to decode.
+{
+	SONGHANDLE hNewSong = LoadSong(Song.wstrFilepath.c_str());
+	if (!hNewSong) return;
+
+	PREFETCHEDSONG Prefetched;
+	Prefetched.eSongID = Song.eSongID;
+	Prefetched.hSong = hNewSong;
+
+	SDL_mutexP(this->pAudioLock);
+	this->PrefetchedSongs.push_back(Prefetched);
+	while (this->PrefetchedSongs.size() > MAX_PREFETCHED_SONGS)
+	{
+		this->pBackend->FreeSong(this->PrefetchedSongs.front().hSong);
+		this->PrefetchedSongs.pop_front();
+	}
+	SDL_mutexV(this->pAudioLock);
+}
+
+//**********************************************************************************
+void CSound::StartAudioThread(void)
+//Starts the audio thread.  If it can't be started, work is done on the calling
+//thread as it is asked for.
+{
+	ASSERT(!this->pAudioThread);
+
+	this->pAudioLock = SDL_CreateMutex();
+	this->pAudioWake = SDL_CreateCond();
+
+	//A simulated backend plays nothing in real time, so doing its work on the
+	//calling thread keeps what it records in order.
+	if (this->pBackend->IsSimulated()) return;
+
+	if (this->pAudioLock && this->pAudioWake)
+		this->pAudioThread = SDL_CreateThread(AudioThread, this);
+}
+
+//**********************************************************************************
+void CSound::StartSong(
+//Starts a requested song, decoding it first unless it was prefetched.  A song
+//already playing fades out under it.
+//
+//Params:
+	const QUEUEDSONG &Song)	//(in)	Song to start, or SONGID_NONE to fade out
+							//		the song playing now.
+{
+	SONGHANDLE hNewSong = NULL;
+	if (Song.eSongID != SOUNDLIB::SONGID_NONE)
+	{
+		SDL_mutexP(this->pAudioLock);
+		hNewSong = TakePrefetchedSong(Song.eSongID);
+		SDL_mutexV(this->pAudioLock);
+		if (!hNewSong)
+			hNewSong = LoadSong(Song.wstrFilepath.c_str());
+	}
+
+	SDL_mutexP(this->pAudioLock);
+
+	//Fade out the song playing now.  One still fading out from before is cut.
+	if (this->hFadingSong)
+	{
+		this->pBackend->StopSong(this->hFadingSong);
+		this->pBackend->FreeSong(this->hFadingSong);
+	}
+	this->hFadingSong = this->hSong;
+	this->hSong = NULL;
+	if (this->hFadingSong)
+	{
+		//Notes of the song fading out aren't counted as the next song's lyrics.
+		if (this->nLyricInstrumentNo != -1)
+			this->pBackend->SetLyricCallback(this->hFadingSong,
+					this->nLyricInstrumentNo, NULL);
+		this->nFadingVolume = this->pBackend->GetSongVolume(this->hFadingSong);
+
+		//Without channels for both songs, the old one has to stop right away.
+		if (hNewSong && !this->pBackend->IsCrossfadeAvailable())
+		{
+			this->pBackend->StopSong(this->hFadingSong);
+			this->pBackend->FreeSong(this->hFadingSong);
+			this->hFadingSong = NULL;
+		}
+	}
+	this->dwFadeStartTime = SDL_GetTicks();
+	this->nLyricInstrumentNo = -1;
+	m_wLyricNoteCount = 0;
+
+	if (hNewSong)
+	{
+		//Set callback for counting lyric notes.
+		if (Song.nLyricInstrumentNo != -1)
+			this->pBackend->SetLyricCallback(hNewSong, Song.nLyricInstrumentNo,
+					OnLyricNotePlayed);
+
+		//Fade in from silence if another song is fading out.
+		this->pBackend->SetSongVolume(hNewSong, this->hFadingSong ? 0 : this->nMusicVolume);
+
+		//Play the song.
+		if (this->pBackend->PlaySong(hNewSong))
+		{
+			this->hSong = hNewSong;
+			this->nLyricInstrumentNo = Song.nLyricInstrumentNo;
+		}
+		else
+		{
+			this->pBackend->FreeSong(hNewSong);
+			this->eFailedSongID = Song.eSongID;
+		}
+	}
+	else if (Song.eSongID != SOUNDLIB::SONGID_NONE)
+		this->eFailedSongID = Song.eSongID;
+
+	//Without the thread, there's nothing to step a fade, so just cut it.
+	if (this->hFadingSong && !this->pAudioThread)
+	{
+		this->pBackend->StopSong(this->hFadingSong);
+		this->pBackend->FreeSong(this->hFadingSong);
+		this->hFadingSong = NULL;
+		if (this->hSong) this->pBackend->SetSongVolume(this->hSong, this->nMusicVolume);
+	}
+
+	SDL_mutexV(this->pAudioLock);
+}
+
+//**********************************************************************************
+void CSound::StopAudioThread(void)
+//Stops the audio thread after it finishes what it is working on.  Any work
+//still queued is dropped.
+{
+	if (this->pAudioThread)
+	{
+		SDL_mutexP(this->pAudioLock);
+		this->bStopAudio = true;
+		SDL_CondSignal(this->pAudioWake);
+		SDL_mutexV(this->pAudioLock);
+
+		SDL_WaitThread(this->pAudioThread, NULL);
+		this->pAudioThread = NULL;
+	}
+
+	this->SoundEffectQueue.clear();
+	this->SongPrefetchQueue.clear();
+	this->bSongRequested = false;
+
+	if (this->pAudioWake)
+	{
+		SDL_DestroyCond(this->pAudioWake);
+		this->pAudioWake = NULL;
+	}
+	if (this->pAudioLock)
+	{
+		SDL_DestroyMutex(this->pAudioLock);
+		this->pAudioLock = NULL;
+	}
+}
+
+//**********************************************************************************
+void CSound::FreePrefetchedSongs(void)
+//Frees songs decoded ahead of being played.
+{
+	for (list<PREFETCHEDSONG>::iterator iSong = this->PrefetchedSongs.begin();
+			iSong != this->PrefetchedSongs.end(); ++iSong)
+		this->pBackend->FreeSong(iSong->hSong);
+	this->PrefetchedSongs.clear();
+}
+
+//**********************************************************************************
+SONGHANDLE CSound::LoadSong(
+//Reads and decodes a song.  The file is read without holding pAudioLock.
+//
+//Params:
+	const WCHAR *pwszFilepath)	//(in)	Path+name of song file.
+//
+//Returns:
+//The loaded song, or NULL if it couldn't be loaded.
+{
+	CStretchyBuffer buffer;
+	if (!this->pBackend->IsSimulated() && !ReadSoundFile(pwszFilepath, buffer))
+		return NULL;
+
+	SDL_mutexP(this->pAudioLock);
+	SONGHANDLE hNewSong = this->pBackend->LoadSong((BYTE*)buffer, buffer.Size(),
+			pwszFilepath);
+	SDL_mutexV(this->pAudioLock);
+	return hNewSong;
+}
+
+//**********************************************************************************
+void CSound::StepCrossfade(void)
+//Steps the volumes of the song fading out and the song fading in.  Frees the
+//song fading out once the crossfade is over.  Caller must hold pAudioLock.
+{
+	ASSERT(this->hFadingSong);
+
+	const DWORD dwElapsed = SDL_GetTicks() - this->dwFadeStartTime;
+	if (dwElapsed >= CROSSFADE_MSECS)
+	{
+		this->pBackend->StopSong(this->hFadingSong);
+		this->pBackend->FreeSong(this->hFadingSong);
+		this->hFadingSong = NULL;
+		if (this->hSong) this->pBackend->SetSongVolume(this->hSong, this->nMusicVolume);
+		return;
+	}
+
+	this->pBackend->SetSongVolume(this->hFadingSong,
+			this->nFadingVolume * (CROSSFADE_MSECS - dwElapsed) / CROSSFADE_MSECS);
+	if (this->hSong)
+		this->pBackend->SetSongVolume(this->hSong,
+				this->nMusicVolume * dwElapsed / CROSSFADE_MSECS);
+}
+
+//**********************************************************************************
+SONGHANDLE CSound::TakePrefetchedSong(
+//Takes a song out of the prefetched songs.  Caller must hold pAudioLock.
+//
+//Params:
+	const UINT eSongID)	//(in)	Song to look for.
+//
+//Returns:
+//The decoded song, or NULL if it wasn't prefetched.
+{
+	for (list<PREFETCHEDSONG>::iterator iSong = this->PrefetchedSongs.begin();
+			iSong != this->PrefetchedSongs.end(); ++iSong)
+	{
+		if (iSong->eSongID == eSongID)
+		{
+			SONGHANDLE hFoundSong = iSong->hSong;
+			this->PrefetchedSongs.erase(iSong);
+			return hFoundSong;
+		}
+	}
+	return NULL;
+}
+
+
 // $Log: Sound.cpp,v $
 // Revision 1.9  2004/05/20 17:38:42  mrimer
 // Updated FMOD API to 3.72.
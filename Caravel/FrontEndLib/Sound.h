@@ -37,9 +37,9 @@
 #include <BackEndLib/Types.h>
 #include <BackEndLib/Wchar.h>
 
-#ifndef __sgi
-#include <fmod.h>
-#endif
+#include "AudioBackend.h"
+
+#include <SDL_thread.h>
 
 #include <list>
 #include <string>
@@ -62,6 +62,39 @@ namespace SOUNDLIB
 	};
 };
 
+//Length of a crossfade between two songs, and how often the volumes step.
+#define CROSSFADE_MSECS			(1500)
+#define CROSSFADE_STEP_MSECS	(20)
+
+//Most songs kept decoded ahead of being played.
+#define MAX_PREFETCHED_SONGS	(2)
+
+class CStretchyBuffer;
+
+//A sound effect waiting for the audio thread to load its samples.
+typedef struct tagQueuedSoundEffect
+{
+	UINT			eSEID;
+	list<WSTRING>	FilepathArray;
+	int				nChannel;
+	bool			bPlayRandomSample;
+} QUEUEDSOUNDEFFECT;
+
+//A song waiting for the audio thread to decode or start it.
+typedef struct tagQueuedSong
+{
+	UINT			eSongID;
+	WSTRING			wstrFilepath;
+	int				nLyricInstrumentNo;
+} QUEUEDSONG;
+
+//A song decoded ahead of being played.
+typedef struct tagPrefetchedSong
+{
+	UINT			eSongID;
+	SONGHANDLE		hSong;
+} PREFETCHEDSONG;
+
 //Class for loading and playing samples for a sound effect.
 class CSoundEffect
 {
@@ -69,27 +102,26 @@ public:
 	CSoundEffect(void);
 	~CSoundEffect(void);
 	
+	bool					AddSample(CStretchyBuffer &buffer, const WCHAR *pwszFilepath);
 	int						GetChannel(void) const {return this->nChannel;}
 	bool					IsLoaded(void) const {return this->bIsLoaded;}
 	bool					Load(list<WSTRING> FilepathArray, const int nSetChannel, 
 			const bool bSetPlayRandomSample=false);
 	void					Play(void);
+	void					SetBackend(CAudioBackend *pSetBackend) {this->pBackend = pSetBackend;}
+	void					SetChannel(const int nSetChannel,
+			const bool bSetPlayRandomSample=false);
 	void					Unload(void);
 
 private:
-#ifndef __sgi
-	FSOUND_SAMPLE*			LoadWave(const WCHAR *pwszWaveFilepath) const;
-
-	list<FSOUND_SAMPLE *>	Samples;
-#endif
+	CAudioBackend *			pBackend;
+	list<SAMPLEHANDLE>		Samples;
 
 	int						nChannel;
 	bool					bPlayRandomSample;
 	bool					bIsLoaded;
 	
-#ifndef __sgi
-	list<FSOUND_SAMPLE *>::iterator iLastSamplePlayed;
-#endif
+	list<SAMPLEHANDLE>::iterator iLastSamplePlayed;
 
 	PREVENT_DEFAULT_COPY(CSoundEffect);
 };
@@ -99,7 +131,8 @@ class CSound
 {
 public:
 	CSound(const bool bNoSound, const UINT SOUND_EFFECT_COUNT,
-			const UINT SAMPLE_CHANNEL_COUNT, const UINT MODULE_CHANNEL_COUNT);
+			const UINT SAMPLE_CHANNEL_COUNT, const UINT MODULE_CHANNEL_COUNT,
+			const AUDIOBACKENDTYPE eBackend=ABT_Default, const char *pszAudioLogFilepath=NULL);
 	virtual ~CSound(void);
 
 	int				GetCurrentPlayingSong(void) {return this->eCurrentPlayingSongID;}
@@ -113,7 +146,9 @@ public:
 	bool			IsMusicOn(void) const {return this->bMusicOn;}
 	bool			IsSongFinished(void) const;
 	bool			IsSoundEffectPlaying(const UINT eSEID) const;
+	bool			IsSoundEffectsAvailable(void) const {return this->bSoundEffectsAvailable;}
 	bool			IsSoundEffectsOn(void) const {return this->bSoundEffectsOn;}
+	void			PrefetchSong(const UINT nSongID);
 	void			SetSoundEffectsVolume(const int volume);
 	void			SetMusicVolume(const int volume);
 	bool			StopSong(void);
@@ -123,11 +158,12 @@ public:
 
 protected:
 	void			DeinitSound(void);
-	int				GetLastFSOUNDError(string &strErrorDesc) const;
 	virtual bool			GetSongFilepath(const UINT nSongID, WSTRING &wstrFilepath)=0;
 	virtual bool			GetWaveFilepaths(const UINT eSEID, list<WSTRING> &FilepathList) const=0;
 	virtual bool			LoadSoundEffects()=0;
-	bool			InitSound(void);
+	bool			InitSound(const AUDIOBACKENDTYPE eBackend, const char *pszAudioLogFilepath);
+	void			QueueSoundEffect(const UINT eSEID, const list<WSTRING> &FilepathArray,
+			const int nChannel, const bool bPlayRandomSample=false);
 	void			UnloadSoundEffects(void);
 
 	bool      bNoSound;
@@ -138,13 +174,47 @@ protected:
 	UINT			eCurrentPlayingSongID;
 	int				nSoundVolume, nMusicVolume;
 
-#ifndef __sgi
-	FMUSIC_MODULE *	pModule;
-#endif
+	CAudioBackend *	pBackend;
+	SONGHANDLE		hSong;
 	CSoundEffect	*SoundEffectArray;
 	
 	UINT			*ChannelSoundEffects;
 
+private:
+	static int		AudioThread(void *pSound);
+	void			CheckSoundEffectsLoaded(void);
+	void			LoadQueuedSoundEffect(const QUEUEDSOUNDEFFECT &SoundEffect);
+	void			PrefetchQueuedSong(const QUEUEDSONG &Song);
+	void			StartAudioThread(void);
+	void			StartSong(const QUEUEDSONG &Song);
+	void			StopAudioThread(void);
+	void			FreePrefetchedSongs(void);
+	SONGHANDLE		LoadSong(const WCHAR *pwszFilepath);
+	void			StepCrossfade(void);
+	SONGHANDLE		TakePrefetchedSong(const UINT eSongID);
+
+	//Everything below, the backend calls and the members above that the audio
+	//thread touches are guarded by pAudioLock.  File reads happen outside it.
+	SDL_Thread *	pAudioThread;
+	SDL_mutex *		pAudioLock;
+	SDL_cond *		pAudioWake;		//signaled when there is work for the thread
+	bool			bStopAudio;
+
+	list<QUEUEDSOUNDEFFECT>	SoundEffectQueue;
+	UINT			wSoundEffectsPending, wSoundEffectsFailed;
+	bool			bSoundEffectsLoading;
+
+	QUEUEDSONG		RequestedSong;
+	bool			bSongRequested;
+	UINT			eFailedSongID;
+	list<QUEUEDSONG>	SongPrefetchQueue;
+	list<PREFETCHEDSONG>	PrefetchedSongs;
+
+	int				nLyricInstrumentNo;	//of hSong, or -1 if notes aren't counted
+	SONGHANDLE		hFadingSong;	//song fading out under hSong
+	int				nFadingVolume;
+	DWORD			dwFadeStartTime;
+
 	PREVENT_DEFAULT_COPY(CSound);
 };
 
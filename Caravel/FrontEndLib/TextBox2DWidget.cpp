@@ -330,10 +330,17 @@ void CTextBox2DWidget::DrawText(
 //Params:
 	const int nOffsetX, const int nOffsetY)	//(in) Drawing offsets.
 {
-   g_pTheFM->DrawTextToRect(this->fontType,
-         this->pwczText + this->wTextDisplayIndex,
-         this->x + EDGE_OFFSET + nOffsetX, this->y + nOffsetY,
-         this->w - (nOffsetX + EDGE_OFFSET) * 2, this->h - nOffsetY * 2,
+   const WCHAR *pwczDisplayText = this->pwczText + this->wTextDisplayIndex;
+   const UINT wW = this->w - (nOffsetX + EDGE_OFFSET) * 2;
+   const UINT wH = this->h - nOffsetY * 2;
+   if (g_pTheFM->GetFontLineHeight(this->fontType) > wH || pwczDisplayText[0] == '\0')
+      return;  //Nothing to draw.
+
+   if (!this->drawLayout.IsFor(this->fontType, pwczDisplayText, wW, wH))
+      g_pTheFM->BuildTextLayout(this->fontType, pwczDisplayText, wW,
+            this->drawLayout, wH);
+   g_pTheFM->DrawTextLayout(this->drawLayout,
+         this->x + EDGE_OFFSET + nOffsetX, this->y + nOffsetY, wH,
          GetDestSurface());
 }
 
@@ -381,13 +388,24 @@ const
       bCursorOnWord = true;
    }
    //Get dimensions of text up to this spot.
-	WCSncpy(wStr, this->pwczText + this->wTextDisplayIndex,
-			 wCursorI - this->wTextDisplayIndex);
-   ASSERT(wCursorI - this->wTextDisplayIndex <= wLength);
-	WCv(wStr[wCursorI - this->wTextDisplayIndex]) = '\0';
+   //The layout of all displayed text gives this without laying out the text
+   //again on each call, unless the spot is inside a word.
+   const WCHAR *pwczDisplayText = this->pwczText + this->wTextDisplayIndex;
    const UINT wMaxWidth = this->w - 2 * EDGE_OFFSET;
-	wCursorX = g_pTheFM->GetTextRectHeight(this->fontType, wStr,
-         wMaxWidth, wTextW, wTextH);
+   ASSERT(wCursorI - this->wTextDisplayIndex <= wLength);
+   if (!this->cursorLayout.IsFor(this->fontType, pwczDisplayText, wMaxWidth))
+      g_pTheFM->BuildTextLayout(this->fontType, pwczDisplayText, wMaxWidth,
+            this->cursorLayout);
+   if (this->cursorLayout.GetPenPosition(wCursorI - this->wTextDisplayIndex,
+         wCursorX, wTextH))
+      wTextH += g_pTheFM->GetFontLineHeight(this->fontType);
+   else
+   {
+	   WCSncpy(wStr, pwczDisplayText, wCursorI - this->wTextDisplayIndex);
+	   WCv(wStr[wCursorI - this->wTextDisplayIndex]) = '\0';
+	   wCursorX = g_pTheFM->GetTextRectHeight(this->fontType, wStr,
+            wMaxWidth, wTextW, wTextH);
+   }
    const UINT wLineOfTextH = g_pTheFM->GetFontHeight(this->fontType);
    wCursorY = wTextH - wLineOfTextH;
    if (bCursorOnWord)
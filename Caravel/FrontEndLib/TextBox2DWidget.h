@@ -61,6 +61,9 @@ private:
    UINT           MoveViewUp(const UINT wNumLines = 1);
 
    UINT           wCursorX, wCursorY;   //cursor position
+
+   CTextLayout    drawLayout;             //kept between paints
+   mutable CTextLayout cursorLayout;      //for finding cursor positions
 };
 
 #endif //#ifndef TEXTBOX2DWIDGET_H
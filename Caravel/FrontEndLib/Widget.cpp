@@ -36,6 +36,7 @@ SDL_Surface *CWidget::pPartsSurface = NULL;
 UINT CWidget::wPartsSurfaceRefs = 0;
 
 static SDL_Surface *m_pScreenSurface = NULL;
+static const Uint32 *m_pdwAnimationClock = NULL;
 
 //***************************************************************************
 void SetWidgetScreenSurface(
@@ -60,6 +61,26 @@ SDL_Surface * GetWidgetScreenSurface()
 	return m_pScreenSurface;
 }
 
+//***************************************************************************
+void SetAnimationClock(
+//Makes effects and other animations run on the caller's clock instead of the
+//real one, i.e. to render frames faster or slower than real time.
+//
+//Params:
+	const Uint32 *pdwSetClock)	//(in)	Time in milliseconds, advanced by the caller.
+										//		NULL restores the real clock.
+{
+	m_pdwAnimationClock = pdwSetClock;
+}
+
+//***************************************************************************
+Uint32 GetAnimationTicks()
+//Returns the time that animations should be drawn for, in the same units as
+//SDL_GetTicks().
+{
+	return m_pdwAnimationClock ? *m_pdwAnimationClock : SDL_GetTicks();
+}
+
 //
 //CWidget protected methods.
 //
@@ -318,6 +339,7 @@ void CWidget::PaintChildren(
 	int nOffsetX, nOffsetY;
 	GetScrollOffset(nOffsetX, nOffsetY);
 
+	SDL_Rect ClipRect;
 	for (WIDGET_ITERATOR iSeek = this->Children.begin(); 
 			iSeek != this->Children.end(); ++iSeek)
 	{
@@ -328,6 +350,12 @@ void CWidget::PaintChildren(
 					this->w, this->h))
 				continue;
 
+			//A widget outside the clip rect, i.e. when only part of the screen
+			//is being repainted, wouldn't show.
+			SDL_GetClipRect((*iSeek)->GetDestSurface(), &ClipRect);
+			if (!(*iSeek)->OverlapsRect(ClipRect.x, ClipRect.y, ClipRect.w, ClipRect.h))
+				continue;
+
 			//Check for clipping.
 			if ((*iSeek)->IsInsideOfRect(this->x + nOffsetX, 
 					this->y + nOffsetY, this->w, this->h))
@@ -759,6 +787,11 @@ void CWidget::UpdateRect() const
       nW = CScreen::CX_SCREEN - nUpdateX;
 	if (nUpdateY + nH > CScreen::CY_SCREEN)
       nH = CScreen::CY_SCREEN - nUpdateY;
+   if (nW <= 0 || nH <= 0) return;
+
+   //Wait for the end of the frame if the event loop is running.
+   const SDL_Rect rect = {nUpdateX, nUpdateY, nW, nH};
+   if (CEventHandlerWidget::QueueUpdateRect(GetDestSurface(), rect)) return;
 
    SDL_UpdateRect(GetDestSurface(), nUpdateX, nUpdateY, nW, nH);
 }
@@ -381,6 +381,9 @@ typedef list<CWidget *>::const_iterator WIDGET_ITERATOR;
 void SetWidgetScreenSurface(SDL_Surface *pSetScreenSurface);
 SDL_Surface * GetWidgetScreenSurface();
 
+void SetAnimationClock(const Uint32 *pdwSetClock);
+Uint32 GetAnimationTicks();
+
 #endif //...#ifndef WIDGET_H
 
 // $Log: Widget.h,v $